@@ -1,5 +1,9 @@
 /// Core
+#include "nnlib/core/allocator.hpp"
 #include "nnlib/core/error.hpp"
+#include "nnlib/core/fixed_tensor.hpp"
+#include "nnlib/core/memory.hpp"
+#include "nnlib/core/sparse_tensor.hpp"
 #include "nnlib/core/storage.hpp"
 #include "nnlib/core/tensor.hpp"
 #include "nnlib/core/type.hpp"
@@ -7,13 +11,17 @@
 /// Critics
 #include "nnlib/critics/critic.hpp"
 #include "nnlib/critics/criticsequencer.hpp"
+#include "nnlib/critics/crossentropy.hpp"
 #include "nnlib/critics/nll.hpp"
 #include "nnlib/critics/mse.hpp"
 
 /// Math
 #include "nnlib/math/algebra.hpp"
+#include "nnlib/math/bitmask.hpp"
 #include "nnlib/math/math.hpp"
 #include "nnlib/math/random.hpp"
+#include "nnlib/math/reduce.hpp"
+#include "nnlib/math/vecmath.hpp"
 
 /// Neural Networks
 #include "nnlib/nn/batchnorm.hpp"
@@ -22,6 +30,7 @@
 #include "nnlib/nn/dropconnect.hpp"
 #include "nnlib/nn/dropout.hpp"
 #include "nnlib/nn/elu.hpp"
+#include "nnlib/nn/embedding.hpp"
 #include "nnlib/nn/identity.hpp"
 #include "nnlib/nn/linear.hpp"
 #include "nnlib/nn/logistic.hpp"
@@ -35,6 +44,7 @@
 #include "nnlib/nn/sequential.hpp"
 #include "nnlib/nn/sin.hpp"
 #include "nnlib/nn/softmax.hpp"
+#include "nnlib/nn/staticmap.hpp"
 #include "nnlib/nn/tanh.hpp"
 
 /// Optimization
@@ -57,5 +67,6 @@
 /// Utilities
 #include "nnlib/util/args.hpp"
 #include "nnlib/util/batcher.hpp"
+#include "nnlib/util/parallel.hpp"
 #include "nnlib/util/progress.hpp"
 #include "nnlib/util/timer.hpp"
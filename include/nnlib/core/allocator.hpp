@@ -0,0 +1,69 @@
+#ifndef CORE_ALLOCATOR_HPP
+#define CORE_ALLOCATOR_HPP
+
+#include "type.hpp"
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#ifndef NN_ALIGNMENT
+#define NN_ALIGNMENT 64ul
+#endif
+
+namespace nnlib
+{
+
+/// \brief Allocates uninitialized memory aligned to NN_ALIGNMENT bytes.
+///
+/// The default of 64 bytes suits the widest SIMD loads and keeps each buffer on its own cache lines.
+class AlignedAllocator
+{
+public:
+    static void *allocate(size_t bytes);
+    static void deallocate(void *ptr, size_t bytes);
+
+    /// The number of usable bytes in a block from allocate, which may exceed the number requested.
+    static size_t capacity(const void *ptr);
+};
+
+/// \brief The default allocator policy for Storage: an AlignedAllocator with an optional caching pool.
+///
+/// While the pool is disabled (the default), every call goes straight to AlignedAllocator. When enabled,
+/// requests are rounded up to a power of two and freed blocks are kept in a bucket for their size instead
+/// of being returned to the system, so buffers that are repeatedly resized (such as per-batch temporaries)
+/// are recycled rather than reallocated. Blocks allocated before the pool was enabled are cached as well.
+class PoolAllocator
+{
+public:
+    static void *allocate(size_t bytes);
+    static void deallocate(void *ptr, size_t bytes);
+
+    static void enable(bool enabled = true);
+    static bool enabled();
+
+    /// Bytes currently held by the pool.
+    static size_t cached();
+
+    /// Return every cached block to the system.
+    static void release();
+
+private:
+    struct Pool
+    {
+        std::mutex mutex;
+        std::vector<void *> buckets[sizeof(size_t) * 8];
+        size_t bytes = 0;
+        std::atomic<bool> enabled{ false }; ///< Read without the mutex, so a disabled pool never locks.
+    };
+
+    static Pool &pool();
+    static size_t bucket(size_t bytes, bool roundUp);
+};
+
+}
+
+#if !defined NN_REAL_T && !defined NN_IMPL
+    #include "detail/allocator.tpp"
+#endif
+
+#endif
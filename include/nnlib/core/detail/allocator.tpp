@@ -0,0 +1,137 @@
+#ifndef CORE_ALLOCATOR_TPP
+#define CORE_ALLOCATOR_TPP
+
+#include "../allocator.hpp"
+#include <cstdint>
+#include <new>
+
+namespace nnlib
+{
+
+namespace detail
+{
+    /// Stored immediately before each aligned block.
+    struct AlignedHeader
+    {
+        void *raw;
+        size_t bytes;
+    };
+}
+
+void *AlignedAllocator::allocate(size_t bytes)
+{
+    static_assert((NN_ALIGNMENT & (NN_ALIGNMENT - 1)) == 0, "NN_ALIGNMENT must be a power of two!");
+
+    void *raw = ::operator new(bytes + sizeof(detail::AlignedHeader) + NN_ALIGNMENT - 1);
+    uintptr_t address = reinterpret_cast<uintptr_t>(raw) + sizeof(detail::AlignedHeader);
+    address = (address + NN_ALIGNMENT - 1) & ~uintptr_t(NN_ALIGNMENT - 1);
+
+    detail::AlignedHeader *header = reinterpret_cast<detail::AlignedHeader *>(address) - 1;
+    header->raw = raw;
+    header->bytes = bytes;
+
+    return reinterpret_cast<void *>(address);
+}
+
+void AlignedAllocator::deallocate(void *ptr, size_t)
+{
+    if(ptr != nullptr)
+        ::operator delete((static_cast<detail::AlignedHeader *>(ptr) - 1)->raw);
+}
+
+size_t AlignedAllocator::capacity(const void *ptr)
+{
+    return (static_cast<const detail::AlignedHeader *>(ptr) - 1)->bytes;
+}
+
+void *PoolAllocator::allocate(size_t bytes)
+{
+    Pool &p = pool();
+    if(!p.enabled.load(std::memory_order_relaxed))
+        return AlignedAllocator::allocate(bytes);
+
+    std::unique_lock<std::mutex> lock(p.mutex);
+
+    // any block in bucket i holds at least 2^i bytes
+    size_t i = bucket(bytes, true);
+    if(!p.buckets[i].empty())
+    {
+        void *ptr = p.buckets[i].back();
+        p.buckets[i].pop_back();
+        p.bytes -= AlignedAllocator::capacity(ptr);
+        return ptr;
+    }
+
+    lock.unlock();
+    return AlignedAllocator::allocate(size_t(1) << i);
+}
+
+void PoolAllocator::deallocate(void *ptr, size_t bytes)
+{
+    if(ptr == nullptr)
+        return;
+
+    Pool &p = pool();
+    if(!p.enabled.load(std::memory_order_relaxed))
+    {
+        AlignedAllocator::deallocate(ptr, bytes);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(p.mutex);
+    size_t capacity = AlignedAllocator::capacity(ptr);
+    p.buckets[bucket(capacity, false)].push_back(ptr);
+    p.bytes += capacity;
+}
+
+void PoolAllocator::enable(bool enabled)
+{
+    // a block cached while another thread disables the pool stays cached until release()
+    pool().enabled.store(enabled);
+}
+
+bool PoolAllocator::enabled()
+{
+    return pool().enabled.load();
+}
+
+size_t PoolAllocator::cached()
+{
+    Pool &p = pool();
+    std::lock_guard<std::mutex> lock(p.mutex);
+    return p.bytes;
+}
+
+void PoolAllocator::release()
+{
+    Pool &p = pool();
+    std::lock_guard<std::mutex> lock(p.mutex);
+    for(std::vector<void *> &list : p.buckets)
+    {
+        for(void *ptr : list)
+            AlignedAllocator::deallocate(ptr, 0);
+        list.clear();
+    }
+    p.bytes = 0;
+}
+
+PoolAllocator::Pool &PoolAllocator::pool()
+{
+    // never destroyed, so storage with static duration can still free into it at exit
+    static Pool *p = new Pool();
+    return *p;
+}
+
+size_t PoolAllocator::bucket(size_t bytes, bool roundUp)
+{
+    size_t i = 0;
+    while((size_t(2) << i) <= bytes && i + 1 < sizeof(size_t) * 8)
+        ++i;
+    if(roundUp && (size_t(1) << i) < bytes)
+        ++i;
+    return i;
+}
+
+}
+
+#endif
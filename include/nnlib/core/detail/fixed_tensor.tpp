@@ -0,0 +1,193 @@
+#ifndef CORE_FIXED_TENSOR_TPP
+#define CORE_FIXED_TENSOR_TPP
+
+#include "../fixed_tensor.hpp"
+#include "../error.hpp"
+
+namespace nnlib
+{
+
+namespace detail
+{
+    constexpr size_t fixedOffset(const size_t *)
+    {
+        return 0;
+    }
+
+    /// The offset of an element from the strides of a fixed tensor, unrolled at compile time.
+    template <typename ... Ts>
+    constexpr size_t fixedOffset(const size_t *strides, size_t index, Ts... indices)
+    {
+        return index * strides[0] + fixedOffset(strides + 1, indices...);
+    }
+
+    constexpr bool fixedInBounds(const size_t *)
+    {
+        return true;
+    }
+
+    template <typename ... Ts>
+    constexpr bool fixedInBounds(const size_t *dims, size_t index, Ts... indices)
+    {
+        return index < dims[0] && fixedInBounds(dims + 1, indices...);
+    }
+
+    template <typename T, size_t R>
+    struct StaticRank<FixedTensor<T, R>>
+    {
+        static constexpr size_t value = R;
+    };
+}
+
+template <typename T, size_t R>
+FixedTensor<T, R>::FixedTensor() :
+    m_shared(new Storage<T>()),
+    m_ptr(m_shared->ptr())
+{
+    for(size_t i = 0; i < R; ++i)
+        m_dims[i] = 0;
+    resetStrides();
+}
+
+template <typename T, size_t R>
+template <typename ... Ts>
+FixedTensor<T, R>::FixedTensor(size_t dim1, Ts... dims) :
+    m_dims{ dim1, static_cast<size_t>(dims)... }
+{
+    static_assert(sizeof...(Ts) + 1 == R, "Incorrect number of dimensions!");
+    resetStrides();
+    m_shared.reset(new Storage<T>(m_size));
+    m_ptr = m_shared->ptr();
+}
+
+template <typename T, size_t R>
+FixedTensor<T, R>::FixedTensor(const Tensor<T> &other) :
+    m_shared(other.m_shared),
+    m_ptr(other.m_data->ptr() + other.m_offset),
+    m_size(other.m_size),
+    m_contiguous(other.m_contiguous)
+{
+    NNAssertEquals(other.m_dims.size(), R, "Incompatible number of dimensions!");
+    for(size_t i = 0; i < R; ++i)
+    {
+        m_dims[i] = other.m_dims[i];
+        m_strides[i] = other.m_strides[i];
+    }
+}
+
+template <typename T, size_t R>
+FixedTensor<T, R>::operator Tensor<T>() const
+{
+    Tensor<T> t;
+    t.m_dims.resize(R);
+    t.m_strides.resize(R);
+    for(size_t i = 0; i < R; ++i)
+    {
+        t.m_dims[i] = m_dims[i];
+        t.m_strides[i] = m_strides[i];
+    }
+    t.m_shared = m_shared;
+    t.m_data = m_shared.get();
+    t.m_offset = m_ptr - m_shared->ptr();
+    t.m_size = m_size;
+    t.m_contiguous = m_contiguous;
+    return t;
+}
+
+template <typename T, size_t R>
+const size_t *FixedTensor<T, R>::shape() const
+{
+    return m_dims;
+}
+
+template <typename T, size_t R>
+const size_t *FixedTensor<T, R>::strides() const
+{
+    return m_strides;
+}
+
+template <typename T, size_t R>
+size_t FixedTensor<T, R>::size() const
+{
+    return m_size;
+}
+
+template <typename T, size_t R>
+size_t FixedTensor<T, R>::size(size_t dim) const
+{
+    NNAssertLessThan(dim, R, "Invalid dimension!");
+    return m_dims[dim];
+}
+
+template <typename T, size_t R>
+size_t FixedTensor<T, R>::stride(size_t dim) const
+{
+    NNAssertLessThan(dim, R, "Invalid dimension!");
+    return m_strides[dim];
+}
+
+template <typename T, size_t R>
+bool FixedTensor<T, R>::contiguous() const
+{
+    return m_contiguous;
+}
+
+template <typename T, size_t R>
+template <typename ... Ts>
+T &FixedTensor<T, R>::at(Ts... indices)
+{
+    static_assert(sizeof...(Ts) == R, "Incorrect number of indices!");
+    NNAssert(detail::fixedInBounds(m_dims, indices...), "Index out of bounds!");
+    return m_ptr[detail::fixedOffset(m_strides, indices...)];
+}
+
+template <typename T, size_t R>
+template <typename ... Ts>
+const T &FixedTensor<T, R>::at(Ts... indices) const
+{
+    static_assert(sizeof...(Ts) == R, "Incorrect number of indices!");
+    NNAssert(detail::fixedInBounds(m_dims, indices...), "Index out of bounds!");
+    return m_ptr[detail::fixedOffset(m_strides, indices...)];
+}
+
+template <typename T, size_t R>
+template <typename ... Ts>
+T &FixedTensor<T, R>::operator()(Ts... indices)
+{
+    return at(indices...);
+}
+
+template <typename T, size_t R>
+template <typename ... Ts>
+const T &FixedTensor<T, R>::operator()(Ts... indices) const
+{
+    return at(indices...);
+}
+
+template <typename T, size_t R>
+T *FixedTensor<T, R>::ptr()
+{
+    return m_ptr;
+}
+
+template <typename T, size_t R>
+const T *FixedTensor<T, R>::ptr() const
+{
+    return m_ptr;
+}
+
+template <typename T, size_t R>
+void FixedTensor<T, R>::resetStrides()
+{
+    m_size = 1;
+    for(size_t i = R; i > 0; --i)
+    {
+        m_strides[i - 1] = m_size;
+        m_size *= m_dims[i - 1];
+    }
+    m_contiguous = true;
+}
+
+}
+
+#endif
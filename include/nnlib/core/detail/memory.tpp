@@ -0,0 +1,112 @@
+#ifndef CORE_MEMORY_TPP
+#define CORE_MEMORY_TPP
+
+#include "../memory.hpp"
+#include <algorithm>
+
+namespace nnlib
+{
+
+MemoryTracker::Scope::Scope(const void *tag) :
+    m_previous(current())
+{
+    current() = tag;
+}
+
+MemoryTracker::Scope::~Scope()
+{
+    current() = m_previous;
+}
+
+void MemoryTracker::enable(bool enabled)
+{
+    std::lock_guard<std::mutex> lock(mutex());
+    flag() = enabled;
+}
+
+bool MemoryTracker::enabled()
+{
+    return flag();
+}
+
+void MemoryTracker::reset()
+{
+    std::lock_guard<std::mutex> lock(mutex());
+    totals() = MemoryStats();
+    tags().clear();
+}
+
+MemoryStats MemoryTracker::total()
+{
+    std::lock_guard<std::mutex> lock(mutex());
+    return totals();
+}
+
+MemoryStats MemoryTracker::stats(const void *tag)
+{
+    std::lock_guard<std::mutex> lock(mutex());
+    auto i = tags().find(tag);
+    return i != tags().end() ? i->second : MemoryStats();
+}
+
+const void *MemoryTracker::currentTag()
+{
+    return current();
+}
+
+void MemoryTracker::allocated(const void *tag, size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex());
+    for(MemoryStats *stats : { &totals(), &tags()[tag] })
+    {
+        ++stats->allocations;
+        stats->bytes += bytes;
+        stats->resident += bytes;
+        stats->peak = std::max(stats->peak, stats->resident);
+    }
+}
+
+void MemoryTracker::freed(const void *tag, size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex());
+    for(MemoryStats *stats : { &totals(), &tags()[tag] })
+    {
+        // buffers allocated before the last reset were forgotten
+        ++stats->frees;
+        stats->resident -= std::min(stats->resident, bytes);
+    }
+}
+
+std::atomic<bool> &MemoryTracker::flag()
+{
+    static std::atomic<bool> enabled(false);
+    return enabled;
+}
+
+const void *&MemoryTracker::current()
+{
+    static thread_local const void *tag = nullptr;
+    return tag;
+}
+
+std::mutex &MemoryTracker::mutex()
+{
+    static std::mutex m;
+    return m;
+}
+
+MemoryStats &MemoryTracker::totals()
+{
+    static MemoryStats stats;
+    return stats;
+}
+
+std::unordered_map<const void *, MemoryStats> &MemoryTracker::tags()
+{
+    static std::unordered_map<const void *, MemoryStats> map;
+    return map;
+}
+
+}
+
+#endif
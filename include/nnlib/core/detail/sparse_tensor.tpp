@@ -0,0 +1,168 @@
+#ifndef CORE_SPARSE_TENSOR_TPP
+#define CORE_SPARSE_TENSOR_TPP
+
+#include "../sparse_tensor.hpp"
+#include "../error.hpp"
+
+namespace nnlib
+{
+
+template <typename T>
+SparseTensor<T>::SparseTensor(size_t rows, size_t cols) :
+    m_shape({ rows, cols }),
+    m_offsets(rows + 1, 0)
+{}
+
+template <typename T>
+SparseTensor<T>::SparseTensor(const Tensor<T> &dense) :
+    m_shape({ 0, 0 })
+{
+    NNAssertEquals(dense.dims(), 2, "Expected a matrix!");
+    resize(0, dense.size(1));
+    for(size_t i = 0, rows = dense.size(0), cols = dense.size(1); i < rows; ++i)
+    {
+        appendRow();
+        for(size_t j = 0; j < cols; ++j)
+            if(dense(i, j) != 0)
+                append(j, dense(i, j));
+    }
+}
+
+template <typename T>
+SparseTensor<T>::SparseTensor(size_t cols, const Storage<size_t> &offsets, const Storage<size_t> &indices, const Storage<T> &values) :
+    m_shape({ offsets.size() - 1, cols }),
+    m_offsets(offsets),
+    m_indices(indices),
+    m_values(values)
+{
+    NNHardAssertGreaterThan(offsets.size(), 0, "Expected at least one row offset!");
+    NNHardAssertEquals(offsets[0], 0, "Expected the first row to start at 0!");
+    NNHardAssertEquals(offsets[offsets.size() - 1], indices.size(), "Incompatible offsets and indices!");
+    NNHardAssertEquals(indices.size(), values.size(), "Incompatible indices and values!");
+    for(size_t i = 1; i < offsets.size(); ++i)
+        NNHardAssertLessThanOrEquals(offsets[i - 1], offsets[i], "Expected nondecreasing row offsets!");
+    for(size_t index : indices)
+        NNHardAssertLessThan(index, cols, "Column index out of bounds!");
+}
+
+template <typename T>
+SparseTensor<T> &SparseTensor<T>::resize(size_t rows, size_t cols)
+{
+    m_shape[0] = rows;
+    m_shape[1] = cols;
+    m_offsets.resize(rows + 1);
+    for(size_t &offset : m_offsets)
+        offset = 0;
+    m_indices.clear();
+    m_values.clear();
+    return *this;
+}
+
+template <typename T>
+SparseTensor<T> &SparseTensor<T>::appendRow()
+{
+    m_offsets.push(m_values.size());
+    ++m_shape[0];
+    return *this;
+}
+
+template <typename T>
+SparseTensor<T> &SparseTensor<T>::appendRow(const SparseTensor<T> &other, size_t row)
+{
+    NNAssertEquals(other.m_shape[1], m_shape[1], "Incompatible sparse tensors!");
+    NNAssertLessThan(row, other.m_shape[0], "Row index out of bounds!");
+    appendRow();
+    for(size_t k = other.m_offsets[row], end = other.m_offsets[row + 1]; k < end; ++k)
+    {
+        m_indices.push(other.m_indices[k]);
+        m_values.push(other.m_values[k]);
+    }
+    m_offsets.back() = m_values.size();
+    return *this;
+}
+
+template <typename T>
+SparseTensor<T> &SparseTensor<T>::append(size_t col, T value)
+{
+    NNAssertGreaterThan(m_shape[0], 0, "Cannot append to a matrix with no rows!");
+    NNAssertLessThan(col, m_shape[1], "Column index out of bounds!");
+    m_indices.push(col);
+    m_values.push(value);
+    ++m_offsets.back();
+    return *this;
+}
+
+template <typename T>
+SparseTensor<T> &SparseTensor<T>::reserve(size_t rows, size_t nonzeros)
+{
+    m_offsets.reserve(rows + 1);
+    m_indices.reserve(nonzeros);
+    m_values.reserve(nonzeros);
+    return *this;
+}
+
+template <typename T>
+const Storage<size_t> &SparseTensor<T>::shape() const
+{
+    return m_shape;
+}
+
+template <typename T>
+size_t SparseTensor<T>::dims() const
+{
+    return 2;
+}
+
+template <typename T>
+size_t SparseTensor<T>::size(size_t dim) const
+{
+    NNAssertLessThan(dim, 2, "Invalid dimension!");
+    return m_shape[dim];
+}
+
+template <typename T>
+size_t SparseTensor<T>::nonzeros() const
+{
+    return m_values.size();
+}
+
+template <typename T>
+const Storage<size_t> &SparseTensor<T>::offsets() const
+{
+    return m_offsets;
+}
+
+template <typename T>
+const Storage<size_t> &SparseTensor<T>::indices() const
+{
+    return m_indices;
+}
+
+template <typename T>
+Storage<T> &SparseTensor<T>::values()
+{
+    return m_values;
+}
+
+template <typename T>
+const Storage<T> &SparseTensor<T>::values() const
+{
+    return m_values;
+}
+
+template <typename T>
+Tensor<T> SparseTensor<T>::dense() const
+{
+    Tensor<T> t(m_shape, true);
+    T *ptr = t.ptr();
+    for(size_t i = 0, n = t.size(); i < n; ++i)
+        ptr[i] = 0;
+    for(size_t i = 0, rows = m_shape[0], cols = m_shape[1]; i < rows; ++i)
+        for(size_t k = m_offsets[i], end = m_offsets[i + 1]; k < end; ++k)
+            ptr[i * cols + m_indices[k]] += m_values[k];
+    return t;
+}
+
+}
+
+#endif
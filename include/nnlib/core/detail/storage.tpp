@@ -3,13 +3,23 @@
 
 #include "../storage.hpp"
 #include "nnlib/serialization/serialized.hpp"
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+#ifdef NN_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace nnlib
 {
 
-template <typename T>
-Storage<T>::Storage(size_t n, const T &defaultValue) :
-    m_ptr(new T[n]),
+template <typename T, typename A>
+Storage<T, A>::Storage(size_t n, const T &defaultValue) :
+    m_ptr(allocate(n)),
     m_size(n),
     m_capacity(n)
 {
@@ -17,34 +27,38 @@ Storage<T>::Storage(size_t n, const T &defaultValue) :
         m_ptr[i] = defaultValue;
 }
 
-template <typename T>
-Storage<T>::Storage(const Storage<T> &copy) :
-    m_ptr(new T[copy.size()]),
+template <typename T, typename A>
+Storage<T, A>::Storage(const Storage<T, A> &copy) :
+    m_ptr(allocate(copy.size())),
     m_size(copy.size()),
     m_capacity(copy.size())
 {
-    size_t index = 0;
-    for(const T &value : copy)
-    {
-        m_ptr[index] = value;
-        ++index;
-    }
+    assign(m_ptr, copy.m_ptr, m_size);
 }
 
-template <typename T>
-Storage<T>::Storage(Storage<T> &&rhs) :
+template <typename T, typename A>
+Storage<T, A>::Storage(Storage<T, A> &&rhs) :
+    m_tag(rhs.m_tag),
+    m_tracked(rhs.m_tracked),
+    m_external(rhs.m_external),
+    m_writable(rhs.m_writable),
+    m_deleter(std::move(rhs.m_deleter)),
     m_ptr(rhs.m_ptr),
     m_size(rhs.m_size),
     m_capacity(rhs.m_capacity)
 {
+    rhs.m_tracked = false;
+    rhs.m_external = false;
+    rhs.m_writable = true;
+    rhs.m_deleter = nullptr;
     rhs.m_ptr = nullptr;
     rhs.m_size = 0;
     rhs.m_capacity = 0;
 }
 
-template <typename T>
-Storage<T>::Storage(const std::initializer_list<T> &values) :
-    m_ptr(new T[values.size()]),
+template <typename T, typename A>
+Storage<T, A>::Storage(const std::initializer_list<T> &values) :
+    m_ptr(allocate(values.size())),
     m_size(values.size()),
     m_capacity(values.size())
 {
@@ -56,39 +70,34 @@ Storage<T>::Storage(const std::initializer_list<T> &values) :
     }
 }
 
-template <typename T>
-Storage<T>::Storage(const Serialized &node) :
-    m_ptr(new T[node.size()]),
+template <typename T, typename A>
+Storage<T, A>::Storage(const Serialized &node) :
+    m_ptr(allocate(node.size())),
     m_size(node.size()),
     m_capacity(node.size())
 {
     node.get(begin(), end());
 }
 
-template <typename T>
-Storage<T>::~Storage()
+template <typename T, typename A>
+Storage<T, A>::~Storage()
 {
-    delete[] m_ptr;
+    release();
 }
 
-template <typename T>
-Storage<T> &Storage<T>::operator=(const Storage<T> &copy)
+template <typename T, typename A>
+Storage<T, A> &Storage<T, A>::operator=(const Storage<T, A> &copy)
 {
     if(this != &copy)
     {
         resize(copy.size());
-        size_t index = 0;
-        for(const T &value : copy)
-        {
-            m_ptr[index] = value;
-            ++index;
-        }
+        assign(m_ptr, copy.m_ptr, m_size);
     }
     return *this;
 }
 
-template <typename T>
-Storage<T> &Storage<T>::operator=(const std::initializer_list<T> &values)
+template <typename T, typename A>
+Storage<T, A> &Storage<T, A>::operator=(const std::initializer_list<T> &values)
 {
     resize(values.size());
     size_t index = 0;
@@ -100,8 +109,63 @@ Storage<T> &Storage<T>::operator=(const std::initializer_list<T> &values)
     return *this;
 }
 
-template <typename T>
-Storage<T> &Storage<T>::resize(size_t n, const T &defaultValue)
+#ifdef NN_MMAP
+template <typename T, typename A>
+Storage<T, A> Storage<T, A>::map(const std::string &filename, size_t offset, size_t n, bool copyOnWrite)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    NNHardAssertNotEquals(fd, -1, "Could not open " + filename + "!");
+
+    struct stat info;
+    size_t length = fstat(fd, &info) == 0 ? size_t(info.st_size) : 0;
+    bool fits = offset <= length && n <= (length - offset) / sizeof(T);
+    if(!fits || length == 0)
+        close(fd);
+    NNHardAssert(fits, filename + " is too small for the requested mapping!");
+    NNHardAssertGreaterThan(length, 0, "Cannot map the empty file " + filename + "!");
+
+    void *base = mmap(nullptr, length, copyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ, copyOnWrite ? MAP_PRIVATE : MAP_SHARED, fd, 0);
+    close(fd);
+    NNHardAssertNotEquals(base, MAP_FAILED, "Could not map " + filename + "!");
+
+    T *ptr = reinterpret_cast<T *>(static_cast<char *>(base) + offset);
+    Storage<T, A> storage = borrow(ptr, n, [base, length](T *)
+    {
+        munmap(base, length);
+    });
+    storage.m_writable = copyOnWrite;
+    return storage;
+}
+#endif
+
+template <typename T, typename A>
+Storage<T, A> Storage<T, A>::borrow(T *ptr, size_t n, const std::function<void(T *)> &deleter)
+{
+    Storage<T, A> storage;
+    storage.release();
+    storage.m_tracked = false;
+    storage.m_external = true;
+    storage.m_deleter = deleter;
+    storage.m_ptr = ptr;
+    storage.m_size = n;
+    storage.m_capacity = n;
+    return storage;
+}
+
+template <typename T, typename A>
+bool Storage<T, A>::external() const
+{
+    return m_external;
+}
+
+template <typename T, typename A>
+bool Storage<T, A>::writable() const
+{
+    return m_writable;
+}
+
+template <typename T, typename A>
+Storage<T, A> &Storage<T, A>::resize(size_t n, const T &defaultValue)
 {
     reserve(n);
     for(size_t i = m_size; i < n; ++i)
@@ -110,38 +174,39 @@ Storage<T> &Storage<T>::resize(size_t n, const T &defaultValue)
     return *this;
 }
 
-template <typename T>
-Storage<T> &Storage<T>::reserve(size_t n)
+template <typename T, typename A>
+Storage<T, A> &Storage<T, A>::reserve(size_t n)
 {
     if(n > m_capacity)
     {
-        T *ptr = new T[n];
-        for(size_t i = 0; i < m_size; ++i)
-            ptr[i] = m_ptr[i];
-        delete[] m_ptr;
-        m_ptr = ptr;
+        // the old buffer, whether allocated or external, is released when this goes out of scope
+        Storage<T, A> old(std::move(*this));
+
+        m_ptr = allocate(n);
+        m_size = old.m_size;
         m_capacity = n;
+        assign(m_ptr, old.m_ptr, m_size);
     }
     return *this;
 }
 
-template <typename T>
-Storage<T> &Storage<T>::push(const T &value)
+template <typename T, typename A>
+Storage<T, A> &Storage<T, A>::push(const T &value)
 {
     resize(m_size + 1);
     m_ptr[m_size - 1] = value;
     return *this;
 }
 
-template <typename T>
-Storage<T> &Storage<T>::pop()
+template <typename T, typename A>
+Storage<T, A> &Storage<T, A>::pop()
 {
     --m_size;
     return *this;
 }
 
-template <typename T>
-Storage<T> &Storage<T>::append(const Storage<T> &other)
+template <typename T, typename A>
+Storage<T, A> &Storage<T, A>::append(const Storage<T, A> &other)
 {
     reserve(m_size + other.m_size);
     for(const T &value : other)
@@ -149,8 +214,8 @@ Storage<T> &Storage<T>::append(const Storage<T> &other)
     return *this;
 }
 
-template <typename T>
-Storage<T> &Storage<T>::erase(size_t index)
+template <typename T, typename A>
+Storage<T, A> &Storage<T, A>::erase(size_t index)
 {
     NNAssertLessThan(index, m_size, "Attempted to erase an index that is out of bounds!");
     for(size_t i = index + 1; i < m_size; ++i)
@@ -159,33 +224,33 @@ Storage<T> &Storage<T>::erase(size_t index)
     return *this;
 }
 
-template <typename T>
-Storage<T> &Storage<T>::clear()
+template <typename T, typename A>
+Storage<T, A> &Storage<T, A>::clear()
 {
     m_size = 0;
     return *this;
 }
 
-template <typename T>
-T *Storage<T>::ptr()
+template <typename T, typename A>
+T *Storage<T, A>::ptr()
 {
     return m_ptr;
 }
 
-template <typename T>
-const T *Storage<T>::ptr() const
+template <typename T, typename A>
+const T *Storage<T, A>::ptr() const
 {
     return m_ptr;
 }
 
-template <typename T>
-size_t Storage<T>::size() const
+template <typename T, typename A>
+size_t Storage<T, A>::size() const
 {
     return m_size;
 }
 
-template <typename T>
-bool Storage<T>::operator==(const Storage<T> &other) const
+template <typename T, typename A>
+bool Storage<T, A>::operator==(const Storage<T, A> &other) const
 {
     if(this == &other)
         return true;
@@ -199,98 +264,156 @@ bool Storage<T>::operator==(const Storage<T> &other) const
     return true;
 }
 
-template <typename T>
-bool Storage<T>::operator!=(const Storage<T> &other) const
+template <typename T, typename A>
+bool Storage<T, A>::operator!=(const Storage<T, A> &other) const
 {
     return !(*this == other);
 }
 
-template <typename T>
-T &Storage<T>::at(size_t i)
+template <typename T, typename A>
+T &Storage<T, A>::at(size_t i)
 {
     NNAssertLessThan(i, m_size, "Attempted to access an index that is out of bounds!");
     return m_ptr[i];
 }
 
-template <typename T>
-const T &Storage<T>::at(size_t i) const
+template <typename T, typename A>
+const T &Storage<T, A>::at(size_t i) const
 {
     NNAssertLessThan(i, m_size, "Attempted to access an index that is out of bounds!");
     return m_ptr[i];
 }
 
-template <typename T>
-T &Storage<T>::operator[](size_t i)
+template <typename T, typename A>
+T &Storage<T, A>::operator[](size_t i)
 {
     NNAssertLessThan(i, m_size, "Attempted to access an index that is out of bounds!");
     return m_ptr[i];
 }
 
-template <typename T>
-const T &Storage<T>::operator[](size_t i) const
+template <typename T, typename A>
+const T &Storage<T, A>::operator[](size_t i) const
 {
     NNAssertLessThan(i, m_size, "Attempted to access an index that is out of bounds!");
     return m_ptr[i];
 }
 
-template <typename T>
-T &Storage<T>::front()
+template <typename T, typename A>
+T &Storage<T, A>::front()
 {
     NNAssertGreaterThan(m_size, 0, "Attempted to access an index that is out of bounds!");
     return *m_ptr;
 }
 
-template <typename T>
-const T &Storage<T>::front() const
+template <typename T, typename A>
+const T &Storage<T, A>::front() const
 {
     NNAssertGreaterThan(m_size, 0, "Attempted to access an index that is out of bounds!");
     return *m_ptr;
 }
 
-template <typename T>
-T &Storage<T>::back()
+template <typename T, typename A>
+T &Storage<T, A>::back()
 {
     NNAssertGreaterThan(m_size, 0, "Attempted to access an index that is out of bounds!");
     return m_ptr[m_size - 1];
 }
 
-template <typename T>
-const T &Storage<T>::back() const
+template <typename T, typename A>
+const T &Storage<T, A>::back() const
 {
     NNAssertGreaterThan(m_size, 0, "Attempted to access an index that is out of bounds!");
     return m_ptr[m_size - 1];
 }
 
-template <typename T>
-T *Storage<T>::begin()
+template <typename T, typename A>
+T *Storage<T, A>::begin()
 {
     return m_ptr;
 }
 
-template <typename T>
-const T *Storage<T>::begin() const
+template <typename T, typename A>
+const T *Storage<T, A>::begin() const
 {
     return m_ptr;
 }
 
-template <typename T>
-T *Storage<T>::end()
+template <typename T, typename A>
+T *Storage<T, A>::end()
 {
     return m_ptr + m_size;
 }
 
-template <typename T>
-const T *Storage<T>::end() const
+template <typename T, typename A>
+const T *Storage<T, A>::end() const
 {
     return m_ptr + m_size;
 }
 
-template <typename T>
-void Storage<T>::save(Serialized &node) const
+template <typename T, typename A>
+void Storage<T, A>::save(Serialized &node) const
 {
     node.set(begin(), end());
 }
 
+template <typename T, typename A>
+T *Storage<T, A>::allocate(size_t n)
+{
+    T *ptr = static_cast<T *>(A::allocate(n * sizeof(T)));
+    if(!std::is_trivially_default_constructible<T>::value)
+    {
+        for(size_t i = 0; i < n; ++i)
+            new (ptr + i) T;
+    }
+
+    m_tracked = MemoryTracker::enabled();
+    if(m_tracked)
+    {
+        m_tag = MemoryTracker::currentTag();
+        MemoryTracker::allocated(m_tag, n * sizeof(T));
+    }
+    return ptr;
+}
+
+template <typename T, typename A>
+void Storage<T, A>::release()
+{
+    if(!m_external)
+        deallocate(m_ptr, m_capacity, m_tag, m_tracked);
+    else if(m_deleter)
+        m_deleter(m_ptr);
+}
+
+template <typename T, typename A>
+void Storage<T, A>::deallocate(T *ptr, size_t n, const void *tag, bool tracked)
+{
+    if(tracked)
+        MemoryTracker::freed(tag, n * sizeof(T));
+
+    if(!std::is_trivially_destructible<T>::value)
+    {
+        for(size_t i = 0; i < n; ++i)
+            ptr[i].~T();
+    }
+
+    A::deallocate(ptr, n * sizeof(T));
+}
+
+template <typename T, typename A>
+void Storage<T, A>::assign(T *to, const T *from, size_t n)
+{
+    if(std::is_trivially_copyable<T>::value)
+    {
+        if(n > 0)
+            std::memcpy(to, from, n * sizeof(T));
+    }
+    else
+    {
+        for(size_t i = 0; i < n; ++i)
+            to[i] = from[i];
+    }
+}
+
 }
 
 #endif
@@ -2,6 +2,16 @@
 #define CORE_TENSOR_TPP
 
 #include "../tensor.hpp"
+#include "nnlib/util/parallel.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <type_traits>
+
+#ifndef NN_MAX_NUM_DIMENSIONS
+#define NN_MAX_NUM_DIMENSIONS 32ul
+#endif
 
 namespace nnlib
 {
@@ -71,6 +81,75 @@ Tensor<T> Tensor<T>::concatenate(const Storage<Tensor<T> *> &tensors, size_t dim
     return concatenated;
 }
 
+#ifdef NN_MMAP
+template <typename T>
+Tensor<T> Tensor<T>::map(const std::string &filename, bool copyOnWrite)
+{
+    std::ifstream fin(filename, std::ios::binary);
+    NNHardAssert(fin.good(), "Could not open " + filename + "!");
+
+    char magic[8];
+    uint32_t version, type;
+    uint64_t dims;
+    fin.read(magic, sizeof(magic));
+    fin.read(reinterpret_cast<char *>(&version), sizeof(version));
+    fin.read(reinterpret_cast<char *>(&type), sizeof(type));
+    fin.read(reinterpret_cast<char *>(&dims), sizeof(dims));
+    NNHardAssert(fin.good() && std::string(magic, sizeof(magic)) == "NNTENSOR", filename + " is not a tensor file!");
+    NNHardAssertEquals(version, 1, "Unsupported tensor file version!");
+    NNHardAssertEquals(type, fileType(), "Incompatible element type in " + filename + "!");
+
+    NNHardAssertLessThanOrEquals(dims, NN_MAX_NUM_DIMENSIONS, "Too many dimensions in " + filename + "!");
+
+    // a corrupt header must not wrap the element count around to something small enough to map
+    const size_t max = std::numeric_limits<size_t>::max();
+    Storage<size_t> shape(dims);
+    size_t n = 1;
+    for(size_t &dim : shape)
+    {
+        uint64_t value;
+        fin.read(reinterpret_cast<char *>(&value), sizeof(value));
+        NNHardAssert(value <= max && (value == 0 || n <= max / value), "Too many elements in " + filename + "!");
+        dim = value;
+        n *= dim;
+    }
+    NNHardAssert(fin.good(), filename + " is truncated!");
+
+    Tensor<T> t;
+    t.m_shared = std::make_shared<Storage<T>>(Storage<T>::map(filename, fileHeaderSize(dims), n, copyOnWrite));
+    t.m_data = t.m_shared.get();
+    t.resize(shape);
+    return t;
+}
+#endif
+
+template <typename T>
+Tensor<T> Tensor<T>::borrow(T *ptr, const Storage<size_t> &shape, const Storage<size_t> &strides, const std::function<void(T *)> &deleter)
+{
+    Tensor<T> t;
+    t.m_dims = shape;
+    if(strides.size() == 0)
+        t.resetStrides();
+    else
+    {
+        NNHardAssertEquals(strides.size(), shape.size(), "Incompatible shape and strides!");
+        t.m_strides = strides;
+        t.m_size = 1;
+        for(size_t dim : shape)
+            t.m_size *= dim;
+        t.checkContiguous();
+    }
+
+    // the buffer only has to reach the last element
+    size_t extent = t.m_size == 0 ? 0 : 1;
+    for(size_t i = 0, dims = shape.size(); i < dims && extent > 0; ++i)
+        extent += (shape[i] - 1) * t.m_strides[i];
+
+    t.m_shared = std::make_shared<Storage<T>>(Storage<T>::borrow(ptr, extent, deleter));
+    t.m_data = t.m_shared.get();
+    return t;
+}
+
 template <typename T>
 Tensor<T>::Tensor() :
     m_dims({ 0 }),
@@ -235,35 +314,7 @@ size_t Tensor<T>::sharedCount() const
 template <typename T>
 Tensor<T> &Tensor<T>::resize(const Storage<size_t> &dims)
 {
-    NNHardAssert(dims.size() > 0, "Cannot create a zero-dimensional tensor!");
-
-    if(dims == m_dims)
-        return *this;
-
-    // Calculate new strides and size.
-
-    Storage<size_t> strides(dims.size());
-    strides.back() = 1;
-    for(size_t i = strides.size() - 1; i > 0; --i)
-        strides[i - 1] = strides[i] * dims[i];
-
-    size_t size = strides[0] * dims[0];
-
-    // Resize underlying storage. If not unique and this is smaller or not contiguous, break shared connection.
-
-    if(shared() && (size > m_size || !m_contiguous))
-        *this = Tensor(*m_data).resize(dims);
-    else
-    {
-        if(!shared())
-            m_data->resize(m_offset + size);
-        m_dims = std::move(dims);
-        m_strides = std::move(strides);
-        m_size = size;
-        m_contiguous = true;
-    }
-
-    return *this;
+    return resizeTo(dims.ptr(), dims.size());
 }
 
 template <typename T>
@@ -272,10 +323,23 @@ Tensor<T> &Tensor<T>::resizeDim(size_t dim, size_t size)
     if(m_dims[dim] == size)
         return *this;
 
-    Storage<size_t> dims = m_dims;
-    dims[dim] = size;
+    size_t newSize = 1;
+    for(size_t i = 0, count = m_dims.size(); i < count; ++i)
+        newSize *= i == dim ? size : m_dims[i];
 
-    return resize(dims);
+    if(shared() && (newSize > m_size || !m_contiguous))
+    {
+        Storage<size_t> dims = m_dims;
+        dims[dim] = size;
+        return resize(dims);
+    }
+
+    if(!shared())
+        m_data->resize(m_offset + newSize);
+    m_dims[dim] = size;
+    resetStrides();
+
+    return *this;
 }
 
 template <typename T>
@@ -311,13 +375,7 @@ Tensor<T> Tensor<T>::reshape(const Storage<size_t> &dims) const
 {
     Tensor<T> t(dims, true);
     NNAssertEquals(t.size(), size(), "Incompatible dimensions for reshaping!");
-    auto k = t.begin();
-    forEach([&](const T &value)
-    {
-        *k = value;
-        ++k;
-    }, *this);
-    return t;
+    return t.copy(*this);
 }
 
 template <typename T>
@@ -378,6 +436,36 @@ const Tensor<T> Tensor<T>::expand(size_t dim, size_t size) const
     return const_cast<Tensor<T> *>(this)->expand(dim, size);
 }
 
+template <typename T>
+Tensor<T> Tensor<T>::broadcast(const Storage<size_t> &shape)
+{
+    NNAssertGreaterThanOrEquals(shape.size(), m_dims.size(), "Cannot broadcast to fewer dimensions!");
+    size_t missing = shape.size() - m_dims.size();
+
+    Tensor<T> t = *this;
+    t.m_dims = shape;
+    t.m_strides.resize(shape.size());
+    for(size_t i = 0; i < shape.size(); ++i)
+    {
+        if(i < missing || m_dims[i - missing] != shape[i])
+        {
+            NNAssert(i < missing || m_dims[i - missing] == 1, "Incompatible shape for broadcasting!");
+            t.m_strides[i] = 0;
+        }
+        else
+            t.m_strides[i] = m_strides[i - missing];
+    }
+    t.recalculateSize();
+    t.checkContiguous();
+    return t;
+}
+
+template <typename T>
+const Tensor<T> Tensor<T>::broadcast(const Storage<size_t> &shape) const
+{
+    return const_cast<Tensor<T> *>(this)->broadcast(shape);
+}
+
 template <typename T>
 Tensor<T> &Tensor<T>::sub(Tensor<T> &t, const std::initializer_list<const std::initializer_list<size_t>> &dims)
 {
@@ -432,15 +520,86 @@ Tensor<T> Tensor<T>::copy() const
 }
 
 template <typename T>
-Tensor<T> &Tensor<T>::copy(const Tensor<T> &other)
+Tensor<T> &Tensor<T>::copy(const Tensor<T> &other, size_t threads)
 {
     NNAssertEquals(size(), other.size(), "Incompatible tensor for copying!");
-    auto i = other.begin();
-    forEach([&](T &value)
+
+    // fewer elements than this per thread are not worth a thread
+    const size_t grain = 1 << 18;
+    if(threads == 0)
+        threads = hardwareThreads();
+    threads = std::max(std::min(threads, m_size / grain), size_t(1));
+
+    T *dst = ptr();
+    const T *src = other.ptr();
+
+    if(m_contiguous && other.m_contiguous)
     {
-        value = *i;
-        ++i;
-    }, *this);
+        parallelForUnseeded(m_size, threads, [&](size_t begin, size_t end, size_t)
+        {
+            std::copy(src + begin, src + end, dst + begin);
+        });
+    }
+    else if(m_dims.size() == 2 && other.m_dims.size() == 2 && m_dims[1] == other.m_dims[1])
+    {
+        size_t cols = m_dims[1];
+        size_t d0 = m_strides[0], d1 = m_strides[1];
+        size_t s0 = other.m_strides[0], s1 = other.m_strides[1];
+
+        if(d1 == 1 && s1 == 1)
+        {
+            // rows are contiguous in both, so each row is a single block copy
+            parallelForUnseeded(m_dims[0], threads, [&](size_t begin, size_t end, size_t)
+            {
+                for(size_t i = begin; i < end; ++i)
+                    std::copy(src + i * s0, src + i * s0 + cols, dst + i * d0);
+            });
+        }
+        else
+        {
+            // tiles keep both the strided reads and the strided writes in cache (e.g. for a transpose)
+            const size_t tile = 32;
+            parallelForUnseeded(m_dims[0], threads, [&](size_t begin, size_t end, size_t)
+            {
+                for(size_t ib = begin; ib < end; ib += tile)
+                {
+                    size_t iend = std::min(ib + tile, end);
+                    for(size_t jb = 0; jb < cols; jb += tile)
+                    {
+                        size_t jend = std::min(jb + tile, cols);
+                        for(size_t i = ib; i < iend; ++i)
+                            for(size_t j = jb; j < jend; ++j)
+                                dst[i * d0 + j * d1] = src[i * s0 + j * s1];
+                    }
+                }
+            });
+        }
+    }
+    else
+    {
+        // walk both tensors a run at a time; each step covers the shorter of the two current runs
+        auto i = begin(), iend = end();
+        auto j = other.begin();
+        while(i != iend)
+        {
+            size_t n = std::min(i.runLength(), j.runLength());
+            size_t si = i.runStride(), sj = j.runStride();
+            T *to = &*i;
+            const T *from = &*j;
+
+            if(si == 1 && sj == 1)
+                std::copy(from, from + n, to);
+            else
+            {
+                for(size_t k = 0; k < n; ++k)
+                    to[k * si] = from[k * sj];
+            }
+
+            i.advance(n);
+            j.advance(n);
+        }
+    }
+
     return *this;
 }
 
@@ -538,10 +697,13 @@ bool Tensor<T>::contiguous() const
 }
 
 template <typename T>
-Tensor<T> &Tensor<T>::makeContiguous()
+Tensor<T> &Tensor<T>::makeContiguous(size_t threads)
 {
     if(!m_contiguous)
-        *this = copy();
+    {
+        Tensor<T> t(m_dims, true);
+        *this = t.copy(*this, threads);
+    }
     return *this;
 }
 
@@ -630,6 +792,54 @@ void Tensor<T>::save(Serialized &node) const
     node.set("data", begin(), end());
 }
 
+template <typename T>
+void Tensor<T>::write(const std::string &filename) const
+{
+    std::ofstream fout(filename, std::ios::binary);
+    NNHardAssert(fout.good(), "Could not open " + filename + "!");
+
+    uint32_t version = 1, type = fileType();
+    uint64_t dims = m_dims.size();
+    fout.write("NNTENSOR", 8);
+    fout.write(reinterpret_cast<const char *>(&version), sizeof(version));
+    fout.write(reinterpret_cast<const char *>(&type), sizeof(type));
+    fout.write(reinterpret_cast<const char *>(&dims), sizeof(dims));
+    for(size_t dim : m_dims)
+    {
+        uint64_t value = dim;
+        fout.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    for(size_t i = 24 + 8 * m_dims.size(), end = fileHeaderSize(m_dims.size()); i < end; ++i)
+        fout.put(0);
+
+    if(begin().runStride() == 1)
+    {
+        // every run is contiguous, so runs can be written directly without gathering a copy
+        for(auto i = begin(), iend = end(); i != iend; i.nextRun())
+            fout.write(reinterpret_cast<const char *>(&*i), i.runLength() * sizeof(T));
+    }
+    else
+    {
+        const Tensor<T> data = copy();
+        fout.write(reinterpret_cast<const char *>(data.ptr()), data.size() * sizeof(T));
+    }
+    NNHardAssert(fout.good(), "Could not write " + filename + "!");
+}
+
+template <typename T>
+uint32_t Tensor<T>::fileType()
+{
+    uint32_t kind = std::is_floating_point<T>::value ? 2 : (std::is_signed<T>::value ? 1 : 0);
+    return kind << 8 | sizeof(T);
+}
+
+template <typename T>
+size_t Tensor<T>::fileHeaderSize(size_t dims)
+{
+    return (24 + 8 * dims + 63) / 64 * 64;
+}
+
 template <typename T>
 bool Tensor<T>::isVectorized(const Storage<Tensor<T> *> &tensors)
 {
@@ -667,6 +877,44 @@ size_t Tensor<T>::indexOf(const Storage<size_t> &indices) const
     return sum;
 }
 
+template <typename T>
+Tensor<T> &Tensor<T>::resizeTo(const size_t *dims, size_t count)
+{
+    NNHardAssert(count > 0, "Cannot create a zero-dimensional tensor!");
+
+    bool same = count == m_dims.size();
+    for(size_t i = 0; same && i < count; ++i)
+        same = dims[i] == m_dims[i];
+    if(same)
+        return *this;
+
+    size_t size = 1;
+    for(size_t i = 0; i < count; ++i)
+        size *= dims[i];
+
+    // Resize underlying storage. If not unique and this is smaller or not contiguous, break shared connection.
+    // Otherwise, the shape and strides are updated in place, reusing their buffers.
+
+    if(shared() && (size > m_size || !m_contiguous))
+    {
+        Storage<size_t> shape(count);
+        for(size_t i = 0; i < count; ++i)
+            shape[i] = dims[i];
+        *this = Tensor(*m_data).resize(shape);
+    }
+    else
+    {
+        if(!shared())
+            m_data->resize(m_offset + size);
+        m_dims.resize(count);
+        for(size_t i = 0; i < count; ++i)
+            m_dims[i] = dims[i];
+        resetStrides();
+    }
+
+    return *this;
+}
+
 template <typename T>
 void Tensor<T>::recalculateSize()
 {
@@ -675,6 +923,19 @@ void Tensor<T>::recalculateSize()
         m_size *= s;
 }
 
+template <typename T>
+void Tensor<T>::resetStrides()
+{
+    m_strides.resize(m_dims.size());
+    m_size = 1;
+    for(size_t i = m_dims.size(); i > 0; --i)
+    {
+        m_strides[i - 1] = m_size;
+        m_size *= m_dims[i - 1];
+    }
+    m_contiguous = true;
+}
+
 template <typename T>
 void Tensor<T>::checkContiguous()
 {
@@ -0,0 +1,236 @@
+#ifndef CORE_TENSOR_EXPRESSION_HPP
+#define CORE_TENSOR_EXPRESSION_HPP
+
+#include "../tensor.hpp"
+#include <type_traits>
+
+#ifndef NN_MAX_NUM_DIMENSIONS
+#define NN_MAX_NUM_DIMENSIONS 32ul
+#endif
+
+namespace nnlib
+{
+
+/// \brief A lazily evaluated, elementwise tensor expression.
+///
+/// Tensor arithmetic (+, - between tensors, * and / by scalars) builds a tree of expressions instead
+/// of computing intermediate tensors. The tree is evaluated in a single loop, element by element,
+/// when it is assigned to a tensor, used to construct one, added or subtracted in place, or reduced
+/// by a math function. Expressions refer to their tensor operands rather than copying them, so they
+/// should be evaluated within the statement that creates them instead of stored with auto.
+/// Assigning an expression to a tensor writes into that tensor's storage. An operand may be the
+/// destination itself; an operand that views the destination's storage with a different layout,
+/// such as the transpose in `c = c.transpose() + a`, is detected and evaluated into a temporary first.
+template <typename T, typename E>
+class TensorExpression
+{
+public:
+    using value_type = T;
+
+    /// The shape of the result.
+    const Storage<size_t> &shape() const;
+
+    /// The number of elements in the result.
+    size_t size() const;
+
+    /// Whether every tensor in the expression is contiguous, so elements can be found by flat index.
+    bool contiguous() const;
+
+    /// The element at flat index i; only valid if the expression is contiguous.
+    T operator[](size_t i) const;
+
+    /// The element at the given multidimensional index.
+    T at(const size_t *indices) const;
+
+    /// Call func with each element of the result, in row-major order.
+    template <typename F>
+    void forEach(F func) const;
+
+    /// Whether writing the result into dst could overwrite an element of an operand before it is read.
+    bool overlaps(const Tensor<T> &dst) const;
+
+    /// Whether any operand shares storage with dst, so that resizing dst could invalidate it.
+    bool sharedWith(const Tensor<T> &dst) const;
+
+    /// Evaluate into a new tensor.
+    Tensor<T> eval() const;
+
+private:
+    const E &derived() const;
+};
+
+/// A tensor operand of an expression.
+template <typename T>
+class TensorLeaf : public TensorExpression<T, TensorLeaf<T>>
+{
+public:
+    TensorLeaf(const Tensor<T> &tensor);
+
+    const Storage<size_t> &shape() const;
+    bool contiguous() const;
+    T operator[](size_t i) const;
+    T at(const size_t *indices) const;
+    bool overlaps(const Tensor<T> &dst) const;
+    bool sharedWith(const Tensor<T> &dst) const;
+
+private:
+    const Tensor<T> &m_tensor;
+    const T *m_ptr;
+};
+
+/// An elementwise operation on two expressions of the same shape.
+template <typename T, typename L, typename R, typename Op>
+class TensorBinary : public TensorExpression<T, TensorBinary<T, L, R, Op>>
+{
+public:
+    TensorBinary(const L &lhs, const R &rhs);
+
+    const Storage<size_t> &shape() const;
+    bool contiguous() const;
+    T operator[](size_t i) const;
+    T at(const size_t *indices) const;
+    bool overlaps(const Tensor<T> &dst) const;
+    bool sharedWith(const Tensor<T> &dst) const;
+
+private:
+    L m_lhs;
+    R m_rhs;
+};
+
+/// An elementwise operation between an expression and a scalar.
+template <typename T, typename E, typename Op>
+class TensorScalar : public TensorExpression<T, TensorScalar<T, E, Op>>
+{
+public:
+    TensorScalar(const E &expr, T scalar);
+
+    const Storage<size_t> &shape() const;
+    bool contiguous() const;
+    T operator[](size_t i) const;
+    T at(const size_t *indices) const;
+    bool overlaps(const Tensor<T> &dst) const;
+    bool sharedWith(const Tensor<T> &dst) const;
+
+private:
+    E m_expr;
+    T m_scalar;
+};
+
+namespace detail
+{
+    struct Plus
+    {
+        template <typename T>
+        static T apply(T a, T b) { return a + b; }
+    };
+
+    struct Minus
+    {
+        template <typename T>
+        static T apply(T a, T b) { return a - b; }
+    };
+
+    struct Multiplies
+    {
+        template <typename T>
+        static T apply(T a, T b) { return a * b; }
+    };
+
+    struct Divides
+    {
+        template <typename T>
+        static T apply(T a, T b) { return a / b; }
+    };
+
+    /// Maps an operand (a tensor or an expression) to the expression type that represents it.
+    template <typename X>
+    struct Operand
+    {};
+
+    template <typename T>
+    struct Operand<Tensor<T>>
+    {
+        using value_type = T;
+        using type = TensorLeaf<T>;
+    };
+
+    template <typename T>
+    struct Operand<TensorLeaf<T>>
+    {
+        using value_type = T;
+        using type = TensorLeaf<T>;
+    };
+
+    template <typename T, typename L, typename R, typename Op>
+    struct Operand<TensorBinary<T, L, R, Op>>
+    {
+        using value_type = T;
+        using type = TensorBinary<T, L, R, Op>;
+    };
+
+    template <typename T, typename E, typename Op>
+    struct Operand<TensorScalar<T, E, Op>>
+    {
+        using value_type = T;
+        using type = TensorScalar<T, E, Op>;
+    };
+
+    /// The expression type combining two operands with Op; undefined unless both are operands of the same type.
+    template <typename L, typename R, typename Op, typename = void>
+    struct BinaryOf
+    {};
+
+    template <typename L, typename R, typename Op>
+    struct BinaryOf<L, R, Op, typename std::enable_if<std::is_same<typename Operand<L>::value_type, typename Operand<R>::value_type>::value>::type>
+    {
+        using type = TensorBinary<typename Operand<L>::value_type, typename Operand<L>::type, typename Operand<R>::type, Op>;
+    };
+
+    /// The expression type combining an operand with a scalar using Op; undefined unless X is an operand.
+    template <typename X, typename Op, typename = void>
+    struct ScalarOf
+    {};
+
+    template <typename X, typename Op>
+    struct ScalarOf<X, Op, typename std::enable_if<std::is_class<typename Operand<X>::type>::value>::type>
+    {
+        using type = TensorScalar<typename Operand<X>::value_type, typename Operand<X>::type, Op>;
+    };
+
+    /// The address of the last element of a tensor with the given layout, or ptr itself if it is empty.
+    template <typename T>
+    const T *lastElement(const T *ptr, const Storage<size_t> &dims, const Storage<size_t> &strides);
+
+    /// \brief Apply func(element of dst, element of src) to every pair of elements, in one pass.
+    ///
+    /// If src overlaps dst, it is evaluated into a temporary first.
+    template <typename T, typename E, typename F>
+    void evaluate(Tensor<T> &dst, const TensorExpression<T, E> &src, F func);
+}
+
+}
+
+template <typename L, typename R>
+typename nnlib::detail::BinaryOf<L, R, nnlib::detail::Plus>::type operator+(const L &lhs, const R &rhs);
+
+template <typename L, typename R>
+typename nnlib::detail::BinaryOf<L, R, nnlib::detail::Minus>::type operator-(const L &lhs, const R &rhs);
+
+template <typename X>
+typename nnlib::detail::ScalarOf<X, nnlib::detail::Multiplies>::type operator*(const X &lhs, typename nnlib::detail::Operand<X>::value_type rhs);
+
+template <typename X>
+typename nnlib::detail::ScalarOf<X, nnlib::detail::Multiplies>::type operator*(typename nnlib::detail::Operand<X>::value_type lhs, const X &rhs);
+
+template <typename X>
+typename nnlib::detail::ScalarOf<X, nnlib::detail::Divides>::type operator/(const X &lhs, typename nnlib::detail::Operand<X>::value_type rhs);
+
+template <typename T, typename E>
+nnlib::Tensor<T> &operator+=(nnlib::Tensor<T> &lhs, const nnlib::TensorExpression<T, E> &rhs);
+
+template <typename T, typename E>
+nnlib::Tensor<T> &operator-=(nnlib::Tensor<T> &lhs, const nnlib::TensorExpression<T, E> &rhs);
+
+#include "tensor_expression.tpp"
+
+#endif
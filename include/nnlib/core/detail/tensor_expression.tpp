@@ -0,0 +1,380 @@
+#ifndef CORE_TENSOR_EXPRESSION_TPP
+#define CORE_TENSOR_EXPRESSION_TPP
+
+#include "tensor_expression.hpp"
+
+namespace nnlib
+{
+
+// MARK: TensorExpression
+
+template <typename T, typename E>
+const Storage<size_t> &TensorExpression<T, E>::shape() const
+{
+    return derived().shape();
+}
+
+template <typename T, typename E>
+size_t TensorExpression<T, E>::size() const
+{
+    size_t n = 1;
+    for(size_t dim : shape())
+        n *= dim;
+    return n;
+}
+
+template <typename T, typename E>
+bool TensorExpression<T, E>::contiguous() const
+{
+    return derived().contiguous();
+}
+
+template <typename T, typename E>
+T TensorExpression<T, E>::operator[](size_t i) const
+{
+    return derived()[i];
+}
+
+template <typename T, typename E>
+T TensorExpression<T, E>::at(const size_t *indices) const
+{
+    return derived().at(indices);
+}
+
+template <typename T, typename E>
+template <typename F>
+void TensorExpression<T, E>::forEach(F func) const
+{
+    const E &expr = derived();
+    size_t n = size();
+
+    if(expr.contiguous())
+    {
+        for(size_t i = 0; i < n; ++i)
+            func(expr[i]);
+        return;
+    }
+
+    const Storage<size_t> &dims = shape();
+    NNHardAssertLessThanOrEquals(dims.size(), NN_MAX_NUM_DIMENSIONS, "Too many dimensions! Define NN_MAX_NUM_DIMENSIONS to increase this limit.");
+
+    size_t indices[NN_MAX_NUM_DIMENSIONS] = { 0 };
+    for(; n > 0; --n)
+    {
+        func(expr.at(indices));
+        for(size_t d = dims.size(); d > 0 && ++indices[d - 1] == dims[d - 1]; --d)
+            indices[d - 1] = 0;
+    }
+}
+
+template <typename T, typename E>
+bool TensorExpression<T, E>::overlaps(const Tensor<T> &dst) const
+{
+    return derived().overlaps(dst);
+}
+
+template <typename T, typename E>
+bool TensorExpression<T, E>::sharedWith(const Tensor<T> &dst) const
+{
+    return derived().sharedWith(dst);
+}
+
+template <typename T, typename E>
+Tensor<T> TensorExpression<T, E>::eval() const
+{
+    return Tensor<T>(*this);
+}
+
+template <typename T, typename E>
+const E &TensorExpression<T, E>::derived() const
+{
+    return static_cast<const E &>(*this);
+}
+
+// MARK: TensorLeaf
+
+template <typename T>
+TensorLeaf<T>::TensorLeaf(const Tensor<T> &tensor) :
+    m_tensor(tensor),
+    m_ptr(tensor.ptr())
+{}
+
+template <typename T>
+const Storage<size_t> &TensorLeaf<T>::shape() const
+{
+    return m_tensor.shape();
+}
+
+template <typename T>
+bool TensorLeaf<T>::contiguous() const
+{
+    return m_tensor.contiguous();
+}
+
+template <typename T>
+T TensorLeaf<T>::operator[](size_t i) const
+{
+    return m_ptr[i];
+}
+
+template <typename T>
+T TensorLeaf<T>::at(const size_t *indices) const
+{
+    const Storage<size_t> &strides = m_tensor.strides();
+    size_t offset = 0;
+    for(size_t d = 0, dims = strides.size(); d < dims; ++d)
+        offset += indices[d] * strides[d];
+    return m_ptr[offset];
+}
+
+template <typename T>
+bool TensorLeaf<T>::overlaps(const Tensor<T> &dst) const
+{
+    // reading each element just before it is overwritten is safe, so only other layouts conflict
+    if(!m_tensor.sharedWith(dst) || m_tensor.size() == 0 || dst.size() == 0)
+        return false;
+    if(m_ptr == dst.ptr() && m_tensor.shape() == dst.shape() && m_tensor.strides() == dst.strides())
+        return false;
+
+    const T *last = detail::lastElement(m_ptr, m_tensor.shape(), m_tensor.strides());
+    const T *dstLast = detail::lastElement(dst.ptr(), dst.shape(), dst.strides());
+    return m_ptr <= dstLast && dst.ptr() <= last;
+}
+
+template <typename T>
+bool TensorLeaf<T>::sharedWith(const Tensor<T> &dst) const
+{
+    return m_tensor.sharedWith(dst);
+}
+
+// MARK: TensorBinary
+
+template <typename T, typename L, typename R, typename Op>
+TensorBinary<T, L, R, Op>::TensorBinary(const L &lhs, const R &rhs) :
+    m_lhs(lhs),
+    m_rhs(rhs)
+{
+    NNAssertEquals(m_lhs.shape(), m_rhs.shape(), "Incompatible operands!");
+}
+
+template <typename T, typename L, typename R, typename Op>
+const Storage<size_t> &TensorBinary<T, L, R, Op>::shape() const
+{
+    return m_lhs.shape();
+}
+
+template <typename T, typename L, typename R, typename Op>
+bool TensorBinary<T, L, R, Op>::contiguous() const
+{
+    return m_lhs.contiguous() && m_rhs.contiguous();
+}
+
+template <typename T, typename L, typename R, typename Op>
+T TensorBinary<T, L, R, Op>::operator[](size_t i) const
+{
+    return Op::apply(m_lhs[i], m_rhs[i]);
+}
+
+template <typename T, typename L, typename R, typename Op>
+T TensorBinary<T, L, R, Op>::at(const size_t *indices) const
+{
+    return Op::apply(m_lhs.at(indices), m_rhs.at(indices));
+}
+
+template <typename T, typename L, typename R, typename Op>
+bool TensorBinary<T, L, R, Op>::overlaps(const Tensor<T> &dst) const
+{
+    return m_lhs.overlaps(dst) || m_rhs.overlaps(dst);
+}
+
+template <typename T, typename L, typename R, typename Op>
+bool TensorBinary<T, L, R, Op>::sharedWith(const Tensor<T> &dst) const
+{
+    return m_lhs.sharedWith(dst) || m_rhs.sharedWith(dst);
+}
+
+// MARK: TensorScalar
+
+template <typename T, typename E, typename Op>
+TensorScalar<T, E, Op>::TensorScalar(const E &expr, T scalar) :
+    m_expr(expr),
+    m_scalar(scalar)
+{}
+
+template <typename T, typename E, typename Op>
+const Storage<size_t> &TensorScalar<T, E, Op>::shape() const
+{
+    return m_expr.shape();
+}
+
+template <typename T, typename E, typename Op>
+bool TensorScalar<T, E, Op>::contiguous() const
+{
+    return m_expr.contiguous();
+}
+
+template <typename T, typename E, typename Op>
+T TensorScalar<T, E, Op>::operator[](size_t i) const
+{
+    return Op::apply(m_expr[i], m_scalar);
+}
+
+template <typename T, typename E, typename Op>
+T TensorScalar<T, E, Op>::at(const size_t *indices) const
+{
+    return Op::apply(m_expr.at(indices), m_scalar);
+}
+
+template <typename T, typename E, typename Op>
+bool TensorScalar<T, E, Op>::overlaps(const Tensor<T> &dst) const
+{
+    return m_expr.overlaps(dst);
+}
+
+template <typename T, typename E, typename Op>
+bool TensorScalar<T, E, Op>::sharedWith(const Tensor<T> &dst) const
+{
+    return m_expr.sharedWith(dst);
+}
+
+// MARK: Evaluation
+
+template <typename T>
+const T *detail::lastElement(const T *ptr, const Storage<size_t> &dims, const Storage<size_t> &strides)
+{
+    for(size_t d = 0, count = dims.size(); d < count; ++d)
+    {
+        if(dims[d] == 0)
+            return ptr;
+        ptr += (dims[d] - 1) * strides[d];
+    }
+    return ptr;
+}
+
+template <typename T, typename E, typename F>
+void detail::evaluate(Tensor<T> &dst, const TensorExpression<T, E> &src, F func)
+{
+    NNAssertEquals(dst.shape(), src.shape(), "Incompatible operands!");
+
+    if(src.overlaps(dst))
+    {
+        Tensor<T> result = src.eval();
+        evaluate(dst, TensorLeaf<T>(result), func);
+        return;
+    }
+
+    T *ptr = dst.ptr();
+    if(dst.contiguous())
+    {
+        src.forEach([&](T value)
+        {
+            func(*ptr, value);
+            ++ptr;
+        });
+        return;
+    }
+
+    const Storage<size_t> &dims = dst.shape(), &strides = dst.strides();
+    NNHardAssertLessThanOrEquals(dims.size(), NN_MAX_NUM_DIMENSIONS, "Too many dimensions! Define NN_MAX_NUM_DIMENSIONS to increase this limit.");
+
+    size_t indices[NN_MAX_NUM_DIMENSIONS] = { 0 };
+    for(size_t n = dst.size(); n > 0; --n)
+    {
+        func(*ptr, src.at(indices));
+        for(size_t d = dims.size(); d > 0; --d)
+        {
+            ptr += strides[d - 1];
+            if(++indices[d - 1] < dims[d - 1])
+                break;
+            ptr -= strides[d - 1] * dims[d - 1];
+            indices[d - 1] = 0;
+        }
+    }
+}
+
+// MARK: Tensor
+
+template <typename T>
+template <typename E>
+Tensor<T>::Tensor(const TensorExpression<T, E> &expr) :
+    Tensor(expr.shape(), true)
+{
+    *this = expr;
+}
+
+template <typename T>
+template <typename E>
+Tensor<T> &Tensor<T>::operator=(const TensorExpression<T, E> &expr)
+{
+    // resizing could also move the storage out from under an operand that views it
+    if(expr.overlaps(*this) || (m_dims != expr.shape() && expr.sharedWith(*this)))
+    {
+        Tensor<T> result = expr.eval();
+        return *this = TensorLeaf<T>(result);
+    }
+
+    if(m_dims != expr.shape())
+        resize(expr.shape());
+
+    detail::evaluate(*this, expr, [](T &x, T y)
+    {
+        x = y;
+    });
+    return *this;
+}
+
+}
+
+// MARK: Operators
+
+template <typename L, typename R>
+typename nnlib::detail::BinaryOf<L, R, nnlib::detail::Plus>::type operator+(const L &lhs, const R &rhs)
+{
+    return typename nnlib::detail::BinaryOf<L, R, nnlib::detail::Plus>::type(lhs, rhs);
+}
+
+template <typename L, typename R>
+typename nnlib::detail::BinaryOf<L, R, nnlib::detail::Minus>::type operator-(const L &lhs, const R &rhs)
+{
+    return typename nnlib::detail::BinaryOf<L, R, nnlib::detail::Minus>::type(lhs, rhs);
+}
+
+template <typename X>
+typename nnlib::detail::ScalarOf<X, nnlib::detail::Multiplies>::type operator*(const X &lhs, typename nnlib::detail::Operand<X>::value_type rhs)
+{
+    return typename nnlib::detail::ScalarOf<X, nnlib::detail::Multiplies>::type(lhs, rhs);
+}
+
+template <typename X>
+typename nnlib::detail::ScalarOf<X, nnlib::detail::Multiplies>::type operator*(typename nnlib::detail::Operand<X>::value_type lhs, const X &rhs)
+{
+    return typename nnlib::detail::ScalarOf<X, nnlib::detail::Multiplies>::type(rhs, lhs);
+}
+
+template <typename X>
+typename nnlib::detail::ScalarOf<X, nnlib::detail::Divides>::type operator/(const X &lhs, typename nnlib::detail::Operand<X>::value_type rhs)
+{
+    return typename nnlib::detail::ScalarOf<X, nnlib::detail::Divides>::type(lhs, rhs);
+}
+
+template <typename T, typename E>
+nnlib::Tensor<T> &operator+=(nnlib::Tensor<T> &lhs, const nnlib::TensorExpression<T, E> &rhs)
+{
+    nnlib::detail::evaluate(lhs, rhs, [](T &x, T y)
+    {
+        x += y;
+    });
+    return lhs;
+}
+
+template <typename T, typename E>
+nnlib::Tensor<T> &operator-=(nnlib::Tensor<T> &lhs, const nnlib::TensorExpression<T, E> &rhs)
+{
+    nnlib::detail::evaluate(lhs, rhs, [](T &x, T y)
+    {
+        x -= y;
+    });
+    return lhs;
+}
+
+#endif
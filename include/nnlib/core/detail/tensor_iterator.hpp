@@ -3,9 +3,19 @@
 
 #include "../tensor.hpp"
 
+#ifndef NN_MAX_NUM_DIMENSIONS
+#define NN_MAX_NUM_DIMENSIONS 32ul
+#endif
+
 namespace nnlib
 {
 
+/// \brief Visits the elements of a tensor in row-major order.
+///
+/// Adjacent dimensions that are laid out contiguously are merged, so the iterator walks a few runs of
+/// evenly-strided elements instead of carrying through every dimension. Consumers that can handle a
+/// whole run at once (with std::copy or a vectorized loop) may step by runs with runLength, runStride,
+/// and nextRun. Iterators are compared by their position, so they must come from the same tensor.
 template <typename T>
 class TensorIterator : public std::iterator<std::forward_iterator_tag, T, std::ptrdiff_t, const T *, T &>
 {
@@ -18,11 +28,24 @@ public:
     bool operator==(const TensorIterator &other);
     bool operator!=(const TensorIterator &other);
 
+    /// The number of elements left in the current run, including this one.
+    size_t runLength() const;
+
+    /// The distance between consecutive elements of the current run; 1 if the run is contiguous.
+    size_t runStride() const;
+
+    /// Move forward n elements, where n is no more than runLength().
+    TensorIterator &advance(size_t n);
+
+    /// Move to the start of the next run.
+    TensorIterator &nextRun();
+
 private:
-    bool m_contiguous;
-    const Storage<size_t> &m_shape;
-    const Storage<size_t> &m_stride;
-    Storage<size_t> m_indices;
+    size_t m_dims;                            ///< Number of merged dimensions, innermost first.
+    size_t m_shape[NN_MAX_NUM_DIMENSIONS];   ///< The length along each merged dimension.
+    size_t m_stride[NN_MAX_NUM_DIMENSIONS];  ///< The stride along each merged dimension.
+    size_t m_indices[NN_MAX_NUM_DIMENSIONS]; ///< Kept inline so iterating never allocates.
+    size_t m_position;                        ///< Number of elements already visited.
     TT *m_ptr;
 };
 
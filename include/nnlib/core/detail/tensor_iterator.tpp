@@ -8,41 +8,74 @@ namespace nnlib
 
 template <typename T>
 TensorIterator<T>::TensorIterator(const Tensor<TT> *tensor, bool end) :
-    m_contiguous(tensor->contiguous()),
-    m_shape(tensor->shape()),
-    m_stride(tensor->strides()),
-    m_indices(m_contiguous ? 1 : tensor->dims(), 0),
+    m_dims(0),
+    m_position(0),
     m_ptr(const_cast<Tensor<TT> *>(tensor)->ptr())
 {
+    const Storage<size_t> &shape = tensor->shape();
+    const Storage<size_t> &stride = tensor->strides();
+    NNHardAssertLessThanOrEquals(shape.size(), NN_MAX_NUM_DIMENSIONS, "Too many dimensions! Define NN_MAX_NUM_DIMENSIONS to increase this limit.");
+
+    // merge from the innermost dimension out, skipping dimensions of length 1
+    for(size_t i = shape.size(); i > 0; --i)
+    {
+        if(shape[i - 1] == 1)
+            continue;
+
+        if(m_dims > 0 && stride[i - 1] == m_stride[m_dims - 1] * m_shape[m_dims - 1])
+            m_shape[m_dims - 1] *= shape[i - 1];
+        else
+        {
+            m_shape[m_dims] = shape[i - 1];
+            m_stride[m_dims] = stride[i - 1];
+            ++m_dims;
+        }
+    }
+
+    if(m_dims == 0)
+    {
+        m_shape[0] = 1;
+        m_stride[0] = 1;
+        m_dims = 1;
+    }
+
+    for(size_t i = 0; i < m_dims; ++i)
+        m_indices[i] = 0;
+
     if(end || tensor->size() == 0)
     {
-        m_indices[0] = m_shape[0];
-        m_ptr += m_stride[0] * m_indices[0];
+        m_position = tensor->size();
+        if(m_dims == 1)
+        {
+            m_indices[0] = m_shape[0];
+            m_ptr += m_stride[0] * m_shape[0];
+        }
     }
 }
 
 template <typename T>
 TensorIterator<T> &TensorIterator<T>::operator++()
 {
-    if(m_contiguous)
+    ++m_position;
+    if(++m_indices[0] < m_shape[0] || m_dims == 1)
     {
-        ++m_ptr;
+        m_ptr += m_stride[0];
         return *this;
     }
 
-    size_t d = m_indices.size() - 1;
-    ++m_indices[d];
-    m_ptr += m_stride[d];
+    m_ptr -= m_stride[0] * (m_shape[0] - 1);
+    m_indices[0] = 0;
 
-    while(m_indices[d] >= m_shape[d] && d > 0)
+    for(size_t d = 1; d < m_dims; ++d)
     {
-        m_ptr -= m_stride[d] * m_indices[d];
-        m_indices[d] = 0;
+        if(++m_indices[d] < m_shape[d])
+        {
+            m_ptr += m_stride[d];
+            break;
+        }
 
-        --d;
-
-        ++m_indices[d];
-        m_ptr += m_stride[d];
+        m_ptr -= m_stride[d] * (m_shape[d] - 1);
+        m_indices[d] = 0;
     }
 
     return *this;
@@ -71,10 +104,39 @@ bool TensorIterator<T>::operator==(const TensorIterator<T> &other)
 template <typename T>
 bool TensorIterator<T>::operator!=(const TensorIterator<T> &other)
 {
-    if(m_contiguous)
-        return m_ptr != other.m_ptr;
-    else
-        return m_indices != other.m_indices;
+    return m_position != other.m_position;
+}
+
+template <typename T>
+size_t TensorIterator<T>::runLength() const
+{
+    return m_shape[0] - m_indices[0];
+}
+
+template <typename T>
+size_t TensorIterator<T>::runStride() const
+{
+    return m_stride[0];
+}
+
+template <typename T>
+TensorIterator<T> &TensorIterator<T>::advance(size_t n)
+{
+    NNAssertLessThanOrEquals(n, runLength(), "Cannot advance past the end of a run!");
+    if(n == 0)
+        return *this;
+
+    // move to the element before the target within the run, then let ++ carry if needed
+    m_position += n - 1;
+    m_indices[0] += n - 1;
+    m_ptr += m_stride[0] * (n - 1);
+    return ++(*this);
+}
+
+template <typename T>
+TensorIterator<T> &TensorIterator<T>::nextRun()
+{
+    return advance(runLength());
 }
 
 }
@@ -84,13 +84,6 @@ nnlib::Tensor<T> &operator+=(nnlib::Tensor<T> &lhs, const nnlib::Tensor<T> &rhs)
     return lhs;
 }
 
-template <typename T>
-nnlib::Tensor<T> operator+(const nnlib::Tensor<T> &lhs, const nnlib::Tensor<T> &rhs)
-{
-    nnlib::Tensor<T> sum = lhs.copy();
-    return sum += rhs;
-}
-
 template <typename T>
 nnlib::Tensor<T> &operator-=(nnlib::Tensor<T> &lhs, const nnlib::Tensor<T> &rhs)
 {
@@ -101,44 +94,16 @@ nnlib::Tensor<T> &operator-=(nnlib::Tensor<T> &lhs, const nnlib::Tensor<T> &rhs)
     return lhs;
 }
 
-template <typename T>
-nnlib::Tensor<T> operator-(const nnlib::Tensor<T> &lhs, const nnlib::Tensor<T> &rhs)
-{
-    nnlib::Tensor<T> difference = lhs.copy();
-    return difference -= rhs;
-}
-
 template <typename T>
 nnlib::Tensor<T> &operator*=(nnlib::Tensor<T> &lhs, typename nnlib::traits::Identity<T>::type rhs)
 {
     return nnlib::math::scale(lhs, rhs);
 }
 
-template <typename T>
-nnlib::Tensor<T> operator*(const nnlib::Tensor<T> &lhs, typename nnlib::traits::Identity<T>::type rhs)
-{
-    nnlib::Tensor<T> product = lhs.copy();
-    return product *= rhs;
-}
-
-template <typename T>
-nnlib::Tensor<T> operator*(typename nnlib::traits::Identity<T>::type lhs, const nnlib::Tensor<T> &rhs)
-{
-    nnlib::Tensor<T> product = rhs.copy();
-    return product *= lhs;
-}
-
 template <typename T>
 nnlib::Tensor<T> &operator/=(nnlib::Tensor<T> &lhs, typename nnlib::traits::Identity<T>::type rhs)
 {
     return nnlib::math::scale(lhs, 1.0 / rhs);
 }
 
-template <typename T>
-nnlib::Tensor<T> operator/(const nnlib::Tensor<T> &lhs, typename nnlib::traits::Identity<T>::type rhs)
-{
-    nnlib::Tensor<T> quotient = lhs.copy();
-    return quotient /= rhs;
-}
-
 #endif
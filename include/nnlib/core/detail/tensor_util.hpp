@@ -10,6 +10,16 @@ namespace nnlib
 template <typename F, typename T, typename ... Ts>
 void forEach(F func, T && first, Ts && ...ts);
 
+/// \brief Apply a function to each element in one or more tensors whose shapes broadcast together.
+///
+/// Shapes are aligned from the last dimension, and a missing dimension or one of size 1 is repeated to
+/// match the others (as with Tensor::broadcast, but without building views). A tensor that is written
+/// to may be broadcast as well, in which case func sees its elements repeatedly; this accumulates
+/// reductions such as bias gradients. Dimensions are visited in the order that walks the operands'
+/// memory most closely, so the innermost loop has the smallest stride.
+template <typename F, typename T, typename ... Ts>
+void forEachBroadcast(F func, T && first, Ts && ...ts);
+
 }
 
 #include "tensor_util.tpp"
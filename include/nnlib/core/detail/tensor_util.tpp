@@ -2,6 +2,7 @@
 #define CORE_TENSOR_UTIL_TPP
 
 #include "tensor_util.hpp"
+#include <algorithm>
 
 #ifndef NN_MAX_NUM_DIMENSIONS
 #define NN_MAX_NUM_DIMENSIONS 32ul
@@ -15,8 +16,8 @@ namespace detail
     template <size_t D, size_t I>
     struct ForEachHelper
     {
-        template <typename F, typename ... Ts>
-        static void apply(Storage<size_t> &indices, const Storage<size_t> &shape, F func, Ts && ...ts)
+        template <typename S, typename F, typename ... Ts>
+        static void apply(size_t *indices, const S &shape, F func, Ts && ...ts)
         {
             for(indices[I] = 0; indices[I] < shape[I]; ++indices[I])
                 ForEachHelper<D-1, I+1>::apply(indices, shape, func, std::forward<Ts>(ts)...);
@@ -26,8 +27,8 @@ namespace detail
     template <size_t I>
     struct ForEachHelper<1ul, I>
     {
-        template <typename F, typename ... Ts>
-        static void apply(Storage<size_t> &indices, const Storage<size_t> &shape, F func, Ts && ...ts)
+        template <typename S, typename F, typename ... Ts>
+        static void apply(size_t *indices, const S &shape, F func, Ts && ...ts)
         {
             for(indices[I] = 0; indices[I] < shape[I]; ++indices[I])
                 func(std::forward<Ts>(ts).ptr()[indexOf(std::forward<Ts>(ts), indices)]...);
@@ -35,10 +36,10 @@ namespace detail
 
     private:
         template <typename T>
-        static size_t indexOf(T && tensor, const Storage<size_t> &indices)
+        static size_t indexOf(T && tensor, const size_t *indices)
         {
-            NNAssertEquals(tensor.dims(), indices.size(), "Incompatible tensors in forEach!");
-            const Storage<size_t> &strides = tensor.strides();
+            NNAssertEquals(tensor.dims(), I + 1, "Incompatible tensors in forEach!");
+            const auto &strides = tensor.strides();
             size_t i = 0;
             for(size_t j = 0; j < I + 1; ++j)
             {
@@ -52,14 +53,126 @@ namespace detail
     template <size_t D>
     struct ForEach
     {
-        template <typename F, typename ... Ts>
-        static void apply(const Storage<size_t> &shape, F func, Ts && ...ts)
+        template <typename S, typename F, typename ... Ts>
+        static void apply(const S &shape, F func, Ts && ...ts)
         {
-            Storage<size_t> indices(D);
+            size_t indices[D];
             ForEachHelper<D, 0>::apply(indices, shape, func, std::forward<Ts>(ts)...);
         }
     };
 
+    template <size_t ... Is>
+    struct Indices
+    {};
+
+    template <size_t N, size_t ... Is>
+    struct MakeIndices : MakeIndices<N - 1, N - 1, Is...>
+    {};
+
+    template <size_t ... Is>
+    struct MakeIndices<0ul, Is...>
+    {
+        using type = Indices<Is...>;
+    };
+
+    /// The common shape of K tensors and the stride of each tensor along it, with no allocation.
+    template <size_t K>
+    struct Broadcast
+    {
+        size_t dims;
+        size_t shape[NN_MAX_NUM_DIMENSIONS];
+        size_t strides[K][NN_MAX_NUM_DIMENSIONS];
+
+        template <typename ... Ts>
+        Broadcast(const Ts & ...ts)
+        {
+            const Storage<size_t> *shapes[K] = { &ts.shape()... };
+            const Storage<size_t> *steps[K] = { &ts.strides()... };
+
+            dims = 0;
+            for(size_t k = 0; k < K; ++k)
+                dims = std::max(dims, shapes[k]->size());
+            NNHardAssertLessThanOrEquals(dims, NN_MAX_NUM_DIMENSIONS, "Too many dimensions! Define NN_MAX_NUM_DIMENSIONS to increase this limit.");
+
+            for(size_t d = 0; d < dims; ++d)
+            {
+                shape[d] = 1;
+                for(size_t k = 0; k < K; ++k)
+                {
+                    size_t missing = dims - shapes[k]->size();
+                    size_t size = d < missing ? 1 : (*shapes[k])[d - missing];
+                    NNAssert(size == 1 || shape[d] == 1 || size == shape[d], "Incompatible shapes for broadcasting!");
+                    if(size != 1)
+                        shape[d] = size;
+                }
+
+                for(size_t k = 0; k < K; ++k)
+                {
+                    size_t missing = dims - shapes[k]->size();
+                    strides[k][d] = d < missing || (*shapes[k])[d - missing] == 1 ? 0 : (*steps[k])[d - missing];
+                }
+            }
+
+            reorder();
+        }
+
+        /// Whether dimension a should be visited outside of dimension b; decided by the first tensor that moves along both.
+        bool outer(size_t a, size_t b) const
+        {
+            for(size_t k = 0; k < K; ++k)
+                if(strides[k][a] != 0 && strides[k][b] != 0 && strides[k][a] != strides[k][b])
+                    return strides[k][a] > strides[k][b];
+            return false;
+        }
+
+        /// Stable insertion sort of the dimensions so that the innermost has the smallest strides.
+        void reorder()
+        {
+            for(size_t i = 1; i < dims; ++i)
+            {
+                for(size_t j = i; j > 0 && outer(j, j - 1); --j)
+                {
+                    std::swap(shape[j], shape[j - 1]);
+                    for(size_t k = 0; k < K; ++k)
+                        std::swap(strides[k][j], strides[k][j - 1]);
+                }
+            }
+        }
+
+        template <typename F, size_t ... Is, typename ... Ps>
+        void apply(F func, Indices<Is...>, Ps ...ptrs) const
+        {
+            for(size_t d = 0; d < dims; ++d)
+                if(shape[d] == 0)
+                    return;
+
+            size_t inner = dims - 1, length = shape[inner];
+            size_t indices[NN_MAX_NUM_DIMENSIONS] = { 0 };
+            size_t offsets[K] = { 0 };
+
+            while(true)
+            {
+                for(size_t i = 0; i < length; ++i)
+                    func(ptrs[offsets[Is] + i * strides[Is][inner]]...);
+
+                size_t d = inner;
+                for(; d > 0; --d)
+                {
+                    for(size_t k = 0; k < K; ++k)
+                        offsets[k] += strides[k][d - 1];
+                    if(++indices[d - 1] < shape[d - 1])
+                        break;
+                    for(size_t k = 0; k < K; ++k)
+                        offsets[k] -= strides[k][d - 1] * shape[d - 1];
+                    indices[d - 1] = 0;
+                }
+
+                if(d == 0)
+                    return;
+            }
+        }
+    };
+
     template <size_t MIN, size_t MAX, template <size_t> class WORKER>
     struct TemplateSearch
     {
@@ -83,13 +196,49 @@ namespace detail
             WORKER<MAX>::apply(std::forward<Ts>(ts)...);
         }
     };
+
+    /// The number of dimensions of a tensor type, or 0 if it is only known at run time.
+    template <typename T>
+    struct StaticRank
+    {
+        static constexpr size_t value = 0;
+    };
+
+    /// Dispatches forEach directly when the rank is known at compile time.
+    template <size_t R>
+    struct ForEachRank
+    {
+        template <typename ... Ts>
+        static void apply(size_t, Ts && ...ts)
+        {
+            ForEach<R>::apply(std::forward<Ts>(ts)...);
+        }
+    };
+
+    template <>
+    struct ForEachRank<0ul>
+    {
+        template <typename ... Ts>
+        static void apply(size_t dims, Ts && ...ts)
+        {
+            TemplateSearch<1ul, NN_MAX_NUM_DIMENSIONS, ForEach>::apply(dims, std::forward<Ts>(ts)...);
+        }
+    };
 }
 
 /// A more efficient way apply a function to each element in one or more tensors.
 template <typename F, typename T, typename ... Ts>
 void forEach(F func, T && first, Ts && ...ts)
 {
-    detail::TemplateSearch<1ul, NN_MAX_NUM_DIMENSIONS, detail::ForEach>::apply(first.dims(), first.shape(), func, std::forward<T>(first), std::forward<Ts>(ts)...);
+    using Rank = detail::StaticRank<typename std::decay<T>::type>;
+    detail::ForEachRank<Rank::value>::apply(first.dims(), first.shape(), func, std::forward<T>(first), std::forward<Ts>(ts)...);
+}
+
+template <typename F, typename T, typename ... Ts>
+void forEachBroadcast(F func, T && first, Ts && ...ts)
+{
+    detail::Broadcast<sizeof...(Ts) + 1> broadcast(first, ts...);
+    broadcast.apply(func, typename detail::MakeIndices<sizeof...(Ts) + 1>::type(), std::forward<T>(first).ptr(), std::forward<Ts>(ts).ptr()...);
 }
 
 }
@@ -0,0 +1,81 @@
+#ifndef CORE_FIXED_TENSOR_HPP
+#define CORE_FIXED_TENSOR_HPP
+
+#include "tensor.hpp"
+
+namespace nnlib
+{
+
+/// \brief A tensor whose number of dimensions is fixed at compile time.
+///
+/// The shape and strides are kept inline, so indexing is unrolled arithmetic with no allocation
+/// and no search over the number of dimensions. A fixed tensor is a view into the same storage as
+/// a dynamic Tensor and converts to and from one implicitly, so module code can take a Tensor and
+/// index it through a FixedTensor internally. Like a TensorIterator, a fixed tensor caches the
+/// address of its data, and is invalidated if the underlying storage is reallocated.
+template <typename T, size_t R>
+class FixedTensor
+{
+static_assert(R > 0, "A fixed tensor must have at least one dimension!");
+public:
+    using type = T;
+
+    /// Create an empty tensor.
+    FixedTensor();
+
+    /// Create a tensor with the given shape.
+    template <typename ... Ts>
+    explicit FixedTensor(size_t dim1, Ts... dims);
+
+    /// \brief Create a view of a dynamic tensor.
+    ///
+    /// The tensor must have exactly R dimensions. A view of a const tensor should itself be const.
+    FixedTensor(const Tensor<T> &other);
+
+    /// Create a dynamic tensor viewing the same data.
+    operator Tensor<T>() const;
+
+    static constexpr size_t dims()
+    {
+        return R;
+    }
+
+    const size_t *shape() const;
+    const size_t *strides() const;
+    size_t size() const;
+    size_t size(size_t dim) const;
+    size_t stride(size_t dim) const;
+    bool contiguous() const;
+
+    template <typename ... Ts>
+    T &at(Ts... indices);
+
+    template <typename ... Ts>
+    const T &at(Ts... indices) const;
+
+    template <typename ... Ts>
+    T &operator()(Ts... indices);
+
+    template <typename ... Ts>
+    const T &operator()(Ts... indices) const;
+
+    T *ptr();
+    const T *ptr() const;
+
+private:
+    std::shared_ptr<Storage<T>> m_shared; ///< The shared data.
+    T *m_ptr;                             ///< The first element of this view.
+    size_t m_dims[R];                     ///< The length along each dimension.
+    size_t m_strides[R];                  ///< Strides between dimensions.
+    size_t m_size;                        ///< The total number of elements.
+    bool m_contiguous;                    ///< Whether this tensor is contiguous.
+
+    /// Reset strides to a contiguous layout and recalculate size.
+    void resetStrides();
+};
+
+}
+
+#include "detail/fixed_tensor.tpp"
+
+#endif
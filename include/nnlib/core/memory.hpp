@@ -0,0 +1,81 @@
+#ifndef CORE_MEMORY_HPP
+#define CORE_MEMORY_HPP
+
+#include "type.hpp"
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+namespace nnlib
+{
+
+/// Allocation counters for Storage buffers.
+struct MemoryStats
+{
+    size_t allocations = 0; ///< Number of buffers allocated.
+    size_t frees = 0;       ///< Number of buffers freed.
+    size_t bytes = 0;       ///< Total bytes allocated.
+    size_t resident = 0;    ///< Bytes currently allocated.
+    size_t peak = 0;        ///< Largest number of bytes allocated at once.
+};
+
+/// \brief Opt-in instrumentation of Storage allocations.
+///
+/// While enabled, every buffer a Storage allocates or frees is counted in the totals and against the
+/// tag of the innermost Scope active on the allocating thread; Sequential tags each component with
+/// its own address while running it. A buffer is freed against the tag it was allocated under, and
+/// buffers allocated while disabled are never counted. When disabled, the cost is one check per
+/// allocation.
+class MemoryTracker
+{
+public:
+    /// Attributes allocations on this thread to a tag (usually a module) for the lifetime of the scope.
+    class Scope
+    {
+    public:
+        explicit Scope(const void *tag);
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        const void *m_previous;
+    };
+
+    static void enable(bool enabled = true);
+    static bool enabled();
+
+    /// Clear the totals and all tags. Buffers that are still resident are forgotten.
+    static void reset();
+
+    /// Counters over all tracked allocations.
+    static MemoryStats total();
+
+    /// Counters for allocations made under the given tag.
+    static MemoryStats stats(const void *tag);
+
+    /// The tag of the innermost active scope on this thread, or nullptr.
+    static const void *currentTag();
+
+    /// Record an allocation; called by Storage.
+    static void allocated(const void *tag, size_t bytes);
+
+    /// Record a free of a buffer allocated under tag; called by Storage.
+    static void freed(const void *tag, size_t bytes);
+
+private:
+    static std::atomic<bool> &flag();
+    static const void *&current();
+    static std::mutex &mutex();
+    static MemoryStats &totals();
+    static std::unordered_map<const void *, MemoryStats> &tags();
+};
+
+}
+
+#if !defined NN_REAL_T && !defined NN_IMPL
+    #include "detail/memory.tpp"
+#endif
+
+#endif
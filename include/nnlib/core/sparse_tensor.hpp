@@ -0,0 +1,73 @@
+#ifndef CORE_SPARSE_TENSOR_HPP
+#define CORE_SPARSE_TENSOR_HPP
+
+#include "tensor.hpp"
+
+namespace nnlib
+{
+
+/// \brief A matrix that stores only its nonzero elements, in compressed sparse row (CSR) format.
+///
+/// values holds the nonzero elements row by row, indices holds the column of each, and offsets holds
+/// where each row starts in values, with a final entry marking the end of the last row. Memory and the
+/// sparse kernels in math/algebra.hpp scale with the number of nonzeros rather than with the width, so
+/// a sparse tensor can hold rows far too wide to store densely. Columns within a row need not be sorted.
+template <typename T = NN_REAL_T>
+class SparseTensor
+{
+public:
+    using type = T;
+
+    /// Create an all-zero matrix.
+    explicit SparseTensor(size_t rows = 0, size_t cols = 0);
+
+    /// Create a sparse copy of the nonzero elements of a dense matrix.
+    explicit SparseTensor(const Tensor<T> &dense);
+
+    /// Create a matrix from existing CSR arrays.
+    SparseTensor(size_t cols, const Storage<size_t> &offsets, const Storage<size_t> &indices, const Storage<T> &values);
+
+    /// Make this an all-zero matrix with the given shape, keeping allocated memory.
+    SparseTensor &resize(size_t rows, size_t cols);
+
+    /// Add an empty row to the bottom of this matrix.
+    SparseTensor &appendRow();
+
+    /// Add a copy of the given row of another matrix to the bottom of this matrix.
+    SparseTensor &appendRow(const SparseTensor &other, size_t row);
+
+    /// Add a nonzero element to the last row.
+    SparseTensor &append(size_t col, T value);
+
+    /// Reserve room for the given number of rows and nonzeros.
+    SparseTensor &reserve(size_t rows, size_t nonzeros);
+
+    const Storage<size_t> &shape() const;
+    size_t dims() const;
+    size_t size(size_t dim) const;
+    size_t nonzeros() const;
+
+    const Storage<size_t> &offsets() const;
+    const Storage<size_t> &indices() const;
+    Storage<T> &values();
+    const Storage<T> &values() const;
+
+    /// Create a dense copy of this matrix.
+    Tensor<T> dense() const;
+
+private:
+    Storage<size_t> m_shape;   ///< The number of rows and columns.
+    Storage<size_t> m_offsets; ///< The start of each row in m_indices and m_values, plus the end of the last.
+    Storage<size_t> m_indices; ///< The column of each nonzero element.
+    Storage<T> m_values;       ///< The nonzero elements.
+};
+
+}
+
+#if defined NN_REAL_T && !defined NN_IMPL
+    extern template class nnlib::SparseTensor<NN_REAL_T>;
+#elif !defined NN_IMPL
+    #include "detail/sparse_tensor.tpp"
+#endif
+
+#endif
@@ -1,8 +1,16 @@
 #ifndef CORE_STORAGE_HPP
 #define CORE_STORAGE_HPP
 
+#include "allocator.hpp"
+#include "memory.hpp"
 #include "type.hpp"
+#include <functional>
 #include <initializer_list>
+#include <string>
+
+#if !defined NN_MMAP && (defined __unix__ || defined __APPLE__)
+#define NN_MMAP
+#endif
 
 namespace nnlib
 {
@@ -12,7 +20,10 @@ class Serialized;
 /// Unique, contigious storage that manages its own memory.
 /// May be shared across multiple objects.
 /// Used by tensors.
-template <typename T>
+/// Memory comes from the allocator policy A (see AlignedAllocator and PoolAllocator), and growing
+/// copies trivially copyable elements with memcpy.
+/// Alternatively, storage can wrap an external buffer (see borrow) or a memory-mapped file (see map).
+template <typename T, typename A = PoolAllocator>
 class Storage
 {
 public:
@@ -26,6 +37,29 @@ public:
     Storage &operator=(const Storage &copy);
     Storage &operator=(const std::initializer_list<T> &values);
 
+    /// \brief Create storage backed by n elements of a file, starting offset bytes in, instead of allocating.
+    ///
+    /// Pages are loaded on demand and shared through the page cache with every other process mapping
+    /// the same file. A read-only mapping must not be written to. A copy-on-write mapping may be written,
+    /// but changes stay private to this process and are never written back. Growing past the mapped size
+    /// moves the data into allocated memory. Only available on POSIX systems, where NN_MMAP is defined.
+#ifdef NN_MMAP
+    static Storage map(const std::string &filename, size_t offset, size_t n, bool copyOnWrite = false);
+#endif
+
+    /// \brief Create storage that uses n elements at ptr instead of allocating.
+    ///
+    /// The caller keeps ownership of the buffer, which must outlive the storage, unless a deleter is given;
+    /// the deleter is called with ptr once the storage no longer uses the buffer. Growing past n elements
+    /// moves the data into allocated memory (and calls the deleter).
+    static Storage borrow(T *ptr, size_t n, const std::function<void(T *)> &deleter = nullptr);
+
+    /// Whether this storage uses an external buffer (from borrow or map) rather than its allocator.
+    bool external() const;
+
+    /// Whether this storage may be written to (false only for read-only mappings).
+    bool writable() const;
+
     Storage &resize(size_t n, const T &defaultValue = T());
     Storage &reserve(size_t n);
 
@@ -61,6 +95,16 @@ public:
     void save(Serialized &node) const;
 
 private:
+    T *allocate(size_t n);
+    void release();
+    static void deallocate(T *ptr, size_t n, const void *tag, bool tracked);
+    static void assign(T *to, const T *from, size_t n);
+
+    const void *m_tag = nullptr; ///< The MemoryTracker tag the buffer was allocated under.
+    bool m_tracked = false;      ///< Whether the buffer was counted by MemoryTracker.
+    bool m_external = false;     ///< Whether the buffer came from borrow or map.
+    bool m_writable = true;      ///< False for read-only mappings.
+    std::function<void(T *)> m_deleter; ///< Called to release an external buffer, if set.
     T *m_ptr;          ///< The data itself.
     size_t m_size;     ///< Number of elements being used.
     size_t m_capacity; ///< Number of elements available in buffer.
@@ -6,6 +6,8 @@
 #include <iomanip>
 #include <memory>
 #include <functional>
+#include <cstdint>
+#include <string>
 
 namespace nnlib
 {
@@ -15,6 +17,12 @@ class Serialized;
 template <typename T>
 class TensorIterator;
 
+template <typename T, typename E>
+class TensorExpression;
+
+template <typename T, size_t R>
+class FixedTensor;
+
 /// \brief The standard input and output type in nnlib.
 ///
 /// A tensor can be a vector (one dimension), a matrix (two dimensions), or a higher-order tensor.
@@ -44,6 +52,30 @@ public:
     /// \return The concatenated tensor.
     static Tensor concatenate(const Storage<Tensor *> &tensors, size_t dim = (size_t) -1);
 
+    /// \brief Views a tensor file (see write) in place instead of loading it.
+    ///
+    /// The data is memory-mapped (see Storage::map), so opening is immediate regardless of size, pages are
+    /// read from disk as they are touched, and processes mapping the same file share one copy in the page cache.
+    /// Only available where NN_MMAP is defined.
+    /// \param filename The file to map.
+    /// \param copyOnWrite If false, the tensor is read-only and must not be written to. If true, writes are allowed but stay private to this process.
+    /// \return A tensor viewing the file.
+#ifdef NN_MMAP
+    static Tensor map(const std::string &filename, bool copyOnWrite = false);
+#endif
+
+    /// \brief Views an external buffer in place instead of copying it.
+    ///
+    /// The buffer is used through Storage::borrow, so views, math and algebra work on it directly. It must outlive
+    /// the tensor and every view of it unless a deleter is given, in which case the deleter is called once the last of
+    /// them is gone. Resizing beyond the buffer moves the data into allocated memory.
+    /// \param ptr The first element.
+    /// \param shape The length along each dimension.
+    /// \param strides The stride between elements along each dimension; contiguous row-major if empty.
+    /// \param deleter Called with ptr when the buffer is no longer used.
+    /// \return A tensor viewing the buffer.
+    static Tensor borrow(T *ptr, const Storage<size_t> &shape, const Storage<size_t> &strides = Storage<size_t>(), const std::function<void(T *)> &deleter = nullptr);
+
     /// Create a zero-length, one-dimensional tensor.
     Tensor();
 
@@ -97,6 +129,13 @@ public:
     /// Load from a serialized node.
     Tensor(const Serialized &node);
 
+    /// \brief Create a tensor holding the result of an expression.
+    ///
+    /// The expression is evaluated in a single pass directly into the new storage.
+    /// \param expr The expression to evaluate, such as `a * 2 + b`.
+    template <typename E>
+    Tensor(const TensorExpression<T, E> &expr);
+
     /// \brief Replace tensor contents with new values.
     ///
     /// Resizes the tensor to be a vector (one-dimensional) and copies data from values.
@@ -123,6 +162,16 @@ public:
     /// \note This essentially performs a shallow copy.
     Tensor &operator=(Tensor &&other);
 
+    /// \brief Evaluate an expression into this tensor.
+    ///
+    /// Unlike assigning a tensor, this writes into the existing storage (resizing if necessary) instead of sharing.
+    /// The expression is evaluated in a single pass without temporaries, so `c = a * 2 + b - c` is safe.
+    /// An operand that views this storage with a different layout, as in `c = c.transpose() + a`, is
+    /// evaluated into a temporary first, as is any operand sharing this storage when this must be resized.
+    /// \param expr The expression to evaluate.
+    template <typename E>
+    Tensor &operator=(const TensorExpression<T, E> &expr);
+
     /// Returns whether this tensor shares a buffer with another tensor.
     bool shared() const;
 
@@ -152,7 +201,8 @@ public:
     template <typename ... Ts>
     Tensor &resize(size_t dim1, Ts... dims)
     {
-        return resize(Storage<size_t>{ dim1, static_cast<size_t>(dims)... });
+        const std::initializer_list<size_t> shape = { dim1, static_cast<size_t>(dims)... };
+        return resizeTo(shape.begin(), shape.size());
     }
 
     /// \brief Resize one dimension of this tensor in place and, if necessary, resize its underlying storage.
@@ -281,6 +331,24 @@ public:
     /// \return A const tensor containing the "superview."
     const Tensor expand(size_t dim, size_t size) const;
 
+    /// \brief Creates a new tensor viewing this tensor's data repeated to fill the given shape.
+    ///
+    /// Shapes are aligned from the last dimension, following NumPy's broadcasting rules. Missing leading
+    /// dimensions are added and dimensions of size 1 are expanded (see expand), all with a stride of 0.
+    /// Every other dimension must already match the given shape.
+    /// \param shape The shape of the resulting tensor.
+    /// \return A tensor containing the "superview."
+    Tensor broadcast(const Storage<size_t> &shape);
+
+    /// \brief Creates a new const tensor viewing this tensor's data repeated to fill the given shape.
+    ///
+    /// Shapes are aligned from the last dimension, following NumPy's broadcasting rules. Missing leading
+    /// dimensions are added and dimensions of size 1 are expanded (see expand), all with a stride of 0.
+    /// Every other dimension must already match the given shape.
+    /// \param shape The shape of the resulting tensor.
+    /// \return A const tensor containing the "superview."
+    const Tensor broadcast(const Storage<size_t> &shape) const;
+
     /// \brief Makes the given tensor a subview of this tensor's data.
     ///
     /// The parameter tensor ends up with the same number of dimensions as this tensor.
@@ -331,9 +399,12 @@ public:
     /// \brief Copies the data and shape from another tensor to this tensor.
     ///
     /// This is a deep copy, but the tensor will not necessarily have the same shape, just the same size, as the other tensor.
+    /// Very large copies are split across up to the given number of threads, using parallelForUnseeded, so
+    /// copying never changes the random sequence.
     /// \param other The tensor to copy.
+    /// \param threads The most threads to use, or 0 for hardwareThreads().
     /// \return This tensor, for chaining.
-    Tensor &copy(const Tensor &other);
+    Tensor &copy(const Tensor &other, size_t threads = 0);
 
     /// \brief Swaps the data between two tensors.
     ///
@@ -386,8 +457,8 @@ public:
     /// Gets whether the tensor is contiguous in memory.
     bool contiguous() const;
 
-    /// Makes the tensor contiguous in memory.
-    Tensor &makeContiguous();
+    /// Makes the tensor contiguous in memory, copying with up to the given number of threads (see copy) if needed.
+    Tensor &makeContiguous(size_t threads = 0);
 
     /// \brief Gets the stride of a given dimension.
     ///
@@ -443,7 +514,19 @@ public:
 
     void save(Serialized &node) const;
 
+    /// \brief Writes this tensor to a file that map can open.
+    ///
+    /// All values are in native byte order. The header holds the magic string "NNTENSOR" (8 bytes), the format
+    /// version 1 (uint32), the element type (uint32, kind << 8 | sizeof(T), with kind 0 for unsigned integers,
+    /// 1 for signed integers and 2 for floating point), the number of dimensions (uint64), and then each dimension
+    /// (uint64). It is zero-padded to a multiple of 64 bytes, after which the elements follow in row-major order.
+    /// \param filename The file to write.
+    void write(const std::string &filename) const;
+
 private:
+    template <typename U, size_t R>
+    friend class FixedTensor;
+
     Storage<size_t> m_dims;               ///< The length along each dimension.
     Storage<size_t> m_strides;            ///< Strides between dimensions.
     size_t m_offset;                      ///< Offset of data for this view.
@@ -455,15 +538,27 @@ private:
     /// Check whether the given list of tensors is already vectorized.
     static bool isVectorized(const Storage<Tensor *> &tensors);
 
+    /// The element type code used in tensor files (see write).
+    static uint32_t fileType();
+
+    /// The size of a tensor file header, which is also the offset of the data.
+    static size_t fileHeaderSize(size_t dims);
+
     /// Get the appropriate contiguous index given the multidimensional index.
     size_t indexOf(const std::initializer_list<size_t> &indices) const;
 
     /// Get the appropriate contiguous index given the multidimensional index.
     size_t indexOf(const Storage<size_t> &indices) const;
 
+    /// Resize to the given shape, updating the shape and strides in place rather than building new ones.
+    Tensor &resizeTo(const size_t *dims, size_t count);
+
     /// Recalculate and cache the size of this tensor.
     void recalculateSize();
 
+    /// Reset strides, size, and contiguity for a packed row-major layout of the current shape.
+    void resetStrides();
+
     /// Check and cache whether this tensor is contiguous.
     void checkContiguous();
 };
@@ -479,5 +574,6 @@ private:
 #include "detail/tensor_iterator.hpp"
 #include "detail/tensor_operators.hpp"
 #include "detail/tensor_util.hpp"
+#include "detail/tensor_expression.hpp"
 
 #endif
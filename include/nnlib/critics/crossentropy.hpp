@@ -0,0 +1,48 @@
+#ifndef CRITICS_CROSSENTROPY_HPP
+#define CRITICS_CROSSENTROPY_HPP
+
+#include "critic.hpp"
+
+namespace nnlib
+{
+
+/// \brief Cross-entropy critic over raw logits.
+///
+/// This is equivalent to LogSoftMax followed by NLL, including how averaging is normalized,
+/// but it works directly on the logits: the loss uses a streaming log-sum-exp and the gradient is
+/// written as softmax - onehot without materializing log probabilities or a separate NLL gradient.
+/// This critic requires matrix input and single-column matrix output.
+template <typename T = NN_REAL_T>
+class CrossEntropy : public Critic<T>
+{
+public:
+    CrossEntropy(bool average = true);
+
+    bool average() const;
+    CrossEntropy &average(bool ave);
+
+    /// A convenience method for counting misclassifications, since we know the output will be categorical.
+    size_t misclassifications(const Tensor<T> &input, const Tensor<T> &target);
+
+    /// L = 1/n sum_i( logsumexp(input(i)) - input(i, target(i)) ), where n is input.size() (batch size times classes) like NLL, or 1 without averaging
+    virtual T forward(const Tensor<T> &input, const Tensor<T> &target) override;
+
+    /// dL/di = (softmax(input(i)) - onehot(target(i))) / n, with the same n
+    virtual Tensor<T> &backward(const Tensor<T> &input, const Tensor<T> &target) override;
+
+protected:
+    using Critic<T>::m_inGrad;
+
+private:
+    bool m_average;
+};
+
+}
+
+#if defined NN_REAL_T && !defined NN_IMPL
+    extern template class nnlib::CrossEntropy<NN_REAL_T>;
+#elif !defined NN_IMPL
+    #include "detail/crossentropy.tpp"
+#endif
+
+#endif
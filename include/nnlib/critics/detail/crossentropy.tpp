@@ -0,0 +1,143 @@
+#ifndef CRITICS_CROSSENTROPY_TPP
+#define CRITICS_CROSSENTROPY_TPP
+
+#include "../crossentropy.hpp"
+#include "../../core/fixed_tensor.hpp"
+#include "../../math/vecmath.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace nnlib
+{
+
+template <typename T>
+CrossEntropy<T>::CrossEntropy(bool average) :
+    m_average(average)
+{}
+
+template <typename T>
+bool CrossEntropy<T>::average() const
+{
+    return m_average;
+}
+
+template <typename T>
+CrossEntropy<T> &CrossEntropy<T>::average(bool ave)
+{
+    m_average = ave;
+    return *this;
+}
+
+template <typename T>
+size_t CrossEntropy<T>::misclassifications(const Tensor<T> &input, const Tensor<T> &target)
+{
+    NNAssertEquals(input.size(0), target.size(0), "Incompatible operands!");
+    NNAssertEquals(input.dims(), 2, "Expected matrix input!");
+    NNAssertEquals(target.dims(), 2, "Expected matrix target!");
+    NNAssertEquals(target.size(1), 1, "Expected single-column target!");
+
+    const FixedTensor<T, 2> y = target;
+    size_t miss = 0, cols = input.size(1), s0 = input.stride(0), s1 = input.stride(1);
+    for(size_t i = 0, iend = input.size(0); i < iend; ++i)
+    {
+        NNAssertGreaterThanOrEquals(y(i, 0), 0, "Expected positive target!");
+
+        const T *row = input.ptr() + i * s0;
+        size_t max = 0;
+        for(size_t j = 1; j < cols; ++j)
+            if(row[j * s1] > row[max * s1])
+                max = j;
+
+        if(max != y(i, 0))
+            ++miss;
+    }
+
+    return miss;
+}
+
+template <typename T>
+T CrossEntropy<T>::forward(const Tensor<T> &input, const Tensor<T> &target)
+{
+    NNAssertEquals(input.size(0), target.size(0), "Incompatible operands!");
+    NNAssertEquals(input.dims(), 2, "Expected matrix input!");
+    NNAssertEquals(target.dims(), 2, "Expected matrix target!");
+    NNAssertEquals(target.size(1), 1, "Expected single-column target!");
+
+    const FixedTensor<T, 2> y = target;
+    size_t cols = input.size(1), s0 = input.stride(0), s1 = input.stride(1);
+    T sum = 0;
+
+    for(size_t i = 0, iend = input.size(0); i < iend; ++i)
+    {
+        NNAssertGreaterThanOrEquals(y(i, 0), 0, "Expected positive target!");
+        NNAssertLessThan(y(i, 0), cols, "Target out of bounds!");
+
+        // streaming log-sum-exp; the running sum is rescaled whenever the running max grows
+        const T *row = input.ptr() + i * s0;
+        T max = row[0], expSum = 1;
+        for(size_t j = 1; j < cols; ++j)
+        {
+            T x = row[j * s1];
+            if(x > max)
+            {
+                expSum = expSum * vecmath::exp(max - x) + 1;
+                max = x;
+            }
+            else
+                expSum += vecmath::exp(x - max);
+        }
+
+        size_t t = y(i, 0);
+        sum += max + vecmath::log(expSum) - row[t * s1];
+    }
+
+    if(m_average)
+        sum /= input.size();
+
+    return sum;
+}
+
+template <typename T>
+Tensor<T> &CrossEntropy<T>::backward(const Tensor<T> &input, const Tensor<T> &target)
+{
+    NNAssertEquals(input.size(0), target.size(0), "Incompatible operands!");
+    NNAssertEquals(input.dims(), 2, "Expected matrix input!");
+    NNAssertEquals(target.size(1), 1, "Expected single-column target!");
+
+    m_inGrad.resize(input.shape());
+
+    const FixedTensor<T, 2> y = target;
+    size_t cols = input.size(1), s0 = input.stride(0), s1 = input.stride(1);
+    T weight = m_average ? 1.0 / input.size() : 1.0;
+
+    for(size_t i = 0, iend = input.size(0); i < iend; ++i)
+    {
+        NNAssertGreaterThanOrEquals(y(i, 0), 0, "Expected positive target!");
+        NNAssertLessThan(y(i, 0), cols, "Target out of bounds!");
+
+        const T *row = input.ptr() + i * s0;
+        T *grad = m_inGrad.ptr() + i * cols;
+
+        T max = row[0];
+        for(size_t j = 1; j < cols; ++j)
+            max = std::max(max, row[j * s1]);
+
+        // exp is evaluated once per element; the result is normalized in place
+        T expSum = 0;
+        for(size_t j = 0; j < cols; ++j)
+            expSum += (grad[j] = vecmath::exp(row[j * s1] - max));
+
+        T scale = weight / expSum;
+        for(size_t j = 0; j < cols; ++j)
+            grad[j] *= scale;
+
+        size_t t = y(i, 0);
+        grad[t] -= weight;
+    }
+
+    return m_inGrad;
+}
+
+}
+
+#endif
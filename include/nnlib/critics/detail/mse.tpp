@@ -2,6 +2,7 @@
 #define CRITICS_MSE_TPP
 
 #include "../mse.hpp"
+#include <algorithm>
 
 namespace nnlib
 {
@@ -29,14 +30,22 @@ T MSE<T>::forward(const Tensor<T> &input, const Tensor<T> &target)
 {
     NNAssertEquals(input.shape(), target.shape(), "Incompatible operands!");
 
+    auto inp = input.begin(), end = input.end();
     auto tar = target.begin();
     T diff, sum = 0;
-    forEach([&](const T &inp)
+    while(inp != end)
     {
-        diff = inp - *tar;
-        sum += diff * diff;
-        ++tar;
-    }, input);
+        size_t n = std::min(inp.runLength(), tar.runLength());
+        size_t si = inp.runStride(), st = tar.runStride();
+        const T *x = &*inp, *y = &*tar;
+        for(size_t k = 0; k < n; ++k)
+        {
+            diff = x[k * si] - y[k * st];
+            sum += diff * diff;
+        }
+        inp.advance(n);
+        tar.advance(n);
+    }
 
     if(m_average)
         sum /= input.size();
@@ -54,13 +63,21 @@ Tensor<T> &MSE<T>::backward(const Tensor<T> &input, const Tensor<T> &target)
     if(m_average)
         norm /= input.size();
 
-    auto inp = input.begin(), tar = target.begin();
-    forEach([&](T &g)
+    // m_inGrad is contiguous, so only the operands need to be walked by runs
+    auto inp = input.begin(), end = input.end();
+    auto tar = target.begin();
+    T *g = m_inGrad.ptr();
+    while(inp != end)
     {
-        g = norm * (*inp - *tar);
-        ++inp;
-        ++tar;
-    }, m_inGrad);
+        size_t n = std::min(inp.runLength(), tar.runLength());
+        size_t si = inp.runStride(), st = tar.runStride();
+        const T *x = &*inp, *y = &*tar;
+        for(size_t k = 0; k < n; ++k)
+            g[k] = norm * (x[k * si] - y[k * st]);
+        g += n;
+        inp.advance(n);
+        tar.advance(n);
+    }
 
     return m_inGrad;
 }
@@ -2,7 +2,9 @@
 #define CRTIICS_NLL_TPP
 
 #include "../nll.hpp"
+#include "nnlib/core/fixed_tensor.hpp"
 #include "nnlib/math/math.hpp"
+#include "nnlib/math/reduce.hpp"
 
 namespace nnlib
 {
@@ -33,17 +35,15 @@ size_t NLL<T>::misclassifications(const Tensor<T> &input, const Tensor<T> &targe
     NNAssertEquals(target.dims(), 2, "Expected matrix target!");
     NNAssertEquals(target.size(1), 1, "Expected single-column target!");
 
+    Storage<size_t> predictions;
+    math::argmax(input, predictions, 1);
+
+    const FixedTensor<T, 2> y = target;
     size_t miss = 0;
-    for(size_t i = 0, iend = input.size(0), jend = input.size(1); i < iend; ++i)
+    for(size_t i = 0, iend = input.size(0); i < iend; ++i)
     {
-        NNAssertGreaterThanOrEquals(target(i, 0), 0, "Expected positive target!");
-
-        size_t max = 0;
-        for(size_t j = 1; j < jend; ++j)
-            if(input(i, j) > input(i, max))
-                max = j;
-
-        if(max != target(i, 0))
+        NNAssertGreaterThanOrEquals(y(i, 0), 0, "Expected positive target!");
+        if(predictions[i] != y(i, 0))
             ++miss;
     }
 
@@ -58,13 +58,14 @@ T NLL<T>::forward(const Tensor<T> &input, const Tensor<T> &target)
     NNAssertEquals(target.dims(), 2, "Expected matrix target!");
     NNAssertEquals(target.size(1), 1, "Expected single-column target!");
 
+    const FixedTensor<T, 2> x = input, y = target;
     T sum = 0;
     size_t j;
-    for(size_t i = 0, iend = input.size(0); i < iend; ++i)
+    for(size_t i = 0, iend = x.size(0); i < iend; ++i)
     {
-        NNAssertGreaterThanOrEquals(target(i, 0), 0, "Expected positive target!");
-        j = target(i, 0);
-        sum -= input(i, j);
+        NNAssertGreaterThanOrEquals(y(i, 0), 0, "Expected positive target!");
+        j = y(i, 0);
+        sum -= x(i, j);
     }
 
     if(m_average)
@@ -86,12 +87,14 @@ Tensor<T> &NLL<T>::backward(const Tensor<T> &input, const Tensor<T> &target)
     if(m_average)
         weight /= input.size();
 
+    const FixedTensor<T, 2> y = target;
+    FixedTensor<T, 2> grad = m_inGrad;
     size_t j;
-    for(size_t i = 0, iend = input.size(0); i < iend; ++i)
+    for(size_t i = 0, iend = grad.size(0); i < iend; ++i)
     {
-        NNAssertGreaterThanOrEquals(target(i, 0), 0, "Expected positive target!");
-        j = target(i, 0);
-        m_inGrad(i, j) = weight;
+        NNAssertGreaterThanOrEquals(y(i, 0), 0, "Expected positive target!");
+        j = y(i, 0);
+        grad(i, j) = weight;
     }
 
     return m_inGrad;
@@ -16,6 +16,9 @@ namespace nnlib
 template <typename T>
 class Tensor;
 
+template <typename T>
+class SparseTensor;
+
 namespace math
 {
 
@@ -131,6 +134,22 @@ void mAdd_mmt(const Tensor<T> &A, const Tensor<T> &B, Tensor<T> &C, typename tra
 template <typename T>
 void mAdd_mmt(const Tensor<T> &A, const Tensor<T> &B, Tensor<T> &&C, typename traits::Identity<T>::type alpha = 1, typename traits::Identity<T>::type beta = 1);
 
+/// C = alpha * A * B + beta * C, A sparse; work scales with the nonzeros of A
+template <typename T>
+void mAdd_sm(const SparseTensor<T> &A, const Tensor<T> &B, Tensor<T> &C, typename traits::Identity<T>::type alpha = 1, typename traits::Identity<T>::type beta = 1);
+
+/// C = alpha * A * B + beta * C, A sparse; work scales with the nonzeros of A
+template <typename T>
+void mAdd_sm(const SparseTensor<T> &A, const Tensor<T> &B, Tensor<T> &&C, typename traits::Identity<T>::type alpha = 1, typename traits::Identity<T>::type beta = 1);
+
+/// C = alpha * A^T * B + beta * C, A sparse; with beta = 1, only the rows of C named by columns of A are touched
+template <typename T>
+void mAdd_stm(const SparseTensor<T> &A, const Tensor<T> &B, Tensor<T> &C, typename traits::Identity<T>::type alpha = 1, typename traits::Identity<T>::type beta = 1);
+
+/// C = alpha * A^T * B + beta * C, A sparse; with beta = 1, only the rows of C named by columns of A are touched
+template <typename T>
+void mAdd_stm(const SparseTensor<T> &A, const Tensor<T> &B, Tensor<T> &&C, typename traits::Identity<T>::type alpha = 1, typename traits::Identity<T>::type beta = 1);
+
 #if defined NN_REAL_T && !defined NN_IMPL
     extern template void vFill<NN_REAL_T>(Tensor<NN_REAL_T> &, NN_REAL_T);
     extern template void vFill<NN_REAL_T>(Tensor<NN_REAL_T> &&, NN_REAL_T);
@@ -160,6 +179,10 @@ void mAdd_mmt(const Tensor<T> &A, const Tensor<T> &B, Tensor<T> &&C, typename tr
     extern template void mAdd_mtm<NN_REAL_T>(const Tensor<NN_REAL_T> &, const Tensor<NN_REAL_T> &, Tensor<NN_REAL_T> &&, NN_REAL_T, NN_REAL_T);
     extern template void mAdd_mmt<NN_REAL_T>(const Tensor<NN_REAL_T> &, const Tensor<NN_REAL_T> &, Tensor<NN_REAL_T> &, NN_REAL_T, NN_REAL_T);
     extern template void mAdd_mmt<NN_REAL_T>(const Tensor<NN_REAL_T> &, const Tensor<NN_REAL_T> &, Tensor<NN_REAL_T> &&, NN_REAL_T, NN_REAL_T);
+    extern template void mAdd_sm<NN_REAL_T>(const SparseTensor<NN_REAL_T> &, const Tensor<NN_REAL_T> &, Tensor<NN_REAL_T> &, NN_REAL_T, NN_REAL_T);
+    extern template void mAdd_sm<NN_REAL_T>(const SparseTensor<NN_REAL_T> &, const Tensor<NN_REAL_T> &, Tensor<NN_REAL_T> &&, NN_REAL_T, NN_REAL_T);
+    extern template void mAdd_stm<NN_REAL_T>(const SparseTensor<NN_REAL_T> &, const Tensor<NN_REAL_T> &, Tensor<NN_REAL_T> &, NN_REAL_T, NN_REAL_T);
+    extern template void mAdd_stm<NN_REAL_T>(const SparseTensor<NN_REAL_T> &, const Tensor<NN_REAL_T> &, Tensor<NN_REAL_T> &&, NN_REAL_T, NN_REAL_T);
 #endif
 
 } // namespace math
@@ -0,0 +1,63 @@
+#ifndef MATH_BITMASK_HPP
+#define MATH_BITMASK_HPP
+
+#include "../core/tensor.hpp"
+
+namespace nnlib
+{
+
+/// \brief A mask of bits, one per element, packed into 64-bit words.
+///
+/// This is used for dropout-style masks, which would otherwise be stored as tensors of zeros and ones.
+/// Bits are indexed in the logical (row-major) order of the tensors they are applied to.
+class BitMask
+{
+public:
+    using Word = uint64_t;
+
+    /// Number of bits in one word.
+    static constexpr size_t WordBits = 64;
+
+    inline explicit BitMask(size_t n = 0);
+
+    /// Resize to n bits; the contents are unspecified until the next fill or bernoulli.
+    inline BitMask &resize(size_t n);
+
+    /// Get the number of bits.
+    inline size_t size() const;
+
+    inline bool get(size_t i) const;
+    inline BitMask &set(size_t i, bool value = true);
+
+    /// Set every bit to the given value.
+    inline BitMask &fill(bool value);
+
+    /// \brief Set each bit independently with probability p.
+    ///
+    /// Bits are drawn directly from the calling thread's Philox engine, one 32-bit value per bit,
+    /// without materializing any floating point values.
+    inline BitMask &bernoulli(double p);
+
+    /// Get the number of set bits.
+    inline size_t count() const;
+
+    /// \brief Fused mask-and-scale: y = scale * x where the mask is set and 0 where it is not.
+    ///
+    /// Element i of x (in logical order) is paired with bit offset + i. x and y may be the same tensor.
+    template <typename T>
+    Tensor<T> &apply(const Tensor<T> &x, Tensor<T> &y, T scale = 1, size_t offset = 0) const;
+
+    /// In-place mask-and-scale.
+    template <typename T>
+    Tensor<T> &apply(Tensor<T> &x, T scale = 1, size_t offset = 0) const;
+
+private:
+    Storage<Word> m_words;
+    size_t m_size;
+};
+
+}
+
+#include "detail/bitmask.tpp"
+
+#endif
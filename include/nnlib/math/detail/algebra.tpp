@@ -3,6 +3,7 @@
 
 #include "../algebra.hpp"
 #include "nnlib/core/tensor.hpp"
+#include "nnlib/core/sparse_tensor.hpp"
 #include "nnlib/math/random.hpp"
 
 namespace nnlib
@@ -150,6 +151,88 @@ void mAdd_mmt(const Tensor<T> &_A, const Tensor<T> &_B, Tensor<T> &&_C, typename
     mAdd_mmt(_A, _B, _C, alpha, beta);
 }
 
+template <typename T>
+void mAdd_sm(const SparseTensor<T> &A, const Tensor<T> &_B, Tensor<T> &_C, typename traits::Identity<T>::type alpha, typename traits::Identity<T>::type beta)
+{
+    NNAssertEquals(_B.dims(), 2, "Expected a matrix!");
+    NNAssertEquals(_C.dims(), 2, "Expected a matrix!");
+    NNAssertEquals(A.size(0), _C.size(0), "Incompatible operands!");
+    NNAssertEquals(A.size(1), _B.size(0), "Incompatible operands!");
+    NNAssertEquals(_B.size(1), _C.size(1), "Incompatible operands!");
+    const size_t *offsets = A.offsets().ptr(), *indices = A.indices().ptr();
+    const T *values = A.values().ptr();
+    const T *B = _B.ptr();
+    T *C = _C.ptr();
+    size_t M = _C.size(0), N = _C.size(1);
+    size_t ldb = _B.stride(0), sb = _B.stride(1), ldc = _C.stride(0), sc = _C.stride(1);
+    for(size_t i = 0; i < M; ++i, C += ldc)
+    {
+        if(beta == 0)
+        {
+            for(size_t j = 0; j < N; ++j)
+                C[j * sc] = 0;
+        }
+        else if(beta != 1)
+        {
+            for(size_t j = 0; j < N; ++j)
+                C[j * sc] *= beta;
+        }
+
+        for(size_t k = offsets[i], end = offsets[i + 1]; k < end; ++k)
+        {
+            const T *b = B + indices[k] * ldb;
+            T a = alpha * values[k];
+            for(size_t j = 0; j < N; ++j)
+                C[j * sc] += a * b[j * sb];
+        }
+    }
+}
+
+template <typename T>
+void mAdd_sm(const SparseTensor<T> &A, const Tensor<T> &_B, Tensor<T> &&_C, typename traits::Identity<T>::type alpha, typename traits::Identity<T>::type beta)
+{
+    mAdd_sm(A, _B, _C, alpha, beta);
+}
+
+template <typename T>
+void mAdd_stm(const SparseTensor<T> &A, const Tensor<T> &_B, Tensor<T> &_C, typename traits::Identity<T>::type alpha, typename traits::Identity<T>::type beta)
+{
+    NNAssertEquals(_B.dims(), 2, "Expected a matrix!");
+    NNAssertEquals(_C.dims(), 2, "Expected a matrix!");
+    NNAssertEquals(A.size(1), _C.size(0), "Incompatible operands!");
+    NNAssertEquals(A.size(0), _B.size(0), "Incompatible operands!");
+    NNAssertEquals(_B.size(1), _C.size(1), "Incompatible operands!");
+
+    // scaling C cannot be limited to the nonzeros; beta = 1 skips it
+    if(beta == 0)
+        mFill(_C, 0);
+    else if(beta != 1)
+        mScale(_C, beta);
+
+    const size_t *offsets = A.offsets().ptr(), *indices = A.indices().ptr();
+    const T *values = A.values().ptr();
+    const T *B = _B.ptr();
+    T *C = _C.ptr();
+    size_t M = A.size(0), N = _C.size(1);
+    size_t ldb = _B.stride(0), sb = _B.stride(1), ldc = _C.stride(0), sc = _C.stride(1);
+    for(size_t i = 0; i < M; ++i, B += ldb)
+    {
+        for(size_t k = offsets[i], end = offsets[i + 1]; k < end; ++k)
+        {
+            T *c = C + indices[k] * ldc;
+            T a = alpha * values[k];
+            for(size_t j = 0; j < N; ++j)
+                c[j * sc] += a * B[j * sb];
+        }
+    }
+}
+
+template <typename T>
+void mAdd_stm(const SparseTensor<T> &A, const Tensor<T> &_B, Tensor<T> &&_C, typename traits::Identity<T>::type alpha, typename traits::Identity<T>::type beta)
+{
+    mAdd_stm(A, _B, _C, alpha, beta);
+}
+
 #ifndef NN_ACCEL_CPU
     template <typename T>
     void vScale(Tensor<T> &_x, typename traits::Identity<T>::type alpha)
@@ -0,0 +1,143 @@
+#ifndef MATH_BITMASK_TPP
+#define MATH_BITMASK_TPP
+
+#include "../bitmask.hpp"
+#include "../random.hpp"
+
+namespace nnlib
+{
+
+namespace detail
+{
+    /// The number of set bits in a word.
+    inline size_t popcount(uint64_t w)
+    {
+    #if defined __GNUC__ || defined __clang__
+        return __builtin_popcountll(w);
+    #else
+        // count bits in parallel within pairs, nibbles, and bytes, then sum the bytes
+        w = w - ((w >> 1) & 0x5555555555555555ull);
+        w = (w & 0x3333333333333333ull) + ((w >> 2) & 0x3333333333333333ull);
+        w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0full;
+        return (w * 0x0101010101010101ull) >> 56;
+    #endif
+    }
+}
+
+BitMask::BitMask(size_t n) :
+    m_size(0)
+{
+    resize(n);
+}
+
+BitMask &BitMask::resize(size_t n)
+{
+    m_words.resize((n + WordBits - 1) / WordBits);
+    m_size = n;
+    return *this;
+}
+
+size_t BitMask::size() const
+{
+    return m_size;
+}
+
+bool BitMask::get(size_t i) const
+{
+    NNAssertLessThan(i, m_size, "Index out of bounds!");
+    return (m_words[i / WordBits] >> (i % WordBits)) & 1;
+}
+
+BitMask &BitMask::set(size_t i, bool value)
+{
+    NNAssertLessThan(i, m_size, "Index out of bounds!");
+    Word bit = Word(1) << (i % WordBits);
+    if(value)
+        m_words[i / WordBits] |= bit;
+    else
+        m_words[i / WordBits] &= ~bit;
+    return *this;
+}
+
+BitMask &BitMask::fill(bool value)
+{
+    for(Word &w : m_words)
+        w = value ? ~Word(0) : 0;
+    return *this;
+}
+
+BitMask &BitMask::bernoulli(double p)
+{
+    NNAssertGreaterThanOrEquals(p, 0, "Expected a probability!");
+    NNAssertLessThanOrEquals(p, 1, "Expected a probability!");
+
+    Philox &philox = RandomEngine::threadEngine().philox();
+    uint64_t threshold = static_cast<uint64_t>(p * 4294967296.0);
+    uint32_t values[WordBits];
+
+    for(size_t i = 0, bits = m_size; i < m_words.size(); ++i, bits -= WordBits)
+    {
+        size_t n = bits < WordBits ? bits : size_t(WordBits);
+        philox.generate(values, n);
+
+        Word w = 0;
+        for(size_t j = 0; j < n; ++j)
+            w |= Word(values[j] < threshold) << j;
+        m_words[i] = w;
+    }
+
+    return *this;
+}
+
+size_t BitMask::count() const
+{
+    size_t n = 0;
+    for(size_t i = 0; i < m_words.size(); ++i)
+    {
+        Word w = m_words[i];
+        if(i + 1 == m_words.size() && m_size % WordBits != 0)
+            w &= (Word(1) << (m_size % WordBits)) - 1;
+        n += detail::popcount(w);
+    }
+    return n;
+}
+
+template <typename T>
+Tensor<T> &BitMask::apply(const Tensor<T> &x, Tensor<T> &y, T scale, size_t offset) const
+{
+    NNAssertEquals(x.shape(), y.shape(), "Incompatible operands!");
+    NNAssertLessThanOrEquals(offset + x.size(), m_size, "Mask is too small!");
+
+    if(x.contiguous() && y.contiguous())
+    {
+        const T *src = x.ptr();
+        T *dst = y.ptr();
+        const Word *words = m_words.ptr();
+        for(size_t i = 0, n = x.size(); i < n; ++i)
+        {
+            size_t bit = offset + i;
+            dst[i] = ((words[bit / WordBits] >> (bit % WordBits)) & 1) ? scale * src[i] : T(0);
+        }
+    }
+    else
+    {
+        size_t bit = offset;
+        forEach([&](T x, T &y)
+        {
+            y = ((m_words[bit / WordBits] >> (bit % WordBits)) & 1) ? scale * x : T(0);
+            ++bit;
+        }, x, y);
+    }
+
+    return y;
+}
+
+template <typename T>
+Tensor<T> &BitMask::apply(Tensor<T> &x, T scale, size_t offset) const
+{
+    return apply(static_cast<const Tensor<T> &>(x), x, scale, offset);
+}
+
+}
+
+#endif
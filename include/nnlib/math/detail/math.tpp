@@ -3,6 +3,7 @@
 
 #include "../algebra.hpp"
 #include "../math.hpp"
+#include "../reduce.hpp"
 #include "nnlib/math/random.hpp"
 #include <math.h>
 
@@ -159,15 +160,7 @@ Tensor<T> &sum(const Tensor<T> &x, Tensor<T> &y, size_t dim)
 {
     NNAssertLessThan(dim, x.dims(), "Invalid dimension for summation!");
     NNAssertGreaterThan(x.dims(), 1, "Cannot specify a summing dimension for a vector!");
-    y.copy(x.select(dim, 0));
-    for(size_t i = 1, n = x.size(dim); i < n; ++i)
-    {
-        forEach([&](T x, T &y)
-        {
-            y += x;
-        }, x.select(dim, i), y);
-    }
-    return y;
+    return sum(x, y, Storage<size_t>({ dim }));
 }
 
 template <typename T>
@@ -211,10 +204,10 @@ Tensor<T> square(Tensor<T> &&x)
 template <typename T>
 Tensor<T> &rand(Tensor<T> &x, typename traits::Identity<T>::type min, typename traits::Identity<T>::type max)
 {
-    forEach([&](T &v)
-    {
-        v = Random<T>::sharedRandom().uniform(min, max);
-    }, x);
+    if(x.contiguous())
+        Random<T>::sharedRandom().uniform(x.ptr(), x.size(), min, max);
+    else
+        x.copy(rand(Tensor<T>(x.shape(), true), min, max));
     return x;
 }
 
@@ -227,10 +220,10 @@ Tensor<T> rand(Tensor<T> &&x, typename traits::Identity<T>::type min, typename t
 template <typename T>
 Tensor<T> &randn(Tensor<T> &x, typename traits::Identity<T>::type mean, typename traits::Identity<T>::type stddev)
 {
-    forEach([&](T &v)
-    {
-        v = Random<T>::sharedRandom().normal(mean, stddev);
-    }, x);
+    if(x.contiguous())
+        Random<T>::sharedRandom().normal(x.ptr(), x.size(), mean, stddev);
+    else
+        x.copy(randn(Tensor<T>(x.shape(), true), mean, stddev));
     return x;
 }
 
@@ -243,10 +236,10 @@ Tensor<T> randn(Tensor<T> &&x, typename traits::Identity<T>::type mean, typename
 template <typename T>
 Tensor<T> &randn(Tensor<T> &x, typename traits::Identity<T>::type mean, typename traits::Identity<T>::type stddev, typename traits::Identity<T>::type cap)
 {
-    forEach([&](T &v)
-    {
-        v = Random<T>::sharedRandom().normal(mean, stddev, cap);
-    }, x);
+    if(x.contiguous())
+        Random<T>::sharedRandom().normal(x.ptr(), x.size(), mean, stddev, cap);
+    else
+        x.copy(randn(Tensor<T>(x.shape(), true), mean, stddev, cap));
     return x;
 }
 
@@ -259,10 +252,10 @@ Tensor<T> randn(Tensor<T> &&x, typename traits::Identity<T>::type mean, typename
 template <typename T>
 Tensor<T> &bernoulli(Tensor<T> &x, typename traits::Identity<T>::type p)
 {
-    forEach([&](T &v)
-    {
-        v = Random<T>::sharedRandom().bernoulli(p);
-    }, x);
+    if(x.contiguous())
+        Random<T>::sharedRandom().bernoulli(x.ptr(), x.size(), p);
+    else
+        x.copy(bernoulli(Tensor<T>(x.shape(), true), p));
     return x;
 }
 
@@ -0,0 +1,103 @@
+#ifndef MATH_MATH_EXPRESSION_TPP
+#define MATH_MATH_EXPRESSION_TPP
+
+#include "../math.hpp"
+
+namespace nnlib
+{
+
+namespace math
+{
+
+template <typename T, typename E>
+T min(const TensorExpression<T, E> &x)
+{
+    bool first = true;
+    T value = 0;
+    x.forEach([&](T x)
+    {
+        if(first || x < value)
+            value = x;
+        first = false;
+    });
+    return value;
+}
+
+template <typename T, typename E>
+T max(const TensorExpression<T, E> &x)
+{
+    bool first = true;
+    T value = 0;
+    x.forEach([&](T x)
+    {
+        if(first || x > value)
+            value = x;
+        first = false;
+    });
+    return value;
+}
+
+template <typename T, typename E>
+T sum(const TensorExpression<T, E> &x)
+{
+    T value = 0;
+    x.forEach([&](T x)
+    {
+        value += x;
+    });
+    return value;
+}
+
+template <typename T, typename E>
+T mean(const TensorExpression<T, E> &x)
+{
+    return sum(x) / x.size();
+}
+
+template <typename T, typename E>
+T variance(const TensorExpression<T, E> &x, bool sample)
+{
+    return variance(x.eval(), sample);
+}
+
+template <typename T, typename E>
+Tensor<T> scale(const TensorExpression<T, E> &x, typename traits::Identity<T>::type value)
+{
+    return scale(x.eval(), value);
+}
+
+template <typename T, typename E>
+Tensor<T> add(const TensorExpression<T, E> &x, typename traits::Identity<T>::type value)
+{
+    return add(x.eval(), value);
+}
+
+template <typename T, typename E>
+Tensor<T> diminish(const TensorExpression<T, E> &x, typename traits::Identity<T>::type value)
+{
+    return diminish(x.eval(), value);
+}
+
+template <typename T, typename E>
+Tensor<T> normalize(const TensorExpression<T, E> &x, typename traits::Identity<T>::type from, typename traits::Identity<T>::type to)
+{
+    return normalize(x.eval(), from, to);
+}
+
+template <typename T, typename E>
+Tensor<T> clip(const TensorExpression<T, E> &x, typename traits::Identity<T>::type min, typename traits::Identity<T>::type max)
+{
+    return clip(x.eval(), min, max);
+}
+
+template <typename T, typename E>
+Tensor<T> square(const TensorExpression<T, E> &x)
+{
+    return square(x.eval());
+}
+
+} // namespace math
+
+} // namespace nnlib
+
+#endif
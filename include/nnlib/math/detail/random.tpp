@@ -2,21 +2,150 @@
 #define MATH_RANDOM_TPP
 
 #include "../random.hpp"
+#include <algorithm>
+#include <cmath>
 
 namespace nnlib
 {
 
+namespace detail
+{
+    /// Maps random 32-bit words to a floating point number in [0, 1). Wide types use 53 bits from two words.
+    template <typename T, bool Wide = (sizeof(T) > 4)>
+    struct UnitInterval
+    {
+        static constexpr size_t Words = 2;
+        static T map(const uint32_t *w)
+        {
+            return ((w[0] >> 5) * 67108864.0 + (w[1] >> 6)) * (1.0 / 9007199254740992.0);
+        }
+    };
+
+    /// Maps a random 32-bit word to a floating point number in [0, 1) using 24 bits.
+    template <typename T>
+    struct UnitInterval<T, false>
+    {
+        static constexpr size_t Words = 1;
+        static T map(const uint32_t *w)
+        {
+            return (w[0] >> 8) * (1.0f / 16777216.0f);
+        }
+    };
+}
+
+Philox::Philox(size_t seed, size_t stream)
+{
+    this->seed(seed, stream);
+}
+
+void Philox::seed(size_t seed, size_t stream)
+{
+    m_key[0] = static_cast<uint32_t>(seed);
+    m_key[1] = static_cast<uint32_t>(static_cast<uint64_t>(seed) >> 32);
+    m_counter = 0;
+    m_stream = stream;
+    m_index = BlockSize;
+}
+
+size_t Philox::stream() const
+{
+    return m_stream;
+}
+
+Philox::result_type Philox::operator()()
+{
+    if(m_index == BlockSize)
+    {
+        block(m_counter++, m_buffer);
+        m_index = 0;
+    }
+    return m_buffer[m_index++];
+}
+
+void Philox::discard(unsigned long long n)
+{
+    for(; n > 0 && m_index < BlockSize; --n)
+        ++m_index;
+
+    m_counter += n / BlockSize;
+    n %= BlockSize;
+
+    if(n > 0)
+    {
+        block(m_counter++, m_buffer);
+        m_index = n;
+    }
+}
+
+void Philox::generate(uint32_t *out, size_t n)
+{
+    // use up the current block first so the sequence matches value-at-a-time generation
+    for(; n > 0 && m_index < BlockSize; --n)
+        *out++ = m_buffer[m_index++];
+
+    // whole blocks go straight into the output
+    for(; n >= BlockSize; n -= BlockSize, out += BlockSize)
+        block(m_counter++, out);
+
+    // buffer the last partial block
+    if(n > 0)
+    {
+        block(m_counter++, m_buffer);
+        for(m_index = 0; m_index < n; ++m_index)
+            out[m_index] = m_buffer[m_index];
+    }
+}
+
+void Philox::block(uint64_t counter, uint32_t *out) const
+{
+    uint32_t c0 = static_cast<uint32_t>(counter);
+    uint32_t c1 = static_cast<uint32_t>(counter >> 32);
+    uint32_t c2 = static_cast<uint32_t>(m_stream);
+    uint32_t c3 = static_cast<uint32_t>(m_stream >> 32);
+    uint32_t k0 = m_key[0], k1 = m_key[1];
+
+    for(size_t round = 0; round < 10; ++round)
+    {
+        uint64_t p0 = static_cast<uint64_t>(0xD2511F53) * c0;
+        uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57) * c2;
+        c0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+        c1 = static_cast<uint32_t>(p1);
+        c2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+        c3 = static_cast<uint32_t>(p0);
+        k0 += 0x9E3779B9;
+        k1 += 0xBB67AE85;
+    }
+
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
 RandomEngine::RandomEngine() :
-    m_engine(std::random_device()())
+    RandomEngine(std::random_device()())
 {}
 
 RandomEngine::RandomEngine(size_t seed) :
-    m_engine(seed)
+    m_engine(seed),
+    m_philox(seed)
+{}
+
+RandomEngine::RandomEngine(size_t seed, size_t stream) :
+    m_engine(seed ^ (stream * 0x9E3779B9)),
+    m_philox(seed, stream)
 {}
 
 void RandomEngine::seed(size_t seed)
 {
     m_engine.seed(seed);
+    m_philox.seed(seed);
+}
+
+void RandomEngine::seed(size_t seed, size_t stream)
+{
+    m_engine.seed(seed ^ (stream * 0x9E3779B9));
+    m_philox.seed(seed, stream);
 }
 
 std::default_random_engine &RandomEngine::engine()
@@ -24,27 +153,38 @@ std::default_random_engine &RandomEngine::engine()
     return m_engine;
 }
 
+Philox &RandomEngine::philox()
+{
+    return m_philox;
+}
+
+template <typename T>
+constexpr size_t Random<T>::ChunkSize;
+
 template <typename T>
 Random<T> &Random<T>::sharedRandom()
 {
-    static Random r(&RandomEngine::sharedEngine());
+    static thread_local Random r(&RandomEngine::sharedEngine());
+    r.m_engine = &RandomEngine::threadEngine();
     return r;
 }
 
 template <typename T>
 Random<T>::Random(size_t s) :
-    m_engine(new RandomEngine(s))
+    m_engine(new RandomEngine(s)),
+    m_owned(true)
 {}
 
 template <typename T>
 Random<T>::Random(RandomEngine *engine) :
-    m_engine(engine)
+    m_engine(engine),
+    m_owned(engine != &RandomEngine::sharedEngine())
 {}
 
 template <typename T>
 Random<T>::~Random()
 {
-    if(m_engine != &RandomEngine::sharedEngine())
+    if(m_owned)
         delete m_engine;
 }
 
@@ -110,6 +250,97 @@ T Random<T>::bernoulli(U p)
     return Random<U>::sharedRandom().uniform() < p ? 1 : 0;
 }
 
+template <typename T>
+template <typename U>
+typename std::enable_if<!std::is_integral<U>::value>::type Random<T>::uniform(T *x, size_t n, T from, T to)
+{
+    NNAssertGreaterThan(to, from, "Expected valid range!");
+    using Unit = detail::UnitInterval<T>;
+
+    uint32_t words[ChunkSize];
+    size_t perChunk = ChunkSize / Unit::Words;
+    T range = to - from;
+
+    for(size_t i = 0; i < n; i += perChunk)
+    {
+        size_t count = std::min(n - i, perChunk);
+        m_engine->philox().generate(words, count * Unit::Words);
+        for(size_t j = 0; j < count; ++j)
+            x[i + j] = from + range * Unit::map(words + j * Unit::Words);
+    }
+}
+
+template <typename T>
+template <typename U>
+typename std::enable_if<!std::is_integral<U>::value>::type Random<T>::normal(T *x, size_t n, T mean, T stddev)
+{
+    NNAssertGreaterThan(stddev, 0, "Expected positive standard deviation!");
+    using Unit = detail::UnitInterval<T>;
+
+    uint32_t words[ChunkSize];
+    T radius[ChunkSize / 2], angle[ChunkSize / 2];
+    size_t perChunk = ChunkSize / (2 * Unit::Words);
+    const T twoPi = 6.283185307179586476925286766559;
+
+    for(size_t i = 0; i < n; i += 2 * perChunk)
+    {
+        size_t pairs = std::min((n - i + 1) / 2, perChunk);
+        m_engine->philox().generate(words, 2 * pairs * Unit::Words);
+
+        // map to uniforms in (0, 1] and [0, 1)
+        for(size_t j = 0; j < pairs; ++j)
+        {
+            radius[j] = 1 - Unit::map(words + 2 * j * Unit::Words);
+            angle[j] = twoPi * Unit::map(words + (2 * j + 1) * Unit::Words);
+        }
+
+        // Box-Muller transform
+        for(size_t j = 0; j < pairs; ++j)
+            radius[j] = stddev * sqrt(-2 * log(radius[j]));
+
+        T *y = x + i;
+        for(size_t j = 0, end = std::min(n - i, 2 * pairs) / 2; j < end; ++j)
+        {
+            y[2 * j] = mean + radius[j] * cos(angle[j]);
+            y[2 * j + 1] = mean + radius[j] * sin(angle[j]);
+        }
+
+        // odd number of values; the sine half of the final pair is discarded
+        if(2 * pairs > n - i)
+            y[2 * pairs - 2] = mean + radius[pairs - 1] * cos(angle[pairs - 1]);
+    }
+}
+
+template <typename T>
+template <typename U>
+typename std::enable_if<!std::is_integral<U>::value>::type Random<T>::normal(T *x, size_t n, T mean, T stddev, T cap)
+{
+    normal(x, n, mean, stddev);
+    for(size_t i = 0; i < n; ++i)
+    {
+        while(fabs(x[i] - mean) > cap)
+            normal(x + i, 1, mean, stddev);
+    }
+}
+
+template <typename T>
+void Random<T>::bernoulli(T *x, size_t n, double p)
+{
+    NNAssertGreaterThanOrEquals(p, 0, "Expected a probability!");
+    NNAssertLessThanOrEquals(p, 1, "Expected a probability!");
+
+    uint32_t words[ChunkSize];
+    uint64_t threshold = static_cast<uint64_t>(p * 4294967296.0);
+
+    for(size_t i = 0; i < n; i += ChunkSize)
+    {
+        size_t count = std::min(n - i, static_cast<size_t>(ChunkSize));
+        m_engine->philox().generate(words, count);
+        for(size_t j = 0; j < count; ++j)
+            x[i + j] = words[j] < threshold ? 1 : 0;
+    }
+}
+
 }
 
 #endif
@@ -0,0 +1,466 @@
+#ifndef MATH_REDUCE_TPP
+#define MATH_REDUCE_TPP
+
+#include "../reduce.hpp"
+#include "nnlib/math/vecmath.hpp"
+#include "nnlib/util/parallel.hpp"
+#include <algorithm>
+
+#ifndef NN_MAX_NUM_DIMENSIONS
+#define NN_MAX_NUM_DIMENSIONS 32ul
+#endif
+
+namespace nnlib
+{
+
+namespace math
+{
+
+namespace detail
+{
+    /// \brief The layout of a reduction of one tensor over a set of axes.
+    ///
+    /// Kept axes index the outputs in row-major order; reduced axes are merged where they are
+    /// contiguous with one another and folded for each output.
+    template <typename T>
+    class Reduction
+    {
+    public:
+        /// Elements summed directly before a range is split in half.
+        static const size_t Block = 64;
+
+        /// Outputs accumulated together when the innermost axis is kept.
+        static const size_t Width = 16;
+
+        /// Outputs times elements that each thread of a parallel reduction must have at least.
+        static const size_t Grain = 32768;
+
+        Reduction(const Tensor<T> &x, const Storage<size_t> &axes) :
+            m_x(x),
+            m_ptr(x.ptr()),
+            m_outDims(0),
+            m_redDims(0),
+            m_outputs(1),
+            m_count(1)
+        {
+            size_t dims = x.dims();
+            NNHardAssertLessThanOrEquals(dims, NN_MAX_NUM_DIMENSIONS, "Too many dimensions! Define NN_MAX_NUM_DIMENSIONS to increase this limit.");
+
+            for(size_t d = 0; d < dims; ++d)
+                m_reduced[d] = false;
+
+            for(size_t axis : axes)
+            {
+                NNAssertLessThan(axis, dims, "Invalid axis for reduction!");
+                NNAssert(!m_reduced[axis], "Duplicate axis for reduction!");
+                m_reduced[axis] = true;
+            }
+
+            bool adjacent = false;
+            for(size_t d = 0; d < dims; ++d)
+            {
+                size_t size = x.size(d), stride = x.stride(d);
+                if(m_reduced[d])
+                {
+                    if(size == 1)
+                        continue;
+
+                    if(adjacent && m_redStrides[m_redDims - 1] == stride * size)
+                    {
+                        m_redShape[m_redDims - 1] *= size;
+                        m_redStrides[m_redDims - 1] = stride;
+                    }
+                    else
+                    {
+                        m_redShape[m_redDims] = size;
+                        m_redStrides[m_redDims] = stride;
+                        ++m_redDims;
+                    }
+
+                    m_count *= size;
+                    adjacent = true;
+                }
+                else
+                {
+                    m_outShape[m_outDims] = size;
+                    m_outStrides[m_outDims] = stride;
+                    ++m_outDims;
+
+                    m_outputs *= size;
+                    if(size != 1)
+                        adjacent = false;
+                }
+            }
+
+            if(m_redDims == 0)
+            {
+                m_redShape[0] = 1;
+                m_redStrides[0] = 0;
+                m_redDims = 1;
+            }
+
+            m_strided = m_redDims == 1 && m_outDims > 0 && m_outShape[m_outDims - 1] > 1 && m_outStrides[m_outDims - 1] < m_redStrides[0];
+        }
+
+        size_t outputs() const
+        {
+            return m_outputs;
+        }
+
+        size_t count() const
+        {
+            return m_count;
+        }
+
+        /// Resize y to the output shape, unless it has that shape or the shape of x with reduced axes of size 1.
+        void resize(Tensor<T> &y) const
+        {
+            bool keep = y.dims() == m_x.dims();
+            for(size_t d = 0; keep && d < y.dims(); ++d)
+                keep = y.size(d) == (m_reduced[d] ? 1 : m_x.size(d));
+
+            bool drop = y.dims() == std::max(m_outDims, size_t(1));
+            for(size_t d = 0; drop && d < m_outDims; ++d)
+                drop = y.size(d) == m_outShape[d];
+            if(drop && m_outDims == 0)
+                drop = y.size(0) == 1;
+
+            if(!keep && !drop)
+            {
+                Storage<size_t> shape;
+                for(size_t d = 0; d < m_outDims; ++d)
+                    shape.push(m_outShape[d]);
+                if(shape.size() == 0)
+                    shape.push(1);
+                y.resize(shape);
+            }
+        }
+
+        /// out[o] = finish(sum of map(x - shift[o]), shift[o]); shift may be null (all 0) or alias out.
+        template <typename M, typename F>
+        void sum(T *out, const T *shift, M map, F finish, size_t threads) const
+        {
+            run(threads, [&](size_t begin, size_t end)
+            {
+                if(m_strided)
+                {
+                    size_t inner = m_outShape[m_outDims - 1];
+                    for(size_t o = begin; o < end;)
+                    {
+                        size_t width = std::min(std::min(Width, end - o), inner - o % inner);
+                        T c[Width], s[Width];
+                        for(size_t j = 0; j < width; ++j)
+                            c[j] = shift ? shift[o + j] : 0;
+                        pairwiseRows(m_ptr + offset(o), 0, m_redShape[0], width, c, s, map);
+                        for(size_t j = 0; j < width; ++j)
+                            out[o + j] = finish(s[j], c[j]);
+                        o += width;
+                    }
+                }
+                else
+                {
+                    for(size_t o = begin; o < end; ++o)
+                    {
+                        T c = shift ? shift[o] : 0;
+                        out[o] = finish(pairwise(m_ptr + offset(o), 0, 0, m_redShape[0], c, map), c);
+                    }
+                }
+            });
+        }
+
+        /// out[o] = the element of x for which better(element, others) holds, over the reduced axes.
+        template <typename C>
+        void fold(T *out, C better, size_t threads) const
+        {
+            NNAssertGreaterThan(m_count, 0, "Cannot reduce an empty tensor!");
+            run(threads, [&](size_t begin, size_t end)
+            {
+                if(m_strided)
+                {
+                    size_t inner = m_outShape[m_outDims - 1], step = m_outStrides[m_outDims - 1];
+                    size_t stride = m_redStrides[0], n = m_redShape[0];
+                    for(size_t o = begin; o < end;)
+                    {
+                        size_t width = std::min(std::min(Width, end - o), inner - o % inner);
+                        const T *p = m_ptr + offset(o);
+                        T best[Width];
+                        for(size_t j = 0; j < width; ++j)
+                            best[j] = p[j * step];
+                        for(size_t i = 1; i < n; ++i)
+                        {
+                            const T *row = p + i * stride;
+                            for(size_t j = 0; j < width; ++j)
+                                if(better(row[j * step], best[j]))
+                                    best[j] = row[j * step];
+                        }
+                        for(size_t j = 0; j < width; ++j)
+                            out[o + j] = best[j];
+                        o += width;
+                    }
+                }
+                else
+                {
+                    for(size_t o = begin; o < end; ++o)
+                    {
+                        const T *p = m_ptr + offset(o);
+                        T best = *p;
+                        visit(p, 0, best, better);
+                        out[o] = best;
+                    }
+                }
+            });
+        }
+
+        /// out[o] = the index of the largest element along the single reduced axis.
+        void argmax(size_t *out, size_t threads) const
+        {
+            NNAssertGreaterThan(m_count, 0, "Cannot reduce an empty tensor!");
+            size_t stride = m_redStrides[0], n = m_redShape[0];
+            run(threads, [&](size_t begin, size_t end)
+            {
+                for(size_t o = begin; o < end; ++o)
+                {
+                    const T *p = m_ptr + offset(o);
+                    size_t best = 0;
+                    for(size_t i = 1; i < n; ++i)
+                        if(p[i * stride] > p[best * stride])
+                            best = i;
+                    out[o] = best;
+                }
+            });
+        }
+
+    private:
+        const Tensor<T> &m_x;
+        const T *m_ptr;
+        bool m_reduced[NN_MAX_NUM_DIMENSIONS];
+        size_t m_outDims, m_redDims, m_outputs, m_count;
+        size_t m_outShape[NN_MAX_NUM_DIMENSIONS], m_outStrides[NN_MAX_NUM_DIMENSIONS];
+        size_t m_redShape[NN_MAX_NUM_DIMENSIONS], m_redStrides[NN_MAX_NUM_DIMENSIONS];
+        bool m_strided;
+
+        /// The offset in x of the first element reduced into output o.
+        size_t offset(size_t o) const
+        {
+            size_t result = 0;
+            for(size_t d = m_outDims; d > 0; --d)
+            {
+                result += (o % m_outShape[d - 1]) * m_outStrides[d - 1];
+                o /= m_outShape[d - 1];
+            }
+            return result;
+        }
+
+        /// Pairwise sum of map(x - c) over [begin, end) of the given reduced axis and everything inside it.
+        template <typename M>
+        T pairwise(const T *p, size_t level, size_t begin, size_t end, T c, M map) const
+        {
+            size_t stride = m_redStrides[level];
+            if(end - begin > Block)
+            {
+                size_t mid = begin + (end - begin) / 2;
+                return pairwise(p, level, begin, mid, c, map) + pairwise(p, level, mid, end, c, map);
+            }
+
+            T s = 0;
+            if(level + 1 < m_redDims)
+            {
+                for(size_t i = begin; i < end; ++i)
+                    s += pairwise(p + i * stride, level + 1, 0, m_redShape[level + 1], c, map);
+            }
+            else if(stride == 1)
+            {
+                for(size_t i = begin; i < end; ++i)
+                    s += map(p[i] - c);
+            }
+            else
+            {
+                for(size_t i = begin; i < end; ++i)
+                    s += map(p[i * stride] - c);
+            }
+            return s;
+        }
+
+        /// Pairwise sums of map(x - c[j]) over reduced rows [begin, end) for width adjacent outputs.
+        template <typename M>
+        void pairwiseRows(const T *p, size_t begin, size_t end, size_t width, const T *c, T *out, M map) const
+        {
+            if(end - begin > Block)
+            {
+                size_t mid = begin + (end - begin) / 2;
+                T right[Width];
+                pairwiseRows(p, begin, mid, width, c, out, map);
+                pairwiseRows(p, mid, end, width, c, right, map);
+                for(size_t j = 0; j < width; ++j)
+                    out[j] += right[j];
+                return;
+            }
+
+            size_t stride = m_redStrides[0], step = m_outStrides[m_outDims - 1];
+            for(size_t j = 0; j < width; ++j)
+                out[j] = 0;
+
+            for(size_t i = begin; i < end; ++i)
+            {
+                const T *row = p + i * stride;
+                if(step == 1)
+                {
+                    for(size_t j = 0; j < width; ++j)
+                        out[j] += map(row[j] - c[j]);
+                }
+                else
+                {
+                    for(size_t j = 0; j < width; ++j)
+                        out[j] += map(row[j * step] - c[j]);
+                }
+            }
+        }
+
+        /// Update best with every element of the given reduced axis and everything inside it.
+        template <typename C>
+        void visit(const T *p, size_t level, T &best, C better) const
+        {
+            size_t stride = m_redStrides[level];
+            for(size_t i = 0, n = m_redShape[level]; i < n; ++i)
+            {
+                if(level + 1 < m_redDims)
+                    visit(p + i * stride, level + 1, best, better);
+                else if(better(p[i * stride], best))
+                    best = p[i * stride];
+            }
+        }
+
+        /// Call work(begin, end) over all outputs, split across threads if there is enough work.
+        template <typename W>
+        void run(size_t threads, W work) const
+        {
+            if(threads == 0)
+                threads = hardwareThreads();
+            threads = std::min(threads, std::min(m_outputs / Width, m_outputs * m_count / Grain));
+            if(threads > 1)
+            {
+                parallelForUnseeded(m_outputs, threads, [&](size_t begin, size_t end, size_t)
+                {
+                    work(begin, end);
+                });
+            }
+            else if(m_outputs > 0)
+                work(0, m_outputs);
+        }
+    };
+
+    template <typename T>
+    const size_t Reduction<T>::Block;
+
+    template <typename T>
+    const size_t Reduction<T>::Width;
+
+    template <typename T>
+    const size_t Reduction<T>::Grain;
+
+    /// Call f with a contiguous buffer for the outputs of y, copying into y afterward if y is not contiguous.
+    template <typename T, typename F>
+    Tensor<T> &into(Tensor<T> &y, F f)
+    {
+        if(y.contiguous())
+            f(y.ptr());
+        else
+        {
+            Tensor<T> result(y.shape(), true);
+            f(result.ptr());
+            y.copy(result);
+        }
+        return y;
+    }
+}
+
+template <typename T>
+Tensor<T> &sum(const Tensor<T> &x, Tensor<T> &y, const Storage<size_t> &axes, size_t threads)
+{
+    detail::Reduction<T> reduction(x, axes);
+    reduction.resize(y);
+    return detail::into(y, [&](T *out)
+    {
+        reduction.sum(out, nullptr, [](T x) { return x; }, [](T s, T) { return s; }, threads);
+    });
+}
+
+template <typename T>
+Tensor<T> &mean(const Tensor<T> &x, Tensor<T> &y, const Storage<size_t> &axes, size_t threads)
+{
+    detail::Reduction<T> reduction(x, axes);
+    NNAssertGreaterThan(reduction.count(), 0, "Cannot reduce an empty tensor!");
+    reduction.resize(y);
+
+    T n = reduction.count();
+    return detail::into(y, [&](T *out)
+    {
+        reduction.sum(out, nullptr, [](T x) { return x; }, [&](T s, T) { return s / n; }, threads);
+    });
+}
+
+template <typename T>
+Tensor<T> &variance(const Tensor<T> &x, Tensor<T> &y, const Storage<size_t> &axes, bool sample, size_t threads)
+{
+    detail::Reduction<T> reduction(x, axes);
+    NNAssertGreaterThan(reduction.count(), sample ? 1 : 0, "Not enough elements for variance!");
+    reduction.resize(y);
+
+    T n = reduction.count(), d = reduction.count() - (sample ? 1 : 0);
+    return detail::into(y, [&](T *out)
+    {
+        // the means go into out first and are replaced by the variances, one output at a time
+        reduction.sum(out, nullptr, [](T x) { return x; }, [&](T s, T) { return s / n; }, threads);
+        reduction.sum(out, out, [](T x) { return x * x; }, [&](T s, T) { return s / d; }, threads);
+    });
+}
+
+template <typename T>
+Tensor<T> &max(const Tensor<T> &x, Tensor<T> &y, const Storage<size_t> &axes, size_t threads)
+{
+    detail::Reduction<T> reduction(x, axes);
+    reduction.resize(y);
+    return detail::into(y, [&](T *out)
+    {
+        reduction.fold(out, [](T a, T b) { return a > b; }, threads);
+    });
+}
+
+template <typename T>
+Tensor<T> &min(const Tensor<T> &x, Tensor<T> &y, const Storage<size_t> &axes, size_t threads)
+{
+    detail::Reduction<T> reduction(x, axes);
+    reduction.resize(y);
+    return detail::into(y, [&](T *out)
+    {
+        reduction.fold(out, [](T a, T b) { return a < b; }, threads);
+    });
+}
+
+template <typename T>
+Tensor<T> &logsumexp(const Tensor<T> &x, Tensor<T> &y, const Storage<size_t> &axes, size_t threads)
+{
+    detail::Reduction<T> reduction(x, axes);
+    reduction.resize(y);
+    return detail::into(y, [&](T *out)
+    {
+        // shifting by the maximum keeps every exponent at or below 0
+        reduction.fold(out, [](T a, T b) { return a > b; }, threads);
+        reduction.sum(out, out, [](T x) { return vecmath::exp(x); }, [](T s, T c) { return c + vecmath::log(s); }, threads);
+    });
+}
+
+template <typename T>
+Storage<size_t> &argmax(const Tensor<T> &x, Storage<size_t> &y, size_t axis, size_t threads)
+{
+    detail::Reduction<T> reduction(x, { axis });
+    y.resize(reduction.outputs());
+    reduction.argmax(y.ptr(), threads);
+    return y;
+}
+
+} // namespace math
+
+} // namespace nnlib
+
+#endif
@@ -0,0 +1,453 @@
+#ifndef MATH_VECMATH_TPP
+#define MATH_VECMATH_TPP
+
+#include "../vecmath.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace nnlib
+{
+
+namespace detail
+{
+    /// Bit layout, reduction constants, and polynomials for the vectorizable kernels.
+    template <typename T>
+    struct VecMathTraits;
+
+    template <>
+    struct VecMathTraits<double>
+    {
+        using Bits = uint64_t;
+        using Int = int64_t;
+
+        static constexpr int MantissaBits = 52;
+        static constexpr int ExponentMask = 0x7FF;
+        static constexpr int Bias = 1023;
+        static constexpr int SubnormalShift = 54;
+
+        /// Adding and subtracting 1.5 * 2^52 rounds to the nearest integer, which lands in the low mantissa bits.
+        static constexpr double shifter() { return 6755399441055744.0; }
+        static constexpr double subnormalScale() { return 18014398509481984.0; }
+        static constexpr double minNormal() { return 2.2250738585072014e-308; }
+
+        /// Clamping bounds for exp; beyond these the result is infinity or zero.
+        static constexpr double expMax() { return 710.0; }
+        static constexpr double expMin() { return -746.0; }
+
+        /// Past this, tanh rounds to one.
+        static constexpr double tanhMax() { return 20.0; }
+
+        /// Largest argument for which the three-part reduction by pi / 2 is exact.
+        static constexpr double trigMax() { return 823549.6; }
+
+        static constexpr double log2e() { return 1.4426950408889634; }
+        static constexpr double ln2Hi() { return 6.93147180369123816490e-01; }
+        static constexpr double ln2Lo() { return 1.90821492927058770002e-10; }
+        static constexpr double sqrt2() { return 1.4142135623730951; }
+        static constexpr double twoOverPi() { return 6.36619772367581382433e-01; }
+        static constexpr double pio2Hi() { return 1.57079632673412561417e+00; }
+        static constexpr double pio2Mid() { return 6.07710050630396597660e-11; }
+        static constexpr double pio2Lo() { return 2.02226624879595063154e-21; }
+
+        /// e^r - 1 for |r| <= ln(2) / 2 (Taylor, degree 13).
+        static double expm1Poly(double r)
+        {
+            double q = 1.0 / 6227020800.0;
+            q = q * r + 1.0 / 479001600.0;
+            q = q * r + 1.0 / 39916800.0;
+            q = q * r + 1.0 / 3628800.0;
+            q = q * r + 1.0 / 362880.0;
+            q = q * r + 1.0 / 40320.0;
+            q = q * r + 1.0 / 5040.0;
+            q = q * r + 1.0 / 720.0;
+            q = q * r + 1.0 / 120.0;
+            q = q * r + 1.0 / 24.0;
+            q = q * r + 1.0 / 6.0;
+            q = q * r + 0.5;
+            return r + r * r * q;
+        }
+
+        /// The tail of 2 atanh(s) / s - 2 in terms of z = s^2, for s <= 3 - 2 sqrt(2).
+        static double logPoly(double z)
+        {
+            double q = 2.0 / 21.0;
+            q = q * z + 2.0 / 19.0;
+            q = q * z + 2.0 / 17.0;
+            q = q * z + 2.0 / 15.0;
+            q = q * z + 2.0 / 13.0;
+            q = q * z + 2.0 / 11.0;
+            q = q * z + 2.0 / 9.0;
+            q = q * z + 2.0 / 7.0;
+            q = q * z + 2.0 / 5.0;
+            q = q * z + 2.0 / 3.0;
+            return z * q;
+        }
+
+        /// sin(r) for |r| <= pi / 4, z = r^2.
+        static double sinPoly(double r, double z)
+        {
+            double q = -1.0 / 1307674368000.0;
+            q = q * z + 1.0 / 6227020800.0;
+            q = q * z - 1.0 / 39916800.0;
+            q = q * z + 1.0 / 362880.0;
+            q = q * z - 1.0 / 5040.0;
+            q = q * z + 1.0 / 120.0;
+            q = q * z - 1.0 / 6.0;
+            return r + r * z * q;
+        }
+
+        /// cos(r) - 1 + r^2 / 2 for |r| <= pi / 4, z = r^2.
+        static double cosPoly(double z)
+        {
+            double q = 1.0 / 20922789888000.0;
+            q = q * z - 1.0 / 87178291200.0;
+            q = q * z + 1.0 / 479001600.0;
+            q = q * z - 1.0 / 3628800.0;
+            q = q * z + 1.0 / 40320.0;
+            q = q * z - 1.0 / 720.0;
+            q = q * z + 1.0 / 24.0;
+            return z * z * q;
+        }
+    };
+
+    template <>
+    struct VecMathTraits<float>
+    {
+        using Bits = uint32_t;
+        using Int = int32_t;
+
+        static constexpr int MantissaBits = 23;
+        static constexpr int ExponentMask = 0xFF;
+        static constexpr int Bias = 127;
+        static constexpr int SubnormalShift = 25;
+
+        static constexpr float shifter() { return 12582912.0f; }
+        static constexpr float subnormalScale() { return 33554432.0f; }
+        static constexpr float minNormal() { return 1.17549435e-38f; }
+        static constexpr float expMax() { return 89.0f; }
+        static constexpr float expMin() { return -104.0f; }
+        static constexpr float tanhMax() { return 10.0f; }
+        static constexpr float trigMax() { return 823549.6f; }
+        static constexpr float log2e() { return 1.44269504f; }
+        static constexpr float ln2Hi() { return 0.693145751953125f; }
+        static constexpr float ln2Lo() { return 1.428606765330187045e-06f; }
+        static constexpr float sqrt2() { return 1.41421356f; }
+
+        /// e^r - 1 for |r| <= ln(2) / 2 (Taylor, degree 7).
+        static float expm1Poly(float r)
+        {
+            float q = 1.0f / 5040.0f;
+            q = q * r + 1.0f / 720.0f;
+            q = q * r + 1.0f / 120.0f;
+            q = q * r + 1.0f / 24.0f;
+            q = q * r + 1.0f / 6.0f;
+            q = q * r + 0.5f;
+            return r + r * r * q;
+        }
+
+        static float logPoly(float z)
+        {
+            float q = 2.0f / 11.0f;
+            q = q * z + 2.0f / 9.0f;
+            q = q * z + 2.0f / 7.0f;
+            q = q * z + 2.0f / 5.0f;
+            q = q * z + 2.0f / 3.0f;
+            return z * q;
+        }
+
+        static float sinPoly(float r, float z)
+        {
+            float q = 1.0f / 362880.0f;
+            q = q * z - 1.0f / 5040.0f;
+            q = q * z + 1.0f / 120.0f;
+            q = q * z - 1.0f / 6.0f;
+            return r + r * z * q;
+        }
+
+        static float cosPoly(float z)
+        {
+            float q = 1.0f / 40320.0f;
+            q = q * z - 1.0f / 720.0f;
+            q = q * z + 1.0f / 24.0f;
+            return z * z * q;
+        }
+    };
+
+    /// Fallback kernels for types without polynomial approximations.
+    template <typename T>
+    struct VecMathKernels
+    {
+        static T trigMax() { return std::numeric_limits<T>::infinity(); }
+        static T exp(T x) { return std::exp(x); }
+        static T log(T x) { return std::log(x); }
+        static T tanh(T x) { return std::tanh(x); }
+        static T sigmoid(T x) { return 1 / (1 + std::exp(-x)); }
+        static T sinReduced(T x) { return std::sin(x); }
+        static T cosReduced(T x) { return std::cos(x); }
+    };
+
+    /// Branch-free polynomial kernels; every step is arithmetic, a bit operation, or a select.
+    template <typename T>
+    struct PolyKernels
+    {
+        using Traits = VecMathTraits<T>;
+        using Bits = typename Traits::Bits;
+        using Int = typename Traits::Int;
+
+        static T trigMax()
+        {
+            return Traits::trigMax();
+        }
+
+        static Bits bits(T x)
+        {
+            Bits b;
+            std::memcpy(&b, &x, sizeof(T));
+            return b;
+        }
+
+        static T fromBits(Bits b)
+        {
+            T x;
+            std::memcpy(&x, &b, sizeof(T));
+            return x;
+        }
+
+        /// 2^n for n in the normal exponent range.
+        static T pow2(Int n)
+        {
+            return fromBits((static_cast<Bits>(n) + Traits::Bias) << Traits::MantissaBits);
+        }
+
+        /// Split x into n ln(2) + r with |r| <= ln(2) / 2 (Cody-Waite).
+        static T reduceExp(T x, Int &n)
+        {
+            T k = x * Traits::log2e() + Traits::shifter();
+            n = static_cast<Int>(bits(k) - bits(Traits::shifter()));
+            k -= Traits::shifter();
+            return (x - k * Traits::ln2Hi()) - k * Traits::ln2Lo();
+        }
+
+        static T exp(T x)
+        {
+            x = x > Traits::expMax() ? Traits::expMax() : x;
+            x = x < Traits::expMin() ? Traits::expMin() : x;
+
+            Int n;
+            T p = 1 + Traits::expm1Poly(reduceExp(x, n));
+
+            // scale in two steps so that both overflow and gradual underflow round once
+            Int half = n / 2;
+            return p * pow2(half) * pow2(n - half);
+        }
+
+        /// e^x - 1 for 0 <= x <= 2 tanhMax, accurate near zero.
+        static T expm1(T x)
+        {
+            Int n;
+            T p = Traits::expm1Poly(reduceExp(x, n));
+            T s = pow2(n);
+            return s * p + (s - 1);
+        }
+
+        static T log(T x)
+        {
+            bool subnormal = x < Traits::minNormal();
+            Bits b = bits(subnormal ? x * Traits::subnormalScale() : x);
+            Int e = static_cast<Int>((b >> Traits::MantissaBits) & Traits::ExponentMask) - Traits::Bias;
+            e -= subnormal ? Traits::SubnormalShift : 0;
+
+            // mantissa in [sqrt(2) / 2, sqrt(2))
+            Bits mantissa = b & ((static_cast<Bits>(1) << Traits::MantissaBits) - 1);
+            T m = fromBits(mantissa | (static_cast<Bits>(Traits::Bias) << Traits::MantissaBits));
+            bool high = m > Traits::sqrt2();
+            m = high ? m * T(0.5) : m;
+            e += high ? 1 : 0;
+
+            // log(1 + f) = f - (f^2 / 2 - s (f^2 / 2 + R)) with s = f / (2 + f)
+            T f = m - 1;
+            T s = f / (2 + f);
+            T hfsq = T(0.5) * f * f;
+            T R = Traits::logPoly(s * s);
+            T k = static_cast<T>(e);
+            T y = k * Traits::ln2Hi() - ((hfsq - (s * (hfsq + R) + k * Traits::ln2Lo())) - f);
+
+            y = x > 0 ? y : (x == 0 ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::quiet_NaN());
+            return x == std::numeric_limits<T>::infinity() ? x : y;
+        }
+
+        static T tanh(T x)
+        {
+            T a = std::fabs(x);
+            a = a > Traits::tanhMax() ? Traits::tanhMax() : a;
+            T e = expm1(2 * a);
+            return std::copysign(e / (e + 2), x);
+        }
+
+        static T sigmoid(T x)
+        {
+            // e^-|x| never overflows, so results for large negative x stay accurate down to the subnormals
+            T e = exp(-std::fabs(x));
+            T s = 1 / (1 + e);
+            return x < 0 ? e * s : s;
+        }
+
+        /// Split x into q pi / 2 + r with |r| <= pi / 4 (three-part Cody-Waite); q is taken modulo 2^bits.
+        static T reduceTrig(T x, Bits &q)
+        {
+            T k = x * Traits::twoOverPi() + Traits::shifter();
+            q = bits(k) - bits(Traits::shifter());
+            k -= Traits::shifter();
+            return ((x - k * Traits::pio2Hi()) - k * Traits::pio2Mid()) - k * Traits::pio2Lo();
+        }
+
+        /// sin(x + q pi / 2) for |x| <= trigMax(); the quadrant offset selects sine or cosine.
+        static T sinQuadrant(T x, Bits offset)
+        {
+            // the reduction is always done in double; a float split of pi / 2 loses too much near multiples of it
+            typename VecMathTraits<double>::Bits wide;
+            T r = static_cast<T>(PolyKernels<double>::reduceTrig(x, wide));
+            Bits q = static_cast<Bits>(wide) + offset;
+            T z = r * r;
+
+            T s = Traits::sinPoly(r, z);
+
+            // 1 - z / 2 with the rounding error of the subtraction recovered
+            T hz = T(0.5) * z;
+            T w = 1 - hz;
+            T c = w + (((1 - w) - hz) + Traits::cosPoly(z));
+
+            T y = (q & 1) ? c : s;
+            return (q & 2) ? -y : y;
+        }
+
+        static T sinReduced(T x)
+        {
+            return sinQuadrant(x, 0);
+        }
+
+        static T cosReduced(T x)
+        {
+            return sinQuadrant(x, 1);
+        }
+    };
+
+    template <>
+    struct VecMathKernels<double> : public PolyKernels<double>
+    {};
+
+    template <>
+    struct VecMathKernels<float> : public PolyKernels<float>
+    {};
+
+    /// Apply a reduced-range trigonometric kernel to a span, then redo out-of-range arguments with libm.
+    template <typename T, typename F, typename G>
+    void trigSpan(const T *x, T *y, size_t n, F kernel, G fallback)
+    {
+        constexpr size_t Chunk = 256;
+        T buffer[Chunk];
+        T limit = VecMathKernels<T>::trigMax();
+
+        // buffered a chunk at a time because x and y may alias
+        for(size_t i = 0; i < n; i += Chunk)
+        {
+            size_t count = std::min(n - i, Chunk);
+            for(size_t j = 0; j < count; ++j)
+                buffer[j] = kernel(x[i + j]);
+            for(size_t j = 0; j < count; ++j)
+            {
+                if(!(std::fabs(x[i + j]) <= limit))
+                    buffer[j] = fallback(x[i + j]);
+            }
+            std::copy(buffer, buffer + count, y + i);
+        }
+    }
+}
+
+namespace vecmath
+{
+    template <typename T>
+    T exp(T x)
+    {
+        return detail::VecMathKernels<T>::exp(x);
+    }
+
+    template <typename T>
+    T log(T x)
+    {
+        return detail::VecMathKernels<T>::log(x);
+    }
+
+    template <typename T>
+    T tanh(T x)
+    {
+        return detail::VecMathKernels<T>::tanh(x);
+    }
+
+    template <typename T>
+    T sigmoid(T x)
+    {
+        return detail::VecMathKernels<T>::sigmoid(x);
+    }
+
+    template <typename T>
+    T sin(T x)
+    {
+        using K = detail::VecMathKernels<T>;
+        return std::fabs(x) <= K::trigMax() ? K::sinReduced(x) : std::sin(x);
+    }
+
+    template <typename T>
+    T cos(T x)
+    {
+        using K = detail::VecMathKernels<T>;
+        return std::fabs(x) <= K::trigMax() ? K::cosReduced(x) : std::cos(x);
+    }
+
+    template <typename T>
+    void exp(const T *x, T *y, size_t n)
+    {
+        for(size_t i = 0; i < n; ++i)
+            y[i] = detail::VecMathKernels<T>::exp(x[i]);
+    }
+
+    template <typename T>
+    void log(const T *x, T *y, size_t n)
+    {
+        for(size_t i = 0; i < n; ++i)
+            y[i] = detail::VecMathKernels<T>::log(x[i]);
+    }
+
+    template <typename T>
+    void tanh(const T *x, T *y, size_t n)
+    {
+        for(size_t i = 0; i < n; ++i)
+            y[i] = detail::VecMathKernels<T>::tanh(x[i]);
+    }
+
+    template <typename T>
+    void sigmoid(const T *x, T *y, size_t n)
+    {
+        for(size_t i = 0; i < n; ++i)
+            y[i] = detail::VecMathKernels<T>::sigmoid(x[i]);
+    }
+
+    template <typename T>
+    void sin(const T *x, T *y, size_t n)
+    {
+        detail::trigSpan(x, y, n, &detail::VecMathKernels<T>::sinReduced, [](T a) { return std::sin(a); });
+    }
+
+    template <typename T>
+    void cos(const T *x, T *y, size_t n)
+    {
+        detail::trigSpan(x, y, n, &detail::VecMathKernels<T>::cosReduced, [](T a) { return std::cos(a); });
+    }
+}
+
+}
+
+#endif
@@ -34,6 +34,26 @@ T mean(const Tensor<T> &x);
 template <typename T>
 T variance(const Tensor<T> &x, bool sample = false);
 
+/// Returns the smallest element of an expression, evaluated without a temporary tensor.
+template <typename T, typename E>
+T min(const TensorExpression<T, E> &x);
+
+/// Returns the largest element of an expression, evaluated without a temporary tensor.
+template <typename T, typename E>
+T max(const TensorExpression<T, E> &x);
+
+/// Returns the sum of the elements of an expression, evaluated without a temporary tensor.
+template <typename T, typename E>
+T sum(const TensorExpression<T, E> &x);
+
+/// Returns the average of the elements of an expression, evaluated without a temporary tensor.
+template <typename T, typename E>
+T mean(const TensorExpression<T, E> &x);
+
+/// Returns the variance of the elements of an expression; this evaluates it into a temporary tensor first.
+template <typename T, typename E>
+T variance(const TensorExpression<T, E> &x, bool sample = false);
+
 /// Fill the tensor with the given value.
 template <typename T>
 Tensor<T> &fill(Tensor<T> &x, typename traits::Identity<T>::type value);
@@ -90,6 +110,30 @@ Tensor<T> &square(Tensor<T> &x);
 template <typename T>
 Tensor<T> square(Tensor<T> &&x);
 
+/// Evaluate an expression into a new tensor and scale it by the given value.
+template <typename T, typename E>
+Tensor<T> scale(const TensorExpression<T, E> &x, typename traits::Identity<T>::type value);
+
+/// Evaluate an expression into a new tensor and add the given value to each element.
+template <typename T, typename E>
+Tensor<T> add(const TensorExpression<T, E> &x, typename traits::Identity<T>::type value);
+
+/// Evaluate an expression into a new tensor and diminish it by the given value.
+template <typename T, typename E>
+Tensor<T> diminish(const TensorExpression<T, E> &x, typename traits::Identity<T>::type value);
+
+/// Evaluate an expression into a new tensor and normalize it to lie in [from..to].
+template <typename T, typename E>
+Tensor<T> normalize(const TensorExpression<T, E> &x, typename traits::Identity<T>::type from = 0, typename traits::Identity<T>::type to = 1);
+
+/// Evaluate an expression into a new tensor and cap its elements to lie in [min..max].
+template <typename T, typename E>
+Tensor<T> clip(const TensorExpression<T, E> &x, typename traits::Identity<T>::type min, typename traits::Identity<T>::type max);
+
+/// Evaluate an expression into a new tensor and square each element.
+template <typename T, typename E>
+Tensor<T> square(const TensorExpression<T, E> &x);
+
 /// Fills x with values drawn from a uniform distribution over [min..max].
 template <typename T>
 Tensor<T> &rand(Tensor<T> &x, typename traits::Identity<T>::type min = -1, typename traits::Identity<T>::type max = 1);
@@ -208,4 +252,6 @@ Tensor<T> ones(Ts && ...dims)
     #include "detail/math.tpp"
 #endif
 
+#include "detail/math_expression.tpp"
+
 #endif
@@ -1,12 +1,58 @@
 #ifndef UTIL_RANDOM_HPP
 #define UTIL_RANDOM_HPP
 
+#include <cstdint>
 #include <random>
 #include "../core/error.hpp"
 
 namespace nnlib
 {
 
+/// \brief A counter-based Philox4x32-10 random number generator.
+///
+/// Each call to the underlying bijection maps a 128-bit counter to a block of four random 32-bit integers.
+/// The key is derived from the seed and the upper half of the counter is the stream id,
+/// so each (seed, stream) pair is an independent, reproducible sequence that can be generated a block at a time.
+/// This also satisfies the UniformRandomBitGenerator requirements, so it works with the standard distributions.
+class Philox
+{
+public:
+    using result_type = uint32_t;
+
+    /// Number of 32-bit values produced by one application of the bijection.
+    static constexpr size_t BlockSize = 4;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xFFFFFFFF; }
+
+    explicit inline Philox(size_t seed = 0, size_t stream = 0);
+
+    /// Restart the sequence identified by (seed, stream).
+    inline void seed(size_t seed = 0, size_t stream = 0);
+
+    /// Get the stream id of this generator.
+    inline size_t stream() const;
+
+    /// Get the next random 32-bit value.
+    inline result_type operator()();
+
+    /// Skip the next n values.
+    inline void discard(unsigned long long n);
+
+    /// Fill a buffer with the next n random 32-bit values, generating whole blocks directly into the buffer.
+    inline void generate(uint32_t *out, size_t n);
+
+private:
+    uint32_t m_key[2];           ///< The key, derived from the seed.
+    uint64_t m_counter;          ///< Lower half of the counter; the index of the next block.
+    uint64_t m_stream;           ///< Upper half of the counter; the stream id.
+    uint32_t m_buffer[BlockSize]; ///< The current block, for value-at-a-time generation.
+    size_t m_index;              ///< Index of the next unused value in the buffer.
+
+    /// Apply the bijection to the given counter and write one block to out.
+    inline void block(uint64_t counter, uint32_t *out) const;
+};
+
 class RandomEngine
 {
 public:
@@ -16,20 +62,52 @@ public:
         return e;
     }
 
+    /// \brief Get the engine for the calling thread.
+    ///
+    /// This is the shared engine unless a worker engine has been bound to the thread with bindThreadEngine.
+    static RandomEngine &threadEngine()
+    {
+        RandomEngine *e = boundEngine();
+        return e != nullptr ? *e : sharedEngine();
+    }
+
+    /// Bind an engine to the calling thread (or unbind with nullptr) and return the previously bound engine.
+    static RandomEngine *bindThreadEngine(RandomEngine *engine)
+    {
+        RandomEngine *previous = boundEngine();
+        boundEngine() = engine;
+        return previous;
+    }
+
     inline RandomEngine();
     explicit inline RandomEngine(size_t seed);
 
+    /// Create an engine for one stream of the given seed, i.e. for one worker of a parallel region.
+    inline RandomEngine(size_t seed, size_t stream);
+
     inline void seed(size_t seed = 0);
+    inline void seed(size_t seed, size_t stream);
     inline std::default_random_engine &engine();
 
+    /// Get the counter-based generator used for bulk generation; it is seeded along with engine().
+    inline Philox &philox();
+
 private:
     std::default_random_engine m_engine;
+    Philox m_philox;
+
+    static RandomEngine *&boundEngine()
+    {
+        static thread_local RandomEngine *e = nullptr;
+        return e;
+    }
 };
 
 template <typename T = NN_REAL_T>
 class Random
 {
 public:
+    /// Get the shared generator for the calling thread; it draws from RandomEngine::threadEngine().
     static Random &sharedRandom();
 
     explicit Random(size_t s = 0);
@@ -64,8 +142,27 @@ public:
     template <typename U = double>
     T bernoulli(U p);
 
+    /// Fill a buffer with n floating point numbers from a uniform distribution over [from, to), a block at a time.
+    template <typename U = T>
+    typename std::enable_if<!std::is_integral<U>::value>::type uniform(T *x, size_t n, T from, T to);
+
+    /// Fill a buffer with n floating point numbers from a normal distribution using the Box-Muller transform.
+    template <typename U = T>
+    typename std::enable_if<!std::is_integral<U>::value>::type normal(T *x, size_t n, T mean, T stddev);
+
+    /// Fill a buffer with n floating point numbers from a normal distribution, redrawing any outside [mean-cap, mean+cap].
+    template <typename U = T>
+    typename std::enable_if<!std::is_integral<U>::value>::type normal(T *x, size_t n, T mean, T stddev, T cap);
+
+    /// Fill a buffer with n draws from a Bernoulli distribution with a p probability of a 1.
+    void bernoulli(T *x, size_t n, double p);
+
 private:
+    /// Number of 32-bit values generated per chunk in the bulk methods.
+    static constexpr size_t ChunkSize = 256;
+
     RandomEngine *m_engine;
+    bool m_owned;
 };
 
 }
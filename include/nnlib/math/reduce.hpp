@@ -0,0 +1,68 @@
+#ifndef MATH_REDUCE_HPP
+#define MATH_REDUCE_HPP
+
+#include "../core/tensor.hpp"
+
+/// \brief Reductions of a tensor over any set of axes.
+///
+/// The result y takes the shape of x without the reduced axes (a single element if every axis is
+/// reduced). If y already has the shape of x with the reduced axes set to 1, that shape is kept
+/// instead, so the result broadcasts back against x. Sums use pairwise summation, with contiguous
+/// runs read directly and strided axes walked a block of outputs at a time so that reads stay in
+/// memory order. Large reductions with many outputs are split across up to the given number of
+/// threads (0 for hardwareThreads()). Each output is reduced by one thread, so results do not depend
+/// on the thread count, and reducing never changes the random sequence.
+
+namespace nnlib
+{
+
+namespace math
+{
+
+/// y = the sum of x over the given axes.
+template <typename T>
+Tensor<T> &sum(const Tensor<T> &x, Tensor<T> &y, const Storage<size_t> &axes, size_t threads = 0);
+
+/// y = the average of x over the given axes.
+template <typename T>
+Tensor<T> &mean(const Tensor<T> &x, Tensor<T> &y, const Storage<size_t> &axes, size_t threads = 0);
+
+/// y = the variance of x over the given axes.
+template <typename T>
+Tensor<T> &variance(const Tensor<T> &x, Tensor<T> &y, const Storage<size_t> &axes, bool sample = false, size_t threads = 0);
+
+/// y = the largest element of x over the given axes.
+template <typename T>
+Tensor<T> &max(const Tensor<T> &x, Tensor<T> &y, const Storage<size_t> &axes, size_t threads = 0);
+
+/// y = the smallest element of x over the given axes.
+template <typename T>
+Tensor<T> &min(const Tensor<T> &x, Tensor<T> &y, const Storage<size_t> &axes, size_t threads = 0);
+
+/// y = log(sum(exp(x))) over the given axes, computed without overflow.
+template <typename T>
+Tensor<T> &logsumexp(const Tensor<T> &x, Tensor<T> &y, const Storage<size_t> &axes, size_t threads = 0);
+
+/// y = the index of the largest element of x along the given axis, for every other index in row-major order.
+template <typename T>
+Storage<size_t> &argmax(const Tensor<T> &x, Storage<size_t> &y, size_t axis, size_t threads = 0);
+
+#if defined NN_REAL_T && !defined NN_IMPL
+    extern template Tensor<NN_REAL_T> &sum(const Tensor<NN_REAL_T> &, Tensor<NN_REAL_T> &, const Storage<size_t> &, size_t);
+    extern template Tensor<NN_REAL_T> &mean(const Tensor<NN_REAL_T> &, Tensor<NN_REAL_T> &, const Storage<size_t> &, size_t);
+    extern template Tensor<NN_REAL_T> &variance(const Tensor<NN_REAL_T> &, Tensor<NN_REAL_T> &, const Storage<size_t> &, bool, size_t);
+    extern template Tensor<NN_REAL_T> &max(const Tensor<NN_REAL_T> &, Tensor<NN_REAL_T> &, const Storage<size_t> &, size_t);
+    extern template Tensor<NN_REAL_T> &min(const Tensor<NN_REAL_T> &, Tensor<NN_REAL_T> &, const Storage<size_t> &, size_t);
+    extern template Tensor<NN_REAL_T> &logsumexp(const Tensor<NN_REAL_T> &, Tensor<NN_REAL_T> &, const Storage<size_t> &, size_t);
+    extern template Storage<size_t> &argmax(const Tensor<NN_REAL_T> &, Storage<size_t> &, size_t, size_t);
+#endif
+
+} // namespace math
+
+} // namespace nnlib
+
+#if !defined NN_REAL_T && !defined NN_IMPL
+    #include "detail/reduce.tpp"
+#endif
+
+#endif
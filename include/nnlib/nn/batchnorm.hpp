@@ -15,6 +15,8 @@ void swap(BatchNorm<T> &, BatchNorm<T> &);
 /// \brief Batch normalization.
 ///
 /// Works only on 2D tensors.
+/// Statistics are gathered in a single Welford pass and all kernels walk the batch row by row.
+/// Features can optionally be split into blocks that are processed on separate threads.
 template <typename T = NN_REAL_T>
 class BatchNorm : public Module<T>
 {
@@ -34,6 +36,12 @@ public:
     T momentum() const;
     BatchNorm &momentum(T momentum);
 
+    /// Get the number of threads across which feature blocks are split.
+    size_t threads() const;
+
+    /// Set the number of threads across which feature blocks are split.
+    BatchNorm &threads(size_t threads);
+
     bool isTraining() const;
     virtual void training(bool training = true) override;
 
@@ -45,6 +53,7 @@ public:
 
     virtual Tensor<T> &forward(const Tensor<T> &input) override;
     virtual Tensor<T> &backward(const Tensor<T> &input, const Tensor<T> &outGrad) override;
+    virtual bool backwardUsesOutput() const override;
 
     // MARK: Buffers
 
@@ -68,8 +77,11 @@ private:
     Tensor<T> m_means;   ///< Mean of each input dimension within the batch.
     Tensor<T> m_invStds; ///< Inverted standard deviation of each input dimension within the batch.
 
-    T m_momentum;    ///< How much to update running mean and variance.
-    bool m_training; ///< Whether this module is in training or evaluation mode.
+    Tensor<T> m_workspace; ///< Per-feature scratch space for the fused kernels.
+
+    T m_momentum;     ///< How much to update running mean and variance.
+    bool m_training;  ///< Whether this module is in training or evaluation mode.
+    size_t m_threads; ///< Number of threads across which feature blocks are split.
 };
 
 }
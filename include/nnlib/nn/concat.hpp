@@ -55,6 +55,7 @@ public:
 
     virtual Tensor<T> &forward(const Tensor<T> &input) override;
     virtual Tensor<T> &backward(const Tensor<T> &input, const Tensor<T> &outGrad) override;
+    virtual const Storage<size_t> &prepare(const Storage<size_t> &inputShape) override;
 
 protected:
     using Module<T>::m_output;
@@ -63,6 +64,9 @@ protected:
 
 private:
     size_t m_concatDim;
+
+    /// Replace the output with the concatenation of the components' outputs, which then view into it.
+    void concatenateOutputs();
 };
 
 }
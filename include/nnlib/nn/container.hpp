@@ -31,6 +31,7 @@ public:
     virtual ~Container();
     virtual void training(bool training = true) override;
     virtual void forget() override;
+    virtual void inference(bool inference = true) override;
     virtual void save(Serialized &node) const override;
 
     /// Get a specific component from this container.
@@ -66,6 +67,10 @@ public:
     /// A vector of tensors filled with (views of) each sub-module's internal state.
     virtual Storage<Tensor<T> *> stateList() override;
 
+    /// The touched rows of each sub-module's parameters' gradient, in the same order as gradList().
+    virtual Storage<const Storage<size_t> *> touchedList() override;
+    virtual void clearTouched() override;
+
 protected:
     Storage<Module<T> *> m_components;
 };
@@ -3,6 +3,7 @@
 
 #include "../batchnorm.hpp"
 #include "nnlib/math/math.hpp"
+#include "nnlib/util/parallel.hpp"
 
 namespace nnlib
 {
@@ -18,8 +19,10 @@ BatchNorm<T>::BatchNorm(size_t inps) :
     m_runningVars(inps),
     m_means(inps),
     m_invStds(inps),
+    m_workspace(3, inps),
     m_momentum(0.1),
-    m_training(true)
+    m_training(true),
+    m_threads(1)
 {
     reset();
 }
@@ -35,8 +38,10 @@ BatchNorm<T>::BatchNorm(const BatchNorm<T> &module) :
     m_runningVars(module.m_runningVars.copy()),
     m_means(module.m_means.copy()),
     m_invStds(module.m_invStds.copy()),
+    m_workspace(module.m_workspace.shape(), true),
     m_momentum(module.m_momentum),
-    m_training(module.m_training)
+    m_training(module.m_training),
+    m_threads(module.m_threads)
 {}
 
 template <typename T>
@@ -50,8 +55,10 @@ BatchNorm<T>::BatchNorm(const Serialized &node) :
     m_runningVars(node.get<Tensor<T>>("runningVars")),
     m_means(m_weights.shape(), true),
     m_invStds(m_weights.shape(), true),
+    m_workspace(3, m_weights.size()),
     m_momentum(node.get<T>("momentum")),
-    m_training(node.get<bool>("training"))
+    m_training(node.get<bool>("training")),
+    m_threads(1)
 {
     NNAssertEquals(m_biases.shape(), m_weights.shape(), "Incompatible bias!");
     NNAssertEquals(m_runningMeans.shape(), m_weights.shape(), "Incompatible running means!");
@@ -78,8 +85,10 @@ void swap(BatchNorm<T> &a, BatchNorm<T> &b)
     swap(a.m_biases, b.m_biases);
     swap(a.m_weightsGrad, b.m_weightsGrad);
     swap(a.m_biasesGrad, b.m_biasesGrad);
+    swap(a.m_workspace, b.m_workspace);
     swap(a.m_momentum, b.m_momentum);
     swap(a.m_training, b.m_training);
+    swap(a.m_threads, b.m_threads);
 }
 
 template <typename T>
@@ -118,6 +127,20 @@ BatchNorm<T> &BatchNorm<T>::momentum(T momentum)
     return *this;
 }
 
+template <typename T>
+size_t BatchNorm<T>::threads() const
+{
+    return m_threads;
+}
+
+template <typename T>
+BatchNorm<T> &BatchNorm<T>::threads(size_t threads)
+{
+    NNAssertGreaterThan(threads, 0, "Expected at least one thread!");
+    m_threads = threads;
+    return *this;
+}
+
 template <typename T>
 bool BatchNorm<T>::isTraining() const
 {
@@ -149,87 +172,66 @@ Tensor<T> &BatchNorm<T>::forward(const Tensor<T> &input)
 {
     NNAssertEquals(input.dims(), 2, "Expected matrix input!");
     NNAssertEquals(input.size(1), m_weights.size(), "Incompatible input!");
+    NNAssert(!m_training || input.size(0) > 1, "Expected a batch in training mode!");
     m_output.resize(input.shape());
 
-    size_t n = input.size(0);
-    T norm = 1.0 / n;
-
-    // Get means and variances to use
-    Tensor<T> means, invStds;
-    if(m_training)
-    {
-        NNAssertGreaterThan(input.size(0), 1, "Expected a batch in training mode!");
+    size_t n = input.size(0), inps = input.size(1);
+    size_t is0 = input.stride(0), is1 = input.stride(1);
+    const T *x = input.ptr();
+    T *y = m_output.ptr();
 
-        // Get means
-        math::sum(input, m_means, 0);
-        math::scale(m_means, norm);
+    // per-feature vectors are always contiguous (either owned or views into flattened buffers)
+    const T *w = m_weights.ptr(), *b = m_biases.ptr();
+    T *means = m_means.ptr(), *vars = m_invStds.ptr();
+    T *runningMeans = m_runningMeans.ptr(), *runningVars = m_runningVars.ptr();
+    T *mu = m_training ? means : runningMeans;
+    T *scale = m_workspace.ptr();
 
-        // Get unnormalized variances (temporarily stored in m_invStds)
-        math::fill(m_invStds, 0);
-        for(size_t i = 0; i < n; ++i)
+    parallelForUnseeded(inps, m_threads, [&](size_t begin, size_t end, size_t)
+    {
+        if(m_training)
         {
-            forEach([&](T x, T mean, T &y)
+            // Single-pass Welford statistics, row by row
+            for(size_t f = begin; f < end; ++f)
+                means[f] = vars[f] = 0;
+
+            for(size_t i = 0; i < n; ++i)
             {
-                y += (x - mean) * (x - mean);
-            }, input.select(0, i), m_means, m_invStds);
+                const T *row = x + i * is0;
+                T k = 1.0 / (i + 1);
+                for(size_t f = begin; f < end; ++f)
+                {
+                    T v = row[f * is1];
+                    T delta = v - means[f];
+                    means[f] += delta * k;
+                    vars[f] += delta * (v - means[f]);
+                }
+            }
+
+            // Update running statistics (normalize variance as sample), then normalize variance as population
+            for(size_t f = begin; f < end; ++f)
+            {
+                runningMeans[f] = (1 - m_momentum) * runningMeans[f] + m_momentum * means[f];
+                runningVars[f] = (1 - m_momentum) * runningVars[f] + m_momentum / (n - 1) * vars[f];
+                vars[f] = 1.0 / sqrt(vars[f] / n + 1e-12);
+                scale[f] = vars[f] * w[f];
+            }
         }
-
-        // Update running mean
-        forEach([&](T mean, T &runningMean)
-        {
-            runningMean *= 1 - m_momentum;
-            runningMean += m_momentum * mean;
-        }, m_means, m_runningMeans);
-
-        // Update running variance (normalize as sample)
-        forEach([&](T invStd, T &runningVar)
-        {
-            runningVar *= 1 - m_momentum;
-            runningVar += m_momentum / (n - 1) * invStd;
-        }, m_invStds, m_runningVars);
-
-        // Now normalize variance as population; will invert and sqrt after this if statement
-        math::scale(m_invStds, norm);
-
-        // Use the batch statistics
-        means = m_means;
-        invStds = m_invStds;
-    }
-    else
-    {
-        // Use the running statistics
-        means = m_runningMeans;
-        invStds = m_runningVars.copy();
-    }
-
-    // Turn variance into inverted standard deviation
-    forEach([&](T &invStd)
-    {
-        invStd = 1.0 / sqrt(invStd + 1e-12);
-    }, invStds);
-
-    // Use the statistics to normalize the data row-by-row
-    for(size_t i = 0; i < n; ++i)
-    {
-        Tensor<T> out = m_output.select(0, i);
-
-        // Copy
-        out.copy(input.select(0, i));
-
-        // Normalize
-        forEach([&](T mean, T invStd, T &y)
+        else
         {
-            y -= mean;
-            y *= invStd;
-        }, means, invStds, out);
+            for(size_t f = begin; f < end; ++f)
+                scale[f] = w[f] / sqrt(runningVars[f] + 1e-12);
+        }
 
-        // Rescale and reshift using the parameters
-        forEach([&](T w, T b, T &y)
+        // Fused normalize, scale, and shift
+        for(size_t i = 0; i < n; ++i)
         {
-            y *= w;
-            y += b;
-        }, m_weights, m_biases, out);
-    }
+            const T *in = x + i * is0;
+            T *out = y + i * inps;
+            for(size_t f = begin; f < end; ++f)
+                out[f] = (in[f * is1] - mu[f]) * scale[f] + b[f];
+        }
+    });
 
     return m_output;
 }
@@ -237,71 +239,76 @@ Tensor<T> &BatchNorm<T>::forward(const Tensor<T> &input)
 template <typename T>
 Tensor<T> &BatchNorm<T>::backward(const Tensor<T> &input, const Tensor<T> &outGrad)
 {
+    NNAssert(!this->isInference(), "Cannot backward in inference mode!");
     NNAssertEquals(input.dims(), 2, "Expected matrix input!");
     NNAssertEquals(input.size(1), m_weights.size(), "Incompatible input!");
     NNAssertEquals(input.shape(), outGrad.shape(), "Incompatible outGrad!");
     m_inGrad.resize(input.shape());
 
-    size_t inps = m_inGrad.size(1), bats = m_inGrad.size(0);
+    size_t n = input.size(0), inps = input.size(1);
+    size_t is0 = input.stride(0), is1 = input.stride(1);
+    size_t gs0 = outGrad.stride(0), gs1 = outGrad.stride(1);
+    const T *x = input.ptr(), *g = outGrad.ptr();
+    T *dx = m_inGrad.ptr();
 
-    // Get means and variances to use
-    Tensor<T> means, invStds;
-    if(m_training)
-    {
-        // Use the batch statistics
-        means = m_means;
-        invStds = m_invStds;
-    }
-    else
-    {
-        // Use the running statistics
-        means = m_runningMeans;
-        invStds = m_runningVars.copy();
+    const T *w = m_weights.ptr();
+    T *dw = m_weightsGrad.ptr(), *db = m_biasesGrad.ptr();
+    const T *mu = m_training ? m_means.ptr() : m_runningMeans.ptr();
+    const T *invStds = m_invStds.ptr(), *runningVars = m_runningVars.ptr();
+    T *sums = m_workspace.ptr(), *dots = sums + inps, *scale = dots + inps;
 
-        // Turn variance into inverted standard deviation
-        forEach([&](T &invStd)
-        {
-            invStd = 1.0 / sqrt(invStd + 1e-12);
-        }, invStds);
-    }
-
-    for(size_t i = 0; i < inps; ++i)
+    parallelForUnseeded(inps, m_threads, [&](size_t begin, size_t end, size_t)
     {
-        T sum = 0;
-        for(size_t j = 0; j < bats; ++j)
-            sum += outGrad(j, i);
+        // Per-feature sums of outGrad and of outGrad times the centered input in one sweep
+        for(size_t f = begin; f < end; ++f)
+            sums[f] = dots[f] = 0;
 
-        T dotp = 0;
-        for(size_t j = 0; j < bats; ++j)
-            dotp += (input(j, i) - means(i)) * outGrad(j, i);
+        for(size_t i = 0; i < n; ++i)
+        {
+            const T *in = x + i * is0, *grad = g + i * gs0;
+            for(size_t f = begin; f < end; ++f)
+            {
+                T v = grad[f * gs1];
+                sums[f] += v;
+                dots[f] += (in[f * is1] - mu[f]) * v;
+            }
+        }
 
-        // gradient of inputs
-        if(m_training)
+        // Parameter gradients, then per-feature coefficients for the input gradient
+        for(size_t f = begin; f < end; ++f)
         {
-            T k = dotp * invStds(i) * invStds(i) / bats;
-            for(size_t j = 0; j < bats; ++j)
-                m_inGrad(j, i) = (input(j, i) - means(i)) * k;
+            T invStd = m_training ? invStds[f] : 1.0 / sqrt(runningVars[f] + 1e-12);
+            db[f] += sums[f];
+            dw[f] += dots[f] * invStd;
+            scale[f] = invStd * w[f];
 
-            T gradMean = sum / bats;
-            for(size_t j = 0; j < bats; ++j)
-                m_inGrad(j, i) = (outGrad(j, i) - gradMean - m_inGrad(j, i)) * invStds(i) * m_weights(i);
+            if(m_training)
+            {
+                sums[f] /= n;
+                dots[f] *= invStd * invStd / n;
+            }
+            else
+                sums[f] = dots[f] = 0;
         }
-        else
+
+        for(size_t i = 0; i < n; ++i)
         {
-            for(size_t j = 0; j < bats; ++j)
-                m_inGrad(j, i) = outGrad(j, i) * invStds(i) * m_weights(i);
+            const T *in = x + i * is0, *grad = g + i * gs0;
+            T *out = dx + i * inps;
+            for(size_t f = begin; f < end; ++f)
+                out[f] = (grad[f * gs1] - sums[f] - (in[f * is1] - mu[f]) * dots[f]) * scale[f];
         }
-
-        // gradient of biases
-        m_biasesGrad(i) += sum;
-
-        // gradient of weights
-        m_weightsGrad(i) += dotp * invStds(i);
-    }
+    });
 
     return m_inGrad;
 }
 
+template <typename T>
+bool BatchNorm<T>::backwardUsesOutput() const
+{
+    return false;
+}
+
 template <typename T>
 Storage<Tensor<T> *> BatchNorm<T>::paramsList()
 {
@@ -76,15 +76,13 @@ Module<T> *Concat<T>::remove(size_t index)
 template <typename T>
 Tensor<T> &Concat<T>::forward(const Tensor<T> &input)
 {
-    Storage<Tensor<T> *> outputs(components());
+    // components write straight into the concatenated output unless one of them had to reallocate
+    bool shared = true;
     for(size_t i = 0, count = components(); i < count; ++i)
-        outputs[i] = &m_components[i]->forward(input);
+        shared = m_output.sharedWith(m_components[i]->forward(input)) && shared;
 
-    if(!m_output.sharedWith(outputs))
-    {
-        m_concatDim = std::min(m_concatDim, outputs[0]->dims() - 1);
-        m_output = Tensor<T>::concatenate(outputs, m_concatDim);
-    }
+    if(!shared)
+        concatenateOutputs();
 
     return m_output;
 }
@@ -92,6 +90,7 @@ Tensor<T> &Concat<T>::forward(const Tensor<T> &input)
 template <typename T>
 Tensor<T> &Concat<T>::backward(const Tensor<T> &input, const Tensor<T> &outGrad)
 {
+    NNAssert(!this->isInference(), "Cannot backward in inference mode!");
     size_t offset = 0, stride;
     for(size_t i = 0, count = components(); i < count; ++i)
     {
@@ -112,6 +111,29 @@ Tensor<T> &Concat<T>::backward(const Tensor<T> &input, const Tensor<T> &outGrad)
     return m_inGrad;
 }
 
+template <typename T>
+const Storage<size_t> &Concat<T>::prepare(const Storage<size_t> &inputShape)
+{
+    for(Module<T> *comp : m_components)
+        comp->prepare(inputShape);
+    concatenateOutputs();
+
+    if(!this->isInference())
+        m_inGrad.resize(inputShape);
+
+    return m_output.shape();
+}
+
+template <typename T>
+void Concat<T>::concatenateOutputs()
+{
+    Storage<Tensor<T> *> outputs(components());
+    for(size_t i = 0, count = components(); i < count; ++i)
+        outputs[i] = &m_components[i]->output();
+    m_concatDim = std::min(m_concatDim, outputs[0]->dims() - 1);
+    m_output = Tensor<T>::concatenate(outputs, m_concatDim);
+}
+
 }
 
 #endif
@@ -66,6 +66,14 @@ void Container<T>::forget()
         comp->forget();
 }
 
+template <typename T>
+void Container<T>::inference(bool inference)
+{
+    Module<T>::inference(inference);
+    for(Module<T> *comp : m_components)
+        comp->inference(inference);
+}
+
 template <typename T>
 void Container<T>::save(Serialized &node) const
 {
@@ -136,6 +144,22 @@ Storage<Tensor<T> *> Container<T>::stateList()
     return states;
 }
 
+template <typename T>
+Storage<const Storage<size_t> *> Container<T>::touchedList()
+{
+    Storage<const Storage<size_t> *> touched;
+    for(Module<T> *comp : m_components)
+        touched.append(comp->touchedList());
+    return touched;
+}
+
+template <typename T>
+void Container<T>::clearTouched()
+{
+    for(Module<T> *comp : m_components)
+        comp->clearTouched();
+}
+
 }
 
 #endif
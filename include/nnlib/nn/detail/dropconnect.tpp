@@ -2,7 +2,9 @@
 #define DROPCONNECT_TPP
 
 #include "../dropconnect.hpp"
+#include "nnlib/math/algebra.hpp"
 #include "nnlib/math/math.hpp"
+#include <algorithm>
 
 namespace nnlib
 {
@@ -12,6 +14,7 @@ DropConnect<T>::DropConnect(Module<T> *module, T dropProbability) :
     Module<T>(module->inputShape(), module->outputShape()),
     m_module(module),
     m_dropProbability(dropProbability),
+    m_groupSize(1),
     m_training(true)
 {
     NNAssertGreaterThanOrEquals(dropProbability, 0, "Expected a probability!");
@@ -23,6 +26,7 @@ DropConnect<T>::DropConnect(const DropConnect<T> &module) :
     Module<T>(module),
     m_module(module.m_module->copy()),
     m_dropProbability(module.m_dropProbability),
+    m_groupSize(module.m_groupSize),
     m_training(module.m_training)
 {}
 
@@ -31,6 +35,7 @@ DropConnect<T>::DropConnect(const Serialized &node) :
     Module<T>(node),
     m_module(node.get<Module<T> *>("module")),
     m_dropProbability(node.get<T>("dropProbability")),
+    m_groupSize(node.has("groupSize") ? node.get<size_t>("groupSize") : 1),
     m_training(node.get<bool>("training"))
 {}
 
@@ -54,6 +59,7 @@ void swap(DropConnect<T> &a, DropConnect<T> &b)
     using std::swap;
     swap(a.m_module, b.m_module);
     swap(a.m_dropProbability, b.m_dropProbability);
+    swap(a.m_groupSize, b.m_groupSize);
     swap(a.m_training, b.m_training);
 }
 
@@ -90,6 +96,20 @@ DropConnect<T> &DropConnect<T>::dropProbability(T dropProbability)
     return *this;
 }
 
+template <typename T>
+size_t DropConnect<T>::groupSize() const
+{
+    return m_groupSize;
+}
+
+template <typename T>
+DropConnect<T> &DropConnect<T>::groupSize(size_t groupSize)
+{
+    NNAssertGreaterThan(groupSize, 0, "Expected a positive group size!");
+    m_groupSize = groupSize;
+    return *this;
+}
+
 template <typename T>
 bool DropConnect<T>::isTraining() const
 {
@@ -110,6 +130,13 @@ void DropConnect<T>::forget()
     m_module->forget();
 }
 
+template <typename T>
+void DropConnect<T>::inference(bool inference)
+{
+    Module<T>::inference(inference);
+    m_module->inference(inference);
+}
+
 // MARK: Serialization
 
 template <typename T>
@@ -118,6 +145,7 @@ void DropConnect<T>::save(Serialized &node) const
     Module<T>::save(node);
     node.set("module", m_module);
     node.set("dropProbability", m_dropProbability);
+    node.set("groupSize", m_groupSize);
     node.set("training", m_training);
 }
 
@@ -129,27 +157,38 @@ Tensor<T> &DropConnect<T>::forward(const Tensor<T> &input)
     if(m_training)
     {
         NNAssert(input.dims() == 1 || input.dims() == 2, "Expected a vector or a matrix!");
-        m_backup.resize(m_module->params().size());
-        m_backup.copy(m_module->params());
+        size_t n = m_module->params().size();
 
         if(input.dims() == 1)
         {
-            m_mask.resize(m_module->params().size());
-            math::pointwiseProduct(math::bernoulli(m_mask, 1 - m_dropProbability), m_module->params());
+            m_backup.resize(n);
+            m_backup.copy(m_module->params());
+            m_mask.resize(n);
+            m_mask.bernoulli(1 - m_dropProbability).apply(m_module->params());
             m_output = m_module->forward(input);
             m_module->params().copy(m_backup);
         }
+        else if(m_groupSize == 1 && dynamic_cast<Linear<T> *>(m_module) != nullptr)
+        {
+            m_mask.resize(input.size(0) * n);
+            m_mask.bernoulli(1 - m_dropProbability);
+            forwardLinear(*static_cast<Linear<T> *>(m_module), input);
+        }
         else
         {
-            m_output.resize(input.size(0), 1);
-            m_mask.resize(input.size(0), m_module->params().size());
-            math::bernoulli(m_mask, 1 - m_dropProbability);
-            for(size_t i = 0; i < input.size(0); ++i)
+            size_t batch = input.size(0), groups = (batch + m_groupSize - 1) / m_groupSize;
+            m_backup.resize(n);
+            m_backup.copy(m_module->params());
+            m_output.resize(batch, 1);
+            m_mask.resize(groups * n);
+            m_mask.bernoulli(1 - m_dropProbability);
+            for(size_t i = 0; i < groups; ++i)
             {
-                math::pointwiseProduct(m_backup, m_mask.select(0, i), m_module->params());
-                m_module->forward(input.narrow(0, i));
-                m_output.resizeDim(1, m_module->output().size());
-                m_output.select(0, i).copy(m_module->output());
+                size_t start = i * m_groupSize, size = std::min(m_groupSize, batch - start);
+                m_mask.apply(m_backup, m_module->params(), T(1), i * n);
+                m_module->forward(input.narrow(0, start, size));
+                m_output.resizeDim(1, m_module->output().size(1));
+                m_output.narrow(0, start, size).copy(m_module->output());
             }
             m_module->params().copy(m_backup);
         }
@@ -163,28 +202,41 @@ Tensor<T> &DropConnect<T>::forward(const Tensor<T> &input)
 template <typename T>
 Tensor<T> &DropConnect<T>::backward(const Tensor<T> &input, const Tensor<T> &outGrad)
 {
+    NNAssert(!this->isInference(), "Cannot backward in inference mode!");
     if(m_training)
     {
         NNAssert(input.dims() == 1 || input.dims() == 2, "Expected a vector or a matrix!");
-        m_backup.resize(m_module->params().size());
-        m_backup.copy(m_module->params());
+        size_t n = m_module->params().size();
 
         if(input.dims() == 1)
         {
-            math::pointwiseProduct(m_mask, m_module->params());
+            NNAssertEquals(m_mask.size(), n, "DropConnect<T>::forward must be called first!");
+            m_backup.resize(n);
+            m_backup.copy(m_module->params());
+            m_mask.apply(m_module->params());
             m_inGrad = m_module->backward(input, outGrad);
             m_module->params().copy(m_backup);
         }
+        else if(m_groupSize == 1 && dynamic_cast<Linear<T> *>(m_module) != nullptr)
+        {
+            NNAssertEquals(m_mask.size(), input.size(0) * n, "DropConnect<T>::forward must be called first!");
+            backwardLinear(*static_cast<Linear<T> *>(m_module), input, outGrad);
+        }
         else
         {
-            m_inGrad.resize(input.size(0), 1);
-            for(size_t i = 0; i < input.size(0); ++i)
+            size_t batch = input.size(0), groups = (batch + m_groupSize - 1) / m_groupSize;
+            NNAssertEquals(m_mask.size(), groups * n, "DropConnect<T>::forward must be called first!");
+            m_backup.resize(n);
+            m_backup.copy(m_module->params());
+            m_inGrad.resize(batch, 1);
+            for(size_t i = 0; i < groups; ++i)
             {
-                math::pointwiseProduct(m_backup, m_mask.select(0, i), m_module->params());
-                m_module->backward(input.select(0, i), outGrad.select(0, i));
-                NNAssertEquals(m_module->inGrad().dims(), 1, "Expected a vector!");
-                m_inGrad.resizeDim(1, m_module->inGrad().size());
-                m_inGrad.select(0, i).copy(m_module->inGrad());
+                size_t start = i * m_groupSize, size = std::min(m_groupSize, batch - start);
+                m_mask.apply(m_backup, m_module->params(), T(1), i * n);
+                m_module->backward(input.narrow(0, start, size), outGrad.narrow(0, start, size));
+                NNAssertEquals(m_module->inGrad().dims(), 2, "Expected a matrix!");
+                m_inGrad.resizeDim(1, m_module->inGrad().size(1));
+                m_inGrad.narrow(0, start, size).copy(m_module->inGrad());
             }
             m_module->params().copy(m_backup);
         }
@@ -195,6 +247,97 @@ Tensor<T> &DropConnect<T>::backward(const Tensor<T> &input, const Tensor<T> &out
     return m_inGrad;
 }
 
+template <typename T>
+const Storage<size_t> &DropConnect<T>::prepare(const Storage<size_t> &inputShape)
+{
+    m_module->prepare(inputShape);
+
+    size_t n = m_module->params().size(), batch = inputShape.size() == 2 ? inputShape[0] : 1;
+    m_backup.resize(n);
+    m_mask.resize((batch + m_groupSize - 1) / m_groupSize * n);
+
+    // training writes into buffers of its own, while evaluation shares the decorated module's
+    if(m_training)
+    {
+        if(m_output.sharedWith(m_module->output()))
+            m_output = Tensor<T>();
+        if(m_inGrad.sharedWith(m_module->inGrad()))
+            m_inGrad = Tensor<T>();
+        m_output.resize(m_module->outputShape());
+        if(!this->isInference())
+            m_inGrad.resize(inputShape);
+    }
+    else
+    {
+        m_output = m_module->output();
+        m_inGrad = m_module->inGrad();
+    }
+
+    return m_output.shape();
+}
+
+template <typename T>
+Tensor<T> &DropConnect<T>::forwardLinear(Linear<T> &linear, const Tensor<T> &input)
+{
+    size_t batch = input.size(0), inps = linear.inputs(), outs = linear.outputs();
+    size_t n = inps * outs + (linear.biased() ? outs : 0);
+    NNAssertEquals(input.size(1), inps, "Incompatible input!");
+
+    // mask bits follow the order of params(), weights (row-major) then bias, so one sample's
+    // masked parameters are a single word-wise apply into the backup, viewed as weights and bias
+    const Tensor<T> &params = linear.params();
+    m_backup.resize(n);
+    Tensor<T> weights = m_backup.narrow(0, 0, inps * outs).view(inps, outs);
+    Tensor<T> bias = linear.biased() ? m_backup.narrow(0, inps * outs, outs) : Tensor<T>();
+
+    m_output.resize(batch, outs);
+    for(size_t i = 0; i < batch; ++i)
+    {
+        m_mask.apply(params, m_backup, T(1), i * n);
+        Tensor<T> y = m_output.select(0, i);
+        if(linear.biased())
+            math::vAdd_mtv(weights, input.select(0, i), y.copy(bias));
+        else
+            math::vAdd_mtv(weights, input.select(0, i), y, 1, 0);
+    }
+
+    return m_output;
+}
+
+template <typename T>
+Tensor<T> &DropConnect<T>::backwardLinear(Linear<T> &linear, const Tensor<T> &input, const Tensor<T> &outGrad)
+{
+    size_t batch = input.size(0), inps = linear.inputs(), outs = linear.outputs();
+    size_t n = inps * outs + (linear.biased() ? outs : 0);
+    NNAssertEquals(input.size(1), inps, "Incompatible input!");
+    NNAssertEquals(outGrad.size(0), batch, "Incompatible input and outGrad!");
+    NNAssertEquals(outGrad.size(1), outs, "Incompatible outGrad!");
+
+    const Tensor<T> &params = linear.params();
+    m_backup.resize(n);
+    Tensor<T> weights = m_backup.narrow(0, 0, inps * outs).view(inps, outs);
+
+    m_inGrad.resize(batch, inps);
+    for(size_t i = 0; i < batch; ++i)
+    {
+        m_mask.apply(params, m_backup, T(1), i * n);
+        math::vAdd_mv(weights, outGrad.select(0, i), m_inGrad.select(0, i), 1, 0);
+    }
+
+    // as with the module itself, parameter gradients are taken with respect to the masked parameters
+    Storage<Tensor<T> *> grads = linear.gradList();
+    math::mAdd_mtm(input, outGrad, *grads[0]);
+    if(linear.biased())
+    {
+        forEachBroadcast([&](T g, T &db)
+        {
+            db += g;
+        }, outGrad, *grads[1]);
+    }
+
+    return m_inGrad;
+}
+
 // MARK: Buffers
 
 template <typename T>
@@ -212,7 +355,7 @@ Storage<Tensor<T> *> DropConnect<T>::gradList()
 template <typename T>
 Storage<Tensor<T> *> DropConnect<T>::stateList()
 {
-    return Module<T>::stateList().append(m_module->stateList()).append({ &m_mask, &m_backup });
+    return Module<T>::stateList().append(m_module->stateList()).push(&m_backup);
 }
 
 }
@@ -77,11 +77,11 @@ void Dropout<T>::save(Serialized &node) const
 template <typename T>
 Tensor<T> &Dropout<T>::forward(const Tensor<T> &input)
 {
-    m_mask.resize(input.shape());
+    m_mask.resize(input.size());
     m_output.resize(input.shape());
 
     if(m_training)
-        return math::pointwiseProduct(input, math::bernoulli(m_mask, 1 - m_dropProbability), m_output);
+        return m_mask.bernoulli(1 - m_dropProbability).apply(input, m_output);
     else
         return math::scale(m_output.copy(input), 1 - m_dropProbability);
 }
@@ -89,20 +89,31 @@ Tensor<T> &Dropout<T>::forward(const Tensor<T> &input)
 template <typename T>
 Tensor<T> &Dropout<T>::backward(const Tensor<T> &input, const Tensor<T> &outGrad)
 {
-    NNAssertEquals(input.shape(), m_mask.shape(), "Dropout<T>::forward must be called first!");
+    NNAssert(!this->isInference(), "Cannot backward in inference mode!");
+    NNAssertEquals(input.size(), m_mask.size(), "Dropout<T>::forward must be called first!");
     NNAssertEquals(input.shape(), outGrad.shape(), "Incompatible input and outGrad!");
     m_inGrad.resize(input.shape());
 
     if(m_training)
-        return math::pointwiseProduct(outGrad, m_mask, m_inGrad);
+        return m_mask.apply(outGrad, m_inGrad);
     else
         return math::scale(m_inGrad.copy(outGrad), 1 - m_dropProbability);
 }
 
 template <typename T>
-Storage<Tensor<T> *> Dropout<T>::stateList()
+const Storage<size_t> &Dropout<T>::prepare(const Storage<size_t> &inputShape)
 {
-    return Module<T>::stateList().push(&m_mask);
+    size_t size = 1;
+    for(size_t d : inputShape)
+        size *= d;
+    m_mask.resize(size);
+    return Module<T>::prepare(inputShape);
+}
+
+template <typename T>
+bool Dropout<T>::backwardUsesOutput() const
+{
+    return false;
 }
 
 }
@@ -2,7 +2,7 @@
 #define NN_ELU_TPP
 
 #include "../elu.hpp"
-#include <math.h>
+#include "../../math/vecmath.hpp"
 
 namespace nnlib
 {
@@ -16,20 +16,20 @@ ELU<T>::ELU(T alpha) :
 
 template <typename T>
 ELU<T>::ELU(const ELU<T> &module) :
-    Map<T>(module),
+    StaticMap<ELU<T>, T>(module),
     m_alpha(module.m_alpha)
 {}
 
 template <typename T>
 ELU<T>::ELU(const Serialized &node) :
-    Map<T>(node),
+    StaticMap<ELU<T>, T>(node),
     m_alpha(node.get<T>("alpha"))
 {}
 
 template <typename T>
 ELU<T> &ELU<T>::operator=(const ELU<T> &module)
 {
-    Map<T>::operator=(module);
+    StaticMap<ELU<T>, T>::operator=(module);
     m_alpha = module.m_alpha;
     return *this;
 }
@@ -37,7 +37,7 @@ ELU<T> &ELU<T>::operator=(const ELU<T> &module)
 template <typename T>
 void ELU<T>::save(Serialized &node) const
 {
-    Map<T>::save(node);
+    StaticMap<ELU<T>, T>::save(node);
     node.set("alpha", m_alpha);
 }
 
@@ -56,13 +56,15 @@ ELU<T> &ELU<T>::alpha(T alpha)
 }
 
 template <typename T>
-T ELU<T>::forwardOne(const T &x)
+T ELU<T>::apply(const T &x) const
 {
-    return x > 0 ? x : (m_alpha * (exp(x) - 1));
+    // exp is evaluated on both sides of the select so that span loops have no branches
+    T e = m_alpha * (vecmath::exp(x) - 1);
+    return x > 0 ? x : e;
 }
 
 template <typename T>
-T ELU<T>::backwardOne(const T &x, const T &y)
+T ELU<T>::derivative(const T &x, const T &y) const
 {
     return x > 0 ? 1 : (y + m_alpha);
 }
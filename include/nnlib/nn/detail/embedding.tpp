@@ -0,0 +1,220 @@
+#ifndef NN_EMBEDDING_TPP
+#define NN_EMBEDDING_TPP
+
+#include "../embedding.hpp"
+#include "nnlib/core/fixed_tensor.hpp"
+#include "nnlib/math/math.hpp"
+
+namespace nnlib
+{
+
+template <typename T>
+Embedding<T>::Embedding(size_t entries, size_t features) :
+    Module<T>({ 1, 1 }, { 1, features }),
+    m_weights(entries, features),
+    m_weightsGrad(entries, features),
+    m_isTouched(entries, false)
+{
+    m_touched.reserve(entries);
+    reset();
+}
+
+template <typename T>
+Embedding<T>::Embedding(const Embedding<T> &module) :
+    Module<T>(module),
+    m_weights(module.m_weights.copy()),
+    m_weightsGrad(m_weights.shape(), true),
+    m_isTouched(m_weights.size(0), false)
+{
+    m_touched.reserve(m_weights.size(0));
+}
+
+template <typename T>
+Embedding<T>::Embedding(const Serialized &node) :
+    Module<T>(node),
+    m_weights(node.get<Tensor<T>>("weights")),
+    m_weightsGrad(m_weights.shape(), true)
+{
+    NNAssertEquals(m_weights.dims(), 2, "Expected matrix weights!");
+    m_touched.reserve(m_weights.size(0));
+    m_isTouched.resize(m_weights.size(0), false);
+}
+
+template <typename T>
+Embedding<T> &Embedding<T>::operator=(Embedding<T> module)
+{
+    Module<T>::operator=(module);
+    swap(*this, module);
+    return *this;
+}
+
+template <typename T>
+void swap(Embedding<T> &a, Embedding<T> &b)
+{
+    using std::swap;
+    swap(a.m_weights, b.m_weights);
+    swap(a.m_weightsGrad, b.m_weightsGrad);
+    swap(a.m_touched, b.m_touched);
+    swap(a.m_isTouched, b.m_isTouched);
+}
+
+template <typename T>
+Embedding<T> &Embedding<T>::reset()
+{
+    T dev = 1.0 / sqrt(m_weights.size(1));
+    math::rand(m_weights, -dev, dev);
+    return *this;
+}
+
+template <typename T>
+size_t Embedding<T>::entries() const
+{
+    return m_weights.size(0);
+}
+
+template <typename T>
+size_t Embedding<T>::features() const
+{
+    return m_weights.size(1);
+}
+
+template <typename T>
+Tensor<T> Embedding<T>::weights()
+{
+    return m_weights;
+}
+
+template <typename T>
+const Storage<size_t> &Embedding<T>::touched() const
+{
+    return m_touched;
+}
+
+template <typename T>
+void Embedding<T>::inference(bool inference)
+{
+    Module<T>::inference(inference);
+    clearTouched();
+}
+
+template <typename T>
+void Embedding<T>::save(Serialized &node) const
+{
+    Module<T>::save(node);
+    node.set("weights", m_weights);
+}
+
+template <typename T>
+Tensor<T> &Embedding<T>::forward(const Tensor<T> &input)
+{
+    NNAssertEquals(input.dims(), 2, "Expected matrix input!");
+
+    size_t features = m_weights.size(1);
+    m_output.resize(input.size(0), input.size(1) * features);
+
+    const FixedTensor<T, 2> x = input, w = m_weights;
+    FixedTensor<T, 2> y = m_output;
+    size_t index;
+    for(size_t i = 0, rows = x.size(0); i < rows; ++i)
+    {
+        for(size_t j = 0, cols = x.size(1); j < cols; ++j)
+        {
+            NNAssertGreaterThanOrEquals(x(i, j), 0, "Expected nonnegative index!");
+            index = x(i, j);
+            NNAssertLessThan(index, w.size(0), "Index out of bounds!");
+            for(size_t k = 0; k < features; ++k)
+                y(i, j * features + k) = w(index, k);
+        }
+    }
+
+    return m_output;
+}
+
+template <typename T>
+Tensor<T> &Embedding<T>::backward(const Tensor<T> &input, const Tensor<T> &outGrad)
+{
+    NNAssert(!this->isInference(), "Cannot backward in inference mode!");
+    NNAssertEquals(input.dims(), 2, "Expected matrix input!");
+    NNAssertEquals(outGrad.dims(), 2, "Expected matrix outGrad!");
+
+    size_t features = m_weights.size(1);
+    NNAssertEquals(outGrad.size(0), input.size(0), "Incompatible input and outGrad!");
+    NNAssertEquals(outGrad.size(1), input.size(1) * features, "Incompatible input and outGrad!");
+
+    const FixedTensor<T, 2> x = input, g = outGrad;
+    FixedTensor<T, 2> dw = m_weightsGrad;
+    size_t index;
+    for(size_t i = 0, rows = x.size(0); i < rows; ++i)
+    {
+        for(size_t j = 0, cols = x.size(1); j < cols; ++j)
+        {
+            NNAssertGreaterThanOrEquals(x(i, j), 0, "Expected nonnegative index!");
+            index = x(i, j);
+            NNAssertLessThan(index, dw.size(0), "Index out of bounds!");
+            touch(index);
+            for(size_t k = 0; k < features; ++k)
+                dw(index, k) += g(i, j * features + k);
+        }
+    }
+
+    math::fill(m_inGrad.resize(input.shape()), 0);
+    return m_inGrad;
+}
+
+template <typename T>
+const Storage<size_t> &Embedding<T>::prepare(const Storage<size_t> &inputShape)
+{
+    NNAssertEquals(inputShape.size(), 2, "Expected matrix input!");
+
+    m_output.resize(inputShape[0], inputShape[1] * m_weights.size(1));
+    if(!this->isInference())
+        m_inGrad.resize(inputShape);
+
+    return m_output.shape();
+}
+
+template <typename T>
+bool Embedding<T>::backwardUsesOutput() const
+{
+    return false;
+}
+
+template <typename T>
+Storage<Tensor<T> *> Embedding<T>::paramsList()
+{
+    return { &m_weights };
+}
+
+template <typename T>
+Storage<Tensor<T> *> Embedding<T>::gradList()
+{
+    return { &m_weightsGrad };
+}
+
+template <typename T>
+Storage<const Storage<size_t> *> Embedding<T>::touchedList()
+{
+    return { &m_touched };
+}
+
+template <typename T>
+void Embedding<T>::clearTouched()
+{
+    for(size_t row : m_touched)
+        m_isTouched[row] = false;
+    m_touched.clear();
+}
+
+template <typename T>
+void Embedding<T>::touch(size_t row)
+{
+    if(!m_isTouched[row])
+    {
+        m_isTouched[row] = true;
+        m_touched.push(row);
+    }
+}
+
+}
+
+#endif
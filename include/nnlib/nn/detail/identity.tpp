@@ -7,16 +7,15 @@ namespace nnlib
 {
 
 template <typename T>
-Tensor<T> &Identity<T>::forward(const Tensor<T> &input)
+T Identity<T>::apply(const T &x) const
 {
-    return m_output.resize(input.shape()).copy(input);
+    return x;
 }
 
 template <typename T>
-Tensor<T> &Identity<T>::backward(const Tensor<T> &input, const Tensor<T> &outGrad)
+T Identity<T>::derivative(const T &x, const T &y) const
 {
-    NNAssertEquals(input.shape(), outGrad.shape(), "Incompatible input and outGrad!");
-    return m_inGrad.resize(outGrad.shape()).copy(outGrad);
+    return 1;
 }
 
 }
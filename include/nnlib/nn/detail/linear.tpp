@@ -15,7 +15,8 @@ Linear<T>::Linear(size_t inps, size_t outs, bool bias) :
     m_weightsGrad(inps, outs),
     m_useBias(bias),
     m_bias(bias ? outs : 0),
-    m_biasGrad(bias ? outs : 0)
+    m_biasGrad(bias ? outs : 0),
+    m_rowSparse(false)
 {
     reset();
 }
@@ -27,7 +28,8 @@ Linear<T>::Linear(const Linear<T> &module) :
     m_weightsGrad(m_weights.shape(), true),
     m_useBias(module.m_useBias),
     m_bias(module.m_bias.copy()),
-    m_biasGrad(m_bias.shape(), true)
+    m_biasGrad(m_bias.shape(), true),
+    m_rowSparse(false)
 {}
 
 template <typename T>
@@ -37,7 +39,8 @@ Linear<T>::Linear(const Serialized &node) :
     m_weightsGrad(m_weights.shape(), true),
     m_useBias(node.get<bool>("useBias")),
     m_bias(node.get<Tensor<T>>("bias")),
-    m_biasGrad(m_bias.shape(), true)
+    m_biasGrad(m_bias.shape(), true),
+    m_rowSparse(false)
 {
     NNAssertEquals(m_weights.dims(), 2, "Expected matrix weights!");
     NNAssert(!m_useBias || m_bias.dims() == 1, "Expected vector bias!");
@@ -61,6 +64,9 @@ void swap(Linear<T> &a, Linear<T> &b)
     swap(a.m_useBias, b.m_useBias);
     swap(a.m_bias, b.m_bias);
     swap(a.m_biasGrad, b.m_biasGrad);
+    swap(a.m_touched, b.m_touched);
+    swap(a.m_isTouched, b.m_isTouched);
+    swap(a.m_rowSparse, b.m_rowSparse);
 }
 
 template <typename T>
@@ -133,7 +139,12 @@ Tensor<T> &Linear<T>::forward(const Tensor<T> &input)
         m_output.resize(input.size(0), m_weights.size(1));
         math::mAdd_mm(input, m_weights, m_output, 1, 0);
         if(m_useBias)
-            math::mAdd_vv(math::fill(m_ones.resize(input.size(0)), 1), m_bias, m_output);
+        {
+            forEachBroadcast([&](T b, T &y)
+            {
+                y += b;
+            }, m_bias, m_output);
+        }
     }
 
     return m_output;
@@ -142,8 +153,10 @@ Tensor<T> &Linear<T>::forward(const Tensor<T> &input)
 template <typename T>
 Tensor<T> &Linear<T>::backward(const Tensor<T> &input, const Tensor<T> &outGrad)
 {
+    NNAssert(!this->isInference(), "Cannot backward in inference mode!");
     NNAssertEquals(input.dims(), outGrad.dims(), "Incompatible input and outGrad!");
     NNAssert(input.dims() == 1 || input.dims() == 2, "Expected vector or matrix input!");
+    m_rowSparse = false;
 
     if(input.dims() == 1)
     {
@@ -158,7 +171,12 @@ Tensor<T> &Linear<T>::backward(const Tensor<T> &input, const Tensor<T> &outGrad)
     {
         math::mAdd_mtm(input, outGrad, m_weightsGrad);
         if(m_useBias)
-            math::vAdd_mtv(outGrad, math::fill(m_ones.resize(input.size(0)), 1), m_biasGrad);
+        {
+            forEachBroadcast([&](T g, T &db)
+            {
+                db += g;
+            }, outGrad, m_biasGrad);
+        }
 
         m_inGrad.resize(input.size(0), m_weights.size(0));
         math::mAdd_mmt(outGrad, m_weights, m_inGrad, 1, 0);
@@ -167,6 +185,74 @@ Tensor<T> &Linear<T>::backward(const Tensor<T> &input, const Tensor<T> &outGrad)
     return m_inGrad;
 }
 
+template <typename T>
+Tensor<T> &Linear<T>::forward(const SparseTensor<T> &input)
+{
+    NNAssertEquals(input.size(1), m_weights.size(0), "Incompatible input!");
+
+    m_output.resize(input.size(0), m_weights.size(1));
+    math::mAdd_sm(input, m_weights, m_output, 1, 0);
+    if(m_useBias)
+    {
+        forEachBroadcast([&](T b, T &y)
+        {
+            y += b;
+        }, m_bias, m_output);
+    }
+
+    return m_output;
+}
+
+template <typename T>
+void Linear<T>::backward(const SparseTensor<T> &input, const Tensor<T> &outGrad)
+{
+    NNAssert(!this->isInference(), "Cannot backward in inference mode!");
+    NNAssertEquals(outGrad.dims(), 2, "Expected matrix outGrad!");
+    NNAssertEquals(input.size(0), outGrad.size(0), "Incompatible input and outGrad!");
+
+    math::mAdd_stm(input, outGrad, m_weightsGrad);
+    if(m_isTouched.size() != m_weights.size(0))
+    {
+        m_isTouched.resize(m_weights.size(0), false);
+        m_touched.reserve(m_weights.size(0));
+    }
+    for(size_t row : input.indices())
+    {
+        if(!m_isTouched[row])
+        {
+            m_isTouched[row] = true;
+            m_touched.push(row);
+        }
+    }
+
+    if(m_useBias)
+    {
+        forEachBroadcast([&](T g, T &db)
+        {
+            db += g;
+        }, outGrad, m_biasGrad);
+    }
+}
+
+template <typename T>
+const Storage<size_t> &Linear<T>::prepare(const Storage<size_t> &inputShape)
+{
+    NNAssertEquals(inputShape.size(), 2, "Expected matrix input!");
+    NNAssertEquals(inputShape[1], m_weights.size(0), "Incompatible input shape!");
+
+    m_output.resize(inputShape[0], m_weights.size(1));
+    if(!this->isInference())
+        m_inGrad.resize(inputShape);
+
+    return m_output.shape();
+}
+
+template <typename T>
+bool Linear<T>::backwardUsesOutput() const
+{
+    return false;
+}
+
 template <typename T>
 Storage<Tensor<T> *> Linear<T>::paramsList()
 {
@@ -185,6 +271,25 @@ Storage<Tensor<T> *> Linear<T>::gradList()
         return { &m_weightsGrad };
 }
 
+template <typename T>
+Storage<const Storage<size_t> *> Linear<T>::touchedList()
+{
+    const Storage<size_t> *weights = m_rowSparse ? &m_touched : nullptr;
+    if(m_useBias)
+        return { weights, nullptr };
+    else
+        return { weights };
+}
+
+template <typename T>
+void Linear<T>::clearTouched()
+{
+    for(size_t row : m_touched)
+        m_isTouched[row] = false;
+    m_touched.clear();
+    m_rowSparse = true;
+}
+
 }
 
 #endif
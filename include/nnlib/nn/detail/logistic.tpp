@@ -2,23 +2,29 @@
 #define NN_LOGISTIC_TPP
 
 #include "../logistic.hpp"
-#include <math.h>
+#include "../../math/vecmath.hpp"
 
 namespace nnlib
 {
 
 template <typename T>
-T Logistic<T>::forwardOne(const T &x)
+T Logistic<T>::apply(const T &x) const
 {
-    return 1.0 / (1.0 + exp(-x));
+    return vecmath::sigmoid(x);
 }
 
 template <typename T>
-T Logistic<T>::backwardOne(const T &x, const T &y)
+T Logistic<T>::derivative(const T &x, const T &y) const
 {
     return y * (1.0 - y);
 }
 
+template <typename T>
+bool Logistic<T>::outputGradient() const
+{
+    return true;
+}
+
 }
 
 #endif
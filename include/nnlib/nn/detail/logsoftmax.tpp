@@ -2,7 +2,8 @@
 #define NN_LOG_SOFT_MAX_TPP
 
 #include "../logsoftmax.hpp"
-#include "nnlib/math/math.hpp"
+#include "nnlib/math/reduce.hpp"
+#include "nnlib/math/vecmath.hpp"
 
 namespace nnlib
 {
@@ -12,21 +13,30 @@ LogSoftMax<T>::LogSoftMax() :
     Module<T>({ 1, 1 })
 {}
 
+template <typename T>
+LogSoftMax<T>::LogSoftMax(const LogSoftMax<T> &module) :
+    Module<T>(module)
+{}
+
+template <typename T>
+LogSoftMax<T> &LogSoftMax<T>::operator=(const LogSoftMax<T> &module)
+{
+    Module<T>::operator=(module);
+    return *this;
+}
+
 template <typename T>
 Tensor<T> &LogSoftMax<T>::forward(const Tensor<T> &input)
 {
     NNAssertEquals(input.dims(), 2, "Expected matrix input!");
     m_output.resize(input.shape());
+    m_rows.resize(input.size(0), 1);
 
-    for(size_t i = 0, iend = input.size(0); i < iend; ++i)
+    math::logsumexp(input, m_rows, m_features);
+    forEachBroadcast([](T x, T lse, T &y)
     {
-        T max = math::max(input.narrow(0, i)), sum = 0;
-        for(size_t j = 0, jend = input.size(1); j < jend; ++j)
-            sum += exp(input(i, j) - max);
-        sum = max + log(sum);
-        for(size_t j = 0, jend = input.size(1); j < jend; ++j)
-            m_output(i, j) = input(i, j) - sum;
-    }
+        y = x - lse;
+    }, input, m_rows, m_output);
 
     return m_output;
 }
@@ -34,21 +44,30 @@ Tensor<T> &LogSoftMax<T>::forward(const Tensor<T> &input)
 template <typename T>
 Tensor<T> &LogSoftMax<T>::backward(const Tensor<T> &input, const Tensor<T> &outGrad)
 {
+    NNAssert(!this->isInference(), "Cannot backward in inference mode!");
     NNAssertEquals(input.dims(), 2, "Expected matrix input!");
     NNAssertEquals(input.shape(), m_output.shape(), "LogSoftMax::forward must be called first!");
     NNAssertEquals(input.shape(), outGrad.shape(), "Incompatible input and outGrad!");
     m_inGrad.resize(input.shape());
+    m_rows.resize(input.size(0), 1);
 
-    for(size_t i = 0, iend = input.size(0); i < iend; ++i)
+    math::sum(outGrad, m_rows, m_features);
+    forEachBroadcast([](T g, T y, T sum, T &dx)
     {
-        T sum = math::sum(outGrad.narrow(0, i));
-        for(size_t j = 0, jend = input.size(1); j < jend; ++j)
-            m_inGrad(i, j) = outGrad(i, j) - exp(m_output(i, j)) * sum;
-    }
+        dx = g - vecmath::exp(y) * sum;
+    }, outGrad, m_output, m_rows, m_inGrad);
 
     return m_inGrad;
 }
 
+template <typename T>
+const Storage<size_t> &LogSoftMax<T>::prepare(const Storage<size_t> &inputShape)
+{
+    NNAssertEquals(inputShape.size(), 2, "Expected matrix input!");
+    m_rows.resize(inputShape[0], 1);
+    return Module<T>::prepare(inputShape);
+}
+
 }
 
 #endif
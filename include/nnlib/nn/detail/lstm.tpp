@@ -176,6 +176,26 @@ void LSTM<T>::forget()
     math::fill(m_stateGrad, 0);
 }
 
+template <typename T>
+void LSTM<T>::inference(bool inference)
+{
+    Module<T>::inference(inference);
+    for(Module<T> *m : { m_inpGateX, m_inpGateY, m_inpGateH, m_inpGate, m_fgtGateX, m_fgtGateY, m_fgtGateH, m_fgtGate,
+        m_inpModX, m_inpModY, m_inpMod, m_outGateX, m_outGateY, m_outGateH, m_outGate, m_outMod })
+        m->inference(inference);
+
+    // copies and buffers that only backward uses; forward and backward resize them as needed
+    if(inference)
+    {
+        m_prevState = Tensor<T>();
+        m_prevOutput = Tensor<T>();
+        m_outGrad = Tensor<T>();
+        m_stateGrad = Tensor<T>();
+        m_curStateGrad = Tensor<T>();
+        m_gradBuffer = Tensor<T>();
+    }
+}
+
 template <typename T>
 void LSTM<T>::save(Serialized &node) const
 {
@@ -206,42 +226,49 @@ Tensor<T> &LSTM<T>::forward(const Tensor<T> &input)
     NNAssertEquals(input.dims(), 2, "Expected a matrix!");
 
     m_state.resize(input.size(0), m_outs);
-    m_prevState.resize(input.size(0), m_outs);
-    m_prevState.copy(m_state);
-
     m_output.resize(input.size(0), m_outs);
-    m_prevOutput.resize(input.size(0), m_outs);
-    m_prevOutput.copy(m_output);
+
+    // backward needs copies of the previous state and output; inference reads them before they are overwritten
+    const Tensor<T> *prevState = &m_state, *prevOutput = &m_output;
+    if(!this->isInference())
+    {
+        m_prevState.resize(input.size(0), m_outs);
+        m_prevState.copy(m_state);
+        m_prevOutput.resize(input.size(0), m_outs);
+        m_prevOutput.copy(m_output);
+        prevState = &m_prevState;
+        prevOutput = &m_prevOutput;
+    }
 
     // input gate
     m_inpGateX->forward(input);
-    math::mAdd_m(m_inpGateY->forward(m_prevOutput), m_inpGateX->output());
-    math::mAdd_m(m_inpGateH->forward(m_prevState), m_inpGateX->output());
+    math::mAdd_m(m_inpGateY->forward(*prevOutput), m_inpGateX->output());
+    math::mAdd_m(m_inpGateH->forward(*prevState), m_inpGateX->output());
     m_inpGate->forward(m_inpGateX->output());
 
     // forget gate
     m_fgtGateX->forward(input);
-    math::mAdd_m(m_fgtGateY->forward(m_prevOutput), m_fgtGateX->output());
-    math::mAdd_m(m_fgtGateH->forward(m_prevState), m_fgtGateX->output());
+    math::mAdd_m(m_fgtGateY->forward(*prevOutput), m_fgtGateX->output());
+    math::mAdd_m(m_fgtGateH->forward(*prevState), m_fgtGateX->output());
     m_fgtGate->forward(m_fgtGateX->output());
 
     // input value
     m_inpModX->forward(input);
-    math::mAdd_m(m_inpModY->forward(m_prevOutput), m_inpModX->output());
+    math::mAdd_m(m_inpModY->forward(*prevOutput), m_inpModX->output());
     m_inpMod->forward(m_inpModX->output());
 
     // update memory cell (hidden state)
     m_inpAdd.resize(m_inpGate->output().shape());
     m_fgtAdd.resize(m_fgtGate->output().shape());
     math::pointwiseProduct(m_inpGate->output(), m_inpMod->output(), m_inpAdd);
-    math::pointwiseProduct(m_fgtGate->output(), m_prevState, m_fgtAdd);
+    math::pointwiseProduct(m_fgtGate->output(), *prevState, m_fgtAdd);
     math::mAdd_m(m_inpAdd, m_state, 1, 0);
     math::mAdd_m(m_fgtAdd, m_state);
     m_outMod->forward(m_state);
 
     // output gate
     m_outGateX->forward(input);
-    math::mAdd_m(m_outGateY->forward(m_prevOutput), m_outGateX->output());
+    math::mAdd_m(m_outGateY->forward(*prevOutput), m_outGateX->output());
     math::mAdd_m(m_outGateH->forward(m_state), m_outGateX->output());
     m_outGate->forward(m_outGateX->output());
 
@@ -252,6 +279,7 @@ Tensor<T> &LSTM<T>::forward(const Tensor<T> &input)
 template <typename T>
 Tensor<T> &LSTM<T>::backward(const Tensor<T> &input, const Tensor<T> &outGrad)
 {
+    NNAssert(!this->isInference(), "Cannot backward in inference mode!");
     NNAssertEquals(input.dims(), 2, "Expected a matrix!");
     NNAssertEquals(outGrad.dims(), 2, "Expected a matrix!");
     NNAssertEquals(input.size(0), outGrad.size(0), "Incompatible input and outGrad!");
@@ -308,6 +336,48 @@ Tensor<T> &LSTM<T>::backward(const Tensor<T> &input, const Tensor<T> &outGrad)
     return m_inGrad;
 }
 
+template <typename T>
+const Storage<size_t> &LSTM<T>::prepare(const Storage<size_t> &inputShape)
+{
+    NNAssertEquals(inputShape.size(), 2, "Expected matrix input!");
+    Storage<size_t> hiddenShape = { inputShape[0], m_outs };
+
+    m_inpGateX->prepare(inputShape);
+    m_inpGateY->prepare(hiddenShape);
+    m_inpGateH->prepare(hiddenShape);
+    m_inpGate->prepare(hiddenShape);
+    m_fgtGateX->prepare(inputShape);
+    m_fgtGateY->prepare(hiddenShape);
+    m_fgtGateH->prepare(hiddenShape);
+    m_fgtGate->prepare(hiddenShape);
+    m_inpModX->prepare(inputShape);
+    m_inpModY->prepare(hiddenShape);
+    m_inpMod->prepare(hiddenShape);
+    m_outGateX->prepare(inputShape);
+    m_outGateY->prepare(hiddenShape);
+    m_outGateH->prepare(hiddenShape);
+    m_outGate->prepare(hiddenShape);
+    m_outMod->prepare(hiddenShape);
+
+    m_state.resize(hiddenShape);
+    m_output.resize(hiddenShape);
+    m_inpAdd.resize(hiddenShape);
+    m_fgtAdd.resize(hiddenShape);
+
+    if(!this->isInference())
+    {
+        m_prevState.resize(hiddenShape);
+        m_prevOutput.resize(hiddenShape);
+        m_outGrad.resize(hiddenShape);
+        m_stateGrad.resize(hiddenShape);
+        m_curStateGrad.resize(hiddenShape);
+        m_gradBuffer.resize(hiddenShape);
+        m_inGrad.resize(inputShape);
+    }
+
+    return m_output.shape();
+}
+
 template <typename T>
 Storage<Tensor<T> *> LSTM<T>::paramsList()
 {
@@ -374,7 +444,10 @@ Storage<Tensor<T> *> LSTM<T>::stateList()
     list.append(m_outGateH->stateList());
     list.append(m_outGate->stateList());
     list.append(m_outMod->stateList());
-    return list.append({ &m_state, &m_prevState, &m_prevOutput });
+    list.push(&m_state);
+    if(!this->isInference())
+        list.append({ &m_prevState, &m_prevOutput });
+    return list;
 }
 
 }
@@ -6,10 +6,68 @@
 namespace nnlib
 {
 
+template <typename T>
+Map<T>::Map() :
+    Module<T>()
+{}
+
+template <typename T>
+Map<T>::Map(const Map<T> &module) :
+    Module<T>(module),
+    m_inPlace(module.m_inPlace)
+{}
+
+template <typename T>
+Map<T>::Map(const Serialized &node) :
+    Module<T>(node),
+    m_inPlace(node.has("inPlace") ? node.get<bool>("inPlace") : false)
+{}
+
+template <typename T>
+Map<T> &Map<T>::operator=(const Map<T> &module)
+{
+    // detach an output that is a view of an in-place input before it is resized
+    resizeOutput(module.outputShape());
+    Module<T>::operator=(module);
+    m_inPlace = module.m_inPlace;
+    return *this;
+}
+
+template <typename T>
+void Map<T>::save(Serialized &node) const
+{
+    Module<T>::save(node);
+
+    // only written when set, so activations in the default mode serialize as they always have
+    if(m_inPlace)
+        node.set("inPlace", true);
+}
+
+template <typename T>
+void Map<T>::forwardSpan(const T *x, T *y, size_t n)
+{
+    for(size_t i = 0; i < n; ++i)
+        y[i] = forwardOne(x[i]);
+}
+
+template <typename T>
+void Map<T>::backwardSpan(const T *x, const T *y, const T *outGrad, T *inGrad, size_t n)
+{
+    for(size_t i = 0; i < n; ++i)
+        inGrad[i] = outGrad[i] * backwardOne(x[i], y[i]);
+}
+
 template <typename T>
 Tensor<T> &Map<T>::forward(const Tensor<T> &input)
 {
-    m_output.resize(input.shape());
+    resizeOutput(input.shape());
+
+    if(input.contiguous() && m_output.contiguous())
+    {
+        forwardSpan(input.ptr(), m_output.ptr(), input.size());
+        return m_output;
+    }
+
     forEach([&](const T &x, T &y)
     {
         y = forwardOne(x);
@@ -20,8 +78,16 @@ Tensor<T> &Map<T>::forward(const Tensor<T> &input)
 template <typename T>
 Tensor<T> &Map<T>::backward(const Tensor<T> &input, const Tensor<T> &outGrad)
 {
+    NNAssert(!this->isInference(), "Cannot backward in inference mode!");
     NNAssertEquals(input.shape(), outGrad.shape(), "Incompatible input and outGrad!");
     m_inGrad.resize(input.shape());
+
+    if(input.contiguous() && m_output.contiguous() && outGrad.contiguous() && m_inGrad.contiguous())
+    {
+        backwardSpan(input.ptr(), m_output.ptr(), outGrad.ptr(), m_inGrad.ptr(), input.size());
+        return m_inGrad;
+    }
+
     forEach([&](const T &x, const T &y, const T &w, T &z)
     {
         z = w * backwardOne(x, y);
@@ -29,6 +95,64 @@ Tensor<T> &Map<T>::backward(const Tensor<T> &input, const Tensor<T> &outGrad)
     return m_inGrad;
 }
 
+template <typename T>
+const Storage<size_t> &Map<T>::prepare(const Storage<size_t> &inputShape)
+{
+    resizeOutput(inputShape);
+    if(!this->isInference())
+        m_inGrad.resize(inputShape);
+    return m_output.shape();
+}
+
+template <typename T>
+Tensor<T> &Map<T>::forwardInPlace(Tensor<T> &input)
+{
+    if(input.contiguous())
+        forwardSpan(input.ptr(), input.ptr(), input.size());
+    else
+    {
+        forEach([&](T &x)
+        {
+            x = forwardOne(x);
+        }, input);
+    }
+
+    m_aliased = true;
+    return m_output = input;
+}
+
+template <typename T>
+bool Map<T>::outputGradient() const
+{
+    return false;
+}
+
+template <typename T>
+bool Map<T>::inPlace() const
+{
+    return m_inPlace;
+}
+
+template <typename T>
+Map<T> &Map<T>::inPlace(bool inPlace)
+{
+    NNAssert(!inPlace || outputGradient(), "In-place mode requires a gradient computed from the output!");
+    m_inPlace = inPlace;
+    return *this;
+}
+
+template <typename T>
+void Map<T>::resizeOutput(const Storage<size_t> &shape)
+{
+    if(m_aliased)
+    {
+        m_output = Tensor<T>(shape, true);
+        m_aliased = false;
+    }
+    else
+        m_output.resize(shape);
+}
+
 }
 
 #endif
@@ -71,6 +71,59 @@ void Module<T>::forget()
     math::fill(state(), 0);
 }
 
+template <typename T>
+void Module<T>::inference(bool inference)
+{
+    auto grads = gradList();
+    if(inference)
+    {
+        // keep the shape, which inputShape reports, without keeping the storage
+        Tensor<T> placeholder(Storage<size_t>(m_inGrad.dims(), 1), true);
+        for(size_t i = 0, dims = m_inGrad.dims(); i < dims; ++i)
+            placeholder = placeholder.expand(i, m_inGrad.size(i));
+        m_inGrad = placeholder;
+
+        for(Tensor<T> *grad : grads)
+            *grad = Tensor<T>();
+        m_grad = Tensor<T>();
+    }
+    else if(m_inference)
+    {
+        m_inGrad = Tensor<T>(m_inGrad.shape(), true);
+
+        // gradients have the same shapes as the parameters; only reallocate the released ones
+        auto params = paramsList();
+        for(size_t i = 0, count = grads.size(); i < count; ++i)
+        {
+            if(grads[i]->size() != params[i]->size())
+                *grads[i] = Tensor<T>(params[i]->shape(), true);
+        }
+    }
+    m_inference = inference;
+}
+
+template <typename T>
+bool Module<T>::isInference() const
+{
+    return m_inference;
+}
+
+template <typename T>
+const Storage<size_t> &Module<T>::prepare(const Storage<size_t> &inputShape)
+{
+    NNAssertEquals(m_inGrad.shape(), m_output.shape(), "Module::prepare must be overridden by modules that change the shape!");
+    m_output.resize(inputShape);
+    if(!m_inference)
+        m_inGrad.resize(inputShape);
+    return outputShape();
+}
+
+template <typename T>
+bool Module<T>::backwardUsesOutput() const
+{
+    return true;
+}
+
 template <typename T>
 void Module<T>::save(Serialized &node) const
 {
@@ -96,11 +149,21 @@ Storage<Tensor<T> *> Module<T>::stateList()
     return { &m_output };
 }
 
+template <typename T>
+Storage<const Storage<size_t> *> Module<T>::touchedList()
+{
+    return Storage<const Storage<size_t> *>(gradList().size(), nullptr);
+}
+
+template <typename T>
+void Module<T>::clearTouched()
+{}
+
 template <typename T>
 Tensor<T> &Module<T>::params()
 {
     auto list = paramsList();
-    if(!m_params.sharedWith(list))
+    if(!covers(m_params, list))
         m_params = Tensor<T>::vectorize(list);
     return m_params;
 }
@@ -109,7 +172,7 @@ template <typename T>
 Tensor<T> &Module<T>::grad()
 {
     auto list = gradList();
-    if(!m_grad.sharedWith(list))
+    if(!covers(m_grad, list))
         m_grad = Tensor<T>::vectorize(list);
     return m_grad;
 }
@@ -123,6 +186,16 @@ Tensor<T> &Module<T>::state()
     return m_state;
 }
 
+template <typename T>
+bool Module<T>::covers(const Tensor<T> &flat, const Storage<Tensor<T> *> &list)
+{
+    // sharing alone is not enough; a removed component leaves its old slice of the arena behind
+    size_t size = 0;
+    for(Tensor<T> *t : list)
+        size += t->size();
+    return flat.size() == size && flat.sharedWith(list);
+}
+
 template <typename T>
 Tensor<T> &Module<T>::output()
 {
@@ -58,19 +58,11 @@ Tensor<T> &PReLU<T>::forward(const Tensor<T> &input)
     m_output.resize(input.shape());
     math::clip(m_leaks, 0, 1);
 
-    if(input.dims() == 1)
+    NNAssertEquals(input.size(input.dims() - 1), m_leaks.size(), "Incompatible input!");
+    forEachBroadcast([&](T x, T leak, T &y)
     {
-        NNAssertEquals(input.size(), m_leaks.size(), "Incompatible input!");
-        for(size_t i = 0, n = input.size(); i < n; ++i)
-            m_output(i) = input(i) > 0 ? input(i) : m_leaks(i) * input(i);
-    }
-    else
-    {
-        NNAssertEquals(input.size(1), m_leaks.size(), "Incompatible input!");
-        for(size_t i = 0, n = input.size(0), m = input.size(1); i < n; ++i)
-            for(size_t j = 0; j < m; ++j)
-                m_output(i, j) = input(i, j) > 0 ? input(i, j) : m_leaks(j) * input(i, j);
-    }
+        y = x > 0 ? x : leak * x;
+    }, input, m_leaks, m_output);
 
     return m_output;
 }
@@ -78,32 +70,19 @@ Tensor<T> &PReLU<T>::forward(const Tensor<T> &input)
 template <typename T>
 Tensor<T> &PReLU<T>::backward(const Tensor<T> &input, const Tensor<T> &outGrad)
 {
+    NNAssert(!this->isInference(), "Cannot backward in inference mode!");
     NNAssert(input.dims() == 1 || input.dims() == 2, "Expected vector or matrix input!");
     NNAssertEquals(input.shape(), outGrad.shape(), "Incompatible input and outGrad!");
     m_inGrad.resize(input.shape());
     math::clip(m_leaks, 0, 1);
 
-    if(input.dims() == 1)
-    {
-        NNAssertEquals(input.size(), m_leaks.size(), "Incompatible input!");
-        for(size_t i = 0, n = input.size(); i < n; ++i)
-        {
-            m_inGrad(i) = outGrad(i) * (input(i) > 0 ? 1 : m_leaks(i));
-            m_grads(i) += outGrad(i) * (input(i) > 0 ? 0 : input(i));
-        }
-    }
-    else
+    // the leak gradients are broadcast too, so they accumulate over the batch
+    NNAssertEquals(input.size(input.dims() - 1), m_leaks.size(), "Incompatible input!");
+    forEachBroadcast([&](T x, T g, T leak, T &dx, T &dLeak)
     {
-        NNAssertEquals(input.size(1), m_leaks.size(), "Incompatible input!");
-        for(size_t i = 0, n = input.size(0), m = input.size(1); i < n; ++i)
-        {
-            for(size_t j = 0; j < m; ++j)
-            {
-                m_inGrad(i, j) = outGrad(i, j) * (input(i, j) > 0 ? 1 : m_leaks(j));
-                m_grads(j) += outGrad(i, j) * (input(i, j) > 0 ? 0 : input(i, j));
-            }
-        }
-    }
+        dx = g * (x > 0 ? 1 : leak);
+        dLeak += g * (x > 0 ? 0 : x);
+    }, input, outGrad, m_leaks, m_inGrad, m_grads);
 
     return m_inGrad;
 }
@@ -2,7 +2,6 @@
 #define NN_RELU_TPP
 
 #include "../relu.hpp"
-#include <math.h>
 
 namespace nnlib
 {
@@ -17,20 +16,23 @@ ReLU<T>::ReLU(T leak) :
 
 template <typename T>
 ReLU<T>::ReLU(const ReLU<T> &module) :
-    Map<T>(module),
+    StaticMap<ReLU<T>, T>(module),
     m_leak(module.m_leak)
 {}
 
 template <typename T>
 ReLU<T>::ReLU(const Serialized &node) :
-    Map<T>(node),
+    StaticMap<ReLU<T>, T>(node),
     m_leak(node.get<T>("leak"))
-{}
+{
+    NNAssertGreaterThanOrEquals(m_leak, 0, "Expected positive leak!");
+    NNAssertLessThan(m_leak, 1, "Expected leak to be a percentage!");
+}
 
 template <typename T>
 ReLU<T> &ReLU<T>::operator=(const ReLU<T> &module)
 {
-    Map<T>::operator=(module);
+    StaticMap<ReLU<T>, T>::operator=(module);
     m_leak = module.m_leak;
     return *this;
 }
@@ -38,7 +40,7 @@ ReLU<T> &ReLU<T>::operator=(const ReLU<T> &module)
 template <typename T>
 void ReLU<T>::save(Serialized &node) const
 {
-    Map<T>::save(node);
+    StaticMap<ReLU<T>, T>::save(node);
     node.set("leak", m_leak);
 }
 
@@ -58,15 +60,22 @@ ReLU<T> &ReLU<T>::leak(T leak)
 }
 
 template <typename T>
-T ReLU<T>::forwardOne(const T &x)
+T ReLU<T>::apply(const T &x) const
 {
     return x > 0 ? x : m_leak * x;
 }
 
 template <typename T>
-T ReLU<T>::backwardOne(const T &x, const T &y)
+T ReLU<T>::derivative(const T &x, const T &y) const
+{
+    // the leak is nonnegative, so the output has the same sign as the input and this also works in place
+    return y > 0 ? 1 : m_leak;
+}
+
+template <typename T>
+bool ReLU<T>::outputGradient() const
 {
-    return x > 0 ? 1 : m_leak;
+    return true;
 }
 
 }
@@ -84,13 +84,16 @@ void Sequencer<T>::startForward(const Tensor<T> &first, size_t sequenceLength)
 {
     m_module->forward(first);
 
-    m_output.resize(Storage<size_t>({ sequenceLength }).append(m_module->output().shape()));
+    resizeSequence(m_output, sequenceLength, m_module->output().shape());
     if(m_reverse)
         m_output.select(0, sequenceLength - 1).copy(m_module->output());
     else
         m_output.select(0, 0).copy(m_module->output());
 
-    m_states.resize(Storage<size_t>({ sequenceLength }).append(m_module->state().shape()));
+    if(this->isInference())
+        return;
+
+    resizeSequence(m_states, sequenceLength, m_module->state().shape());
     if(m_reverse)
         m_states.select(0, sequenceLength - 1).copy(m_module->state());
     else
@@ -101,7 +104,8 @@ template <typename T>
 void Sequencer<T>::stepForward(const Tensor<T> &singleInput, size_t i)
 {
     m_output.select(0, i).copy(m_module->forward(singleInput));
-    m_states.select(0, i).copy(m_module->state());
+    if(!this->isInference())
+        m_states.select(0, i).copy(m_module->state());
 }
 
 template <typename T>
@@ -124,6 +128,17 @@ void Sequencer<T>::forget()
     m_module->forget();
 }
 
+template <typename T>
+void Sequencer<T>::inference(bool inference)
+{
+    Module<T>::inference(inference);
+    m_module->inference(inference);
+
+    // the per-step states are only kept for backward
+    if(inference)
+        m_states = Tensor<T>();
+}
+
 template <typename T>
 void Sequencer<T>::save(Serialized &node) const
 {
@@ -155,6 +170,7 @@ Tensor<T> &Sequencer<T>::forward(const Tensor<T> &input)
 template <typename T>
 Tensor<T> &Sequencer<T>::backward(const Tensor<T> &input, const Tensor<T> &outGrad)
 {
+    NNAssert(!this->isInference(), "Cannot backward in inference mode!");
     NNAssertEquals(input.size(0), outGrad.size(0), "Incompatible input and outGrad!");
     NNAssertEquals(input.size(0), m_output.size(0), "Sequencer::forward must be called first!");
     m_inGrad.resize(input.shape());
@@ -173,6 +189,25 @@ Tensor<T> &Sequencer<T>::backward(const Tensor<T> &input, const Tensor<T> &outGr
     return m_inGrad;
 }
 
+template <typename T>
+const Storage<size_t> &Sequencer<T>::prepare(const Storage<size_t> &inputShape)
+{
+    NNAssertGreaterThan(inputShape.size(), 1, "Expected a sequence dimension!");
+
+    Storage<size_t> stepShape(inputShape.size() - 1);
+    for(size_t i = 1, dims = inputShape.size(); i < dims; ++i)
+        stepShape[i - 1] = inputShape[i];
+
+    resizeSequence(m_output, inputShape[0], m_module->prepare(stepShape));
+    if(!this->isInference())
+    {
+        resizeSequence(m_states, inputShape[0], m_module->state().shape());
+        m_inGrad.resize(inputShape);
+    }
+
+    return m_output.shape();
+}
+
 template <typename T>
 Storage<Tensor<T> *> Sequencer<T>::paramsList()
 {
@@ -191,6 +226,28 @@ Storage<Tensor<T> *> Sequencer<T>::stateList()
     return Module<T>::stateList().append(m_module->stateList()).push(&m_states);
 }
 
+template <typename T>
+Storage<const Storage<size_t> *> Sequencer<T>::touchedList()
+{
+    return m_module->touchedList();
+}
+
+template <typename T>
+void Sequencer<T>::clearTouched()
+{
+    m_module->clearTouched();
+}
+
+template <typename T>
+void Sequencer<T>::resizeSequence(Tensor<T> &t, size_t length, const Storage<size_t> &step)
+{
+    bool same = t.dims() == step.size() + 1 && t.size(0) == length;
+    for(size_t i = 0, dims = step.size(); same && i < dims; ++i)
+        same = t.size(i + 1) == step[i];
+
+    if(!same)
+        t.resize(Storage<size_t>({ length }).append(step));
+}
 }
 
 #endif
@@ -2,6 +2,7 @@
 #define NN_SEQUENTIAL_TPP
 
 #include "../sequential.hpp"
+#include "../map.hpp"
 
 namespace nnlib
 {
@@ -10,20 +11,47 @@ template <typename T>
 Tensor<T> &Sequential<T>::forward(const Tensor<T> &input)
 {
     Tensor<T> *inp = const_cast<Tensor<T> *>(&input);
-    for(Module<T> *component : m_components)
-        inp = &component->forward(*inp);
+    for(size_t i = 0, end = components(); i < end; ++i)
+    {
+        MemoryTracker::Scope scope(m_components[i]);
+
+        // an in-place map may overwrite the previous output if nothing else needs it
+        Map<T> *map = i > 0 ? dynamic_cast<Map<T> *>(m_components[i]) : nullptr;
+        if(map != nullptr && map->inPlace() && !m_components[i - 1]->backwardUsesOutput())
+            inp = &map->forwardInPlace(*inp);
+        else
+            inp = &m_components[i]->forward(*inp);
+    }
     return *inp;
 }
 
 template <typename T>
 Tensor<T> &Sequential<T>::backward(const Tensor<T> &input, const Tensor<T> &outGrad)
 {
+    NNAssert(!this->isInference(), "Cannot backward in inference mode!");
     const Tensor<T> *grad = &outGrad;
     for(size_t i = components() - 1; i > 0; --i)
+    {
+        MemoryTracker::Scope scope(m_components[i]);
         grad = &m_components[i]->backward(m_components[i - 1]->output(), *grad);
+    }
+
+    MemoryTracker::Scope scope(m_components[0]);
     return m_components[0]->backward(input, *grad);
 }
 
+template <typename T>
+const Storage<size_t> &Sequential<T>::prepare(const Storage<size_t> &inputShape)
+{
+    const Storage<size_t> *shape = &inputShape;
+    for(Module<T> *comp : m_components)
+    {
+        MemoryTracker::Scope scope(comp);
+        shape = &comp->prepare(*shape);
+    }
+    return *shape;
+}
+
 template <typename T>
 Tensor<T> &Sequential<T>::output()
 {
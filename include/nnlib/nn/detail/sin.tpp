@@ -2,21 +2,35 @@
 #define NN_SIN_TPP
 
 #include "../sin.hpp"
-#include <math.h>
+#include "../../math/vecmath.hpp"
 
 namespace nnlib
 {
 
 template <typename T>
-T Sin<T>::forwardOne(const T &x)
+T Sin<T>::apply(const T &x) const
 {
-    return sin(x);
+    return vecmath::sin(x);
 }
 
 template <typename T>
-T Sin<T>::backwardOne(const T &x, const T &y)
+T Sin<T>::derivative(const T &x, const T &y) const
 {
-    return cos(x);
+    return vecmath::cos(x);
+}
+
+template <typename T>
+void Sin<T>::forwardSpan(const T *x, T *y, size_t n)
+{
+    vecmath::sin(x, y, n);
+}
+
+template <typename T>
+void Sin<T>::backwardSpan(const T *x, const T *y, const T *outGrad, T *inGrad, size_t n)
+{
+    vecmath::cos(x, inGrad, n);
+    for(size_t i = 0; i < n; ++i)
+        inGrad[i] *= outGrad[i];
 }
 
 }
@@ -2,7 +2,8 @@
 #define NN_SOFT_MAX_TPP
 
 #include "../softmax.hpp"
-#include "nnlib/math/math.hpp"
+#include "nnlib/math/reduce.hpp"
+#include "nnlib/math/vecmath.hpp"
 
 namespace nnlib
 {
@@ -12,20 +13,36 @@ SoftMax<T>::SoftMax() :
     Module<T>({ 1, 1 })
 {}
 
+template <typename T>
+SoftMax<T>::SoftMax(const SoftMax<T> &module) :
+    Module<T>(module)
+{}
+
+template <typename T>
+SoftMax<T> &SoftMax<T>::operator=(const SoftMax<T> &module)
+{
+    Module<T>::operator=(module);
+    return *this;
+}
+
 template <typename T>
 Tensor<T> &SoftMax<T>::forward(const Tensor<T> &input)
 {
     NNAssertEquals(input.dims(), 2, "Expected matrix input!");
     m_output.resize(input.shape());
+    m_rows.resize(input.size(0), 1);
 
-    for(size_t i = 0, iend = input.size(0); i < iend; ++i)
+    math::max(input, m_rows, m_features);
+    forEachBroadcast([](T x, T max, T &y)
     {
-        T max = math::max(input.narrow(0, i)), sum = 0;
-        for(size_t j = 0, jend = input.size(1); j < jend; ++j)
-            sum += (m_output(i, j) = exp(input(i, j) - max));
-        for(size_t j = 0, jend = input.size(1); j < jend; ++j)
-            m_output(i, j) /= sum;
-    }
+        y = vecmath::exp(x - max);
+    }, input, m_rows, m_output);
+
+    math::sum(m_output, m_rows, m_features);
+    forEachBroadcast([](T sum, T &y)
+    {
+        y /= sum;
+    }, m_rows, m_output);
 
     return m_output;
 }
@@ -33,23 +50,35 @@ Tensor<T> &SoftMax<T>::forward(const Tensor<T> &input)
 template <typename T>
 Tensor<T> &SoftMax<T>::backward(const Tensor<T> &input, const Tensor<T> &outGrad)
 {
+    NNAssert(!this->isInference(), "Cannot backward in inference mode!");
     NNAssertEquals(input.dims(), 2, "Expected matrix input!");
     NNAssertEquals(input.shape(), m_output.shape(), "LogSoftMax::forward must be called first!");
     NNAssertEquals(input.shape(), outGrad.shape(), "Incompatible input and outGrad!");
     m_inGrad.resize(input.shape());
+    m_rows.resize(input.size(0), 1);
+
+    forEach([](T g, T y, T &dx)
+    {
+        dx = g * y;
+    }, outGrad, m_output, m_inGrad);
 
-    for(size_t i = 0, iend = input.size(0); i < iend; ++i)
+    math::sum(m_inGrad, m_rows, m_features);
+    forEachBroadcast([](T g, T y, T sum, T &dx)
     {
-        T sum = 0;
-        for(size_t j = 0, jend = input.size(1); j < jend; ++j)
-            sum += outGrad(i, j) * m_output(i, j);
-        for(size_t j = 0, jend = input.size(1); j < jend; ++j)
-            m_inGrad(i, j) = m_output(i, j) * (outGrad(i, j) - sum);
-    }
+        dx = y * (g - sum);
+    }, outGrad, m_output, m_rows, m_inGrad);
 
     return m_inGrad;
 }
 
+template <typename T>
+const Storage<size_t> &SoftMax<T>::prepare(const Storage<size_t> &inputShape)
+{
+    NNAssertEquals(inputShape.size(), 2, "Expected matrix input!");
+    m_rows.resize(inputShape[0], 1);
+    return Module<T>::prepare(inputShape);
+}
+
 }
 
 #endif
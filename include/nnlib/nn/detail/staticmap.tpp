@@ -0,0 +1,88 @@
+#ifndef NN_STATIC_MAP_TPP
+#define NN_STATIC_MAP_TPP
+
+#include "../staticmap.hpp"
+
+namespace nnlib
+{
+
+template <typename Derived, typename T>
+T StaticMap<Derived, T>::forwardOne(const T &x)
+{
+    return derived().apply(x);
+}
+
+template <typename Derived, typename T>
+T StaticMap<Derived, T>::backwardOne(const T &x, const T &y)
+{
+    return derived().derivative(x, y);
+}
+
+template <typename Derived, typename T>
+void StaticMap<Derived, T>::forwardSpan(const T *x, T *y, size_t n)
+{
+    Derived &d = derived();
+    for(size_t i = 0; i < n; ++i)
+        y[i] = d.apply(x[i]);
+}
+
+template <typename Derived, typename T>
+void StaticMap<Derived, T>::backwardSpan(const T *x, const T *y, const T *outGrad, T *inGrad, size_t n)
+{
+    Derived &d = derived();
+    for(size_t i = 0; i < n; ++i)
+        inGrad[i] = outGrad[i] * d.derivative(x[i], y[i]);
+}
+
+template <typename Derived, typename T>
+Tensor<T> &StaticMap<Derived, T>::forward(const Tensor<T> &input)
+{
+    this->resizeOutput(input.shape());
+
+    if(input.contiguous() && m_output.contiguous())
+    {
+        forwardSpan(input.ptr(), m_output.ptr(), input.size());
+        return m_output;
+    }
+
+    Derived &d = derived();
+    forEach([&](const T &x, T &y)
+    {
+        y = d.apply(x);
+    }, input, m_output);
+
+    return m_output;
+}
+
+template <typename Derived, typename T>
+Tensor<T> &StaticMap<Derived, T>::backward(const Tensor<T> &input, const Tensor<T> &outGrad)
+{
+    NNAssert(!this->isInference(), "Cannot backward in inference mode!");
+    NNAssertEquals(input.shape(), outGrad.shape(), "Incompatible input and outGrad!");
+    NNAssertEquals(input.shape(), m_output.shape(), "StaticMap::forward must be called first!");
+    m_inGrad.resize(input.shape());
+
+    if(input.contiguous() && m_output.contiguous() && outGrad.contiguous() && m_inGrad.contiguous())
+    {
+        backwardSpan(input.ptr(), m_output.ptr(), outGrad.ptr(), m_inGrad.ptr(), input.size());
+        return m_inGrad;
+    }
+
+    Derived &d = derived();
+    forEach([&](const T &x, const T &y, const T &w, T &z)
+    {
+        z = w * d.derivative(x, y);
+    }, input, m_output, outGrad, m_inGrad);
+
+    return m_inGrad;
+}
+
+template <typename Derived, typename T>
+Derived &StaticMap<Derived, T>::derived()
+{
+    return static_cast<Derived &>(*this);
+}
+
+}
+
+#endif
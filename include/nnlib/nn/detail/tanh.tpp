@@ -2,23 +2,29 @@
 #define NN_TANH_TPP
 
 #include "../tanh.hpp"
-#include <math.h>
+#include "../../math/vecmath.hpp"
 
 namespace nnlib
 {
 
 template <typename T>
-T TanH<T>::forwardOne(const T &x)
+T TanH<T>::apply(const T &x) const
 {
-    return tanh(x);
+    return vecmath::tanh(x);
 }
 
 template <typename T>
-T TanH<T>::backwardOne(const T &x, const T &y)
+T TanH<T>::derivative(const T &x, const T &y) const
 {
     return 1.0 - y * y;
 }
 
+template <typename T>
+bool TanH<T>::outputGradient() const
+{
+    return true;
+}
+
 }
 
 #endif
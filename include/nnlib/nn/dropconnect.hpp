@@ -2,6 +2,8 @@
 #define DROPCONNECT_HPP
 
 #include "module.hpp"
+#include "linear.hpp"
+#include "../math/bitmask.hpp"
 
 namespace nnlib
 {
@@ -12,7 +14,13 @@ class DropConnect;
 template <typename T>
 void swap(DropConnect<T> &, DropConnect<T> &);
 
-/// A module decorator that randomly drops parameters with a given probability.
+/// \brief A module decorator that randomly drops parameters with a given probability.
+///
+/// In batch mode, each group of groupSize() consecutive samples shares one mask.
+/// A group size of 1 gives every sample its own mask; a wrapped Linear then masks its parameters
+/// into a scratch buffer once per sample and applies them with a single matrix-vector product.
+/// Larger groups trade mask granularity for speed, as each group is a single batched forward and
+/// backward through the wrapped module.
 template <typename T = NN_REAL_T>
 class DropConnect : public Module<T>
 {
@@ -39,10 +47,17 @@ public:
     /// Set the probability that an output is not dropped.
     DropConnect &dropProbability(T dropProbability);
 
+    /// Get the number of consecutive samples in a batch that share a mask.
+    size_t groupSize() const;
+
+    /// Set the number of consecutive samples in a batch that share a mask.
+    DropConnect &groupSize(size_t groupSize);
+
     bool isTraining() const;
 
     virtual void training(bool training = true) override;
     virtual void forget() override;
+    virtual void inference(bool inference = true) override;
 
     // MARK: Serialization
 
@@ -52,6 +67,7 @@ public:
 
     virtual Tensor<T> &forward(const Tensor<T> &input) override;
     virtual Tensor<T> &backward(const Tensor<T> &input, const Tensor<T> &outGrad) override;
+    virtual const Storage<size_t> &prepare(const Storage<size_t> &inputShape) override;
 
     // MARK: Buffers
 
@@ -66,9 +82,16 @@ protected:
 private:
     Module<T> *m_module;
     Tensor<T> m_backup;
-    Tensor<T> m_mask;
+    BitMask m_mask;
     T m_dropProbability;
+    size_t m_groupSize;
     bool m_training;
+
+    /// Forward a wrapped Linear with one mask per sample, using masked weights built per sample.
+    Tensor<T> &forwardLinear(Linear<T> &linear, const Tensor<T> &input);
+
+    /// Backward pass matching forwardLinear.
+    Tensor<T> &backwardLinear(Linear<T> &linear, const Tensor<T> &input, const Tensor<T> &outGrad);
 };
 
 }
@@ -2,6 +2,7 @@
 #define NN_DROPOUT_HPP
 
 #include "module.hpp"
+#include "../math/bitmask.hpp"
 
 namespace nnlib
 {
@@ -25,15 +26,15 @@ public:
 
     virtual Tensor<T> &forward(const Tensor<T> &input) override;
     virtual Tensor<T> &backward(const Tensor<T> &input, const Tensor<T> &outGrad) override;
-
-    virtual Storage<Tensor<T> *> stateList() override;
+    virtual const Storage<size_t> &prepare(const Storage<size_t> &inputShape) override;
+    virtual bool backwardUsesOutput() const override;
 
 protected:
     using Module<T>::m_output;
     using Module<T>::m_inGrad;
 
 private:
-    Tensor<T> m_mask;
+    BitMask m_mask;
     T m_dropProbability;
     bool m_training;
 };
@@ -1,14 +1,14 @@
 #ifndef NN_ELU_HPP
 #define NN_ELU_HPP
 
-#include "map.hpp"
+#include "staticmap.hpp"
 
 namespace nnlib
 {
 
 /// Exponential linear activation function.
 template <typename T = NN_REAL_T>
-class ELU : public Map<T>
+class ELU : public StaticMap<ELU<T>, T>
 {
 public:
     ELU(T alpha = 1.0);
@@ -22,8 +22,8 @@ public:
     T alpha() const;
     ELU &alpha(T alpha);
 
-    virtual T forwardOne(const T &x) override;
-    virtual T backwardOne(const T &x, const T &y) override;
+    T apply(const T &x) const;
+    T derivative(const T &x, const T &y) const;
 
 private:
     T m_alpha;
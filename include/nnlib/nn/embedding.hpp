@@ -0,0 +1,83 @@
+#ifndef NN_EMBEDDING_HPP
+#define NN_EMBEDDING_HPP
+
+#include "module.hpp"
+
+namespace nnlib
+{
+
+template <typename T>
+class Embedding;
+
+template <typename T>
+void swap(Embedding<T> &, Embedding<T> &);
+
+/// \brief A lookup table that maps integer indices to learned vectors.
+///
+/// Each input row holds one or more indices (stored as T, like the targets of NLL), and the matching output
+/// row is their vectors laid end to end. This is a Linear layer fed one-hot input, but forward copies rows
+/// instead of multiplying by a mostly-zero matrix, and backward accumulates into only the rows that were
+/// looked up. Those rows are reported by touchedList() so that an optimizer can update just them.
+template <typename T = NN_REAL_T>
+class Embedding : public Module<T>
+{
+public:
+    Embedding(size_t entries, size_t features);
+    Embedding(const Embedding &module);
+    Embedding(const Serialized &node);
+
+    Embedding &operator=(Embedding module);
+
+    friend void swap <> (Embedding &a, Embedding &b);
+
+    Embedding &reset();
+
+    size_t entries() const;
+    size_t features() const;
+
+    Tensor<T> weights();
+
+    /// The rows of the weights that backward has accumulated into since the last call to clearTouched().
+    const Storage<size_t> &touched() const;
+
+    virtual void inference(bool inference = true) override;
+    virtual void save(Serialized &node) const override;
+
+    virtual Tensor<T> &forward(const Tensor<T> &input) override;
+
+    /// Accumulate outGrad into the looked-up rows of the weight gradient. Indices are not differentiable, so the input gradient is zero.
+    virtual Tensor<T> &backward(const Tensor<T> &input, const Tensor<T> &outGrad) override;
+
+    virtual const Storage<size_t> &prepare(const Storage<size_t> &inputShape) override;
+    virtual bool backwardUsesOutput() const override;
+
+    virtual Storage<Tensor<T> *> paramsList() override;
+    virtual Storage<Tensor<T> *> gradList() override;
+    virtual Storage<const Storage<size_t> *> touchedList() override;
+    virtual void clearTouched() override;
+
+protected:
+    using Module<T>::m_output;
+    using Module<T>::m_inGrad;
+
+private:
+    Tensor<T> m_weights;       ///< One row of features per entry.
+    Tensor<T> m_weightsGrad;   ///< The gradient of the weights; only touched rows are ever nonzero.
+    Storage<size_t> m_touched; ///< The touched rows, each listed once.
+    Storage<bool> m_isTouched; ///< Whether each row is in m_touched.
+
+    /// Record that backward accumulated into the given row.
+    void touch(size_t row);
+};
+
+}
+
+NNRegisterType(Embedding, Module);
+
+#if defined NN_REAL_T && !defined NN_IMPL
+    extern template class nnlib::Embedding<NN_REAL_T>;
+#elif !defined NN_IMPL
+    #include "detail/embedding.tpp"
+#endif
+
+#endif
@@ -1,7 +1,7 @@
 #ifndef NN_IDENTITY_HPP
 #define NN_IDENTITY_HPP
 
-#include "module.hpp"
+#include "staticmap.hpp"
 
 namespace nnlib
 {
@@ -11,17 +11,13 @@ namespace nnlib
 /// A residual connection can be modeled for an arbitrary module m like this:
 ///     residual = new Concat<T>(new Identity<T>(), m);
 template <typename T = NN_REAL_T>
-class Identity : public Module<T>
+class Identity : public StaticMap<Identity<T>, T>
 {
 public:
-    using Module<T>::Module;
+    using StaticMap<Identity<T>, T>::StaticMap;
 
-    virtual Tensor<T> &forward(const Tensor<T> &input) override;
-    virtual Tensor<T> &backward(const Tensor<T> &input, const Tensor<T> &outGrad) override;
-
-protected:
-    using Module<T>::m_output;
-    using Module<T>::m_inGrad;
+    T apply(const T &x) const;
+    T derivative(const T &x, const T &y) const;
 };
 
 }
@@ -2,6 +2,7 @@
 #define NN_LINEAR_HPP
 
 #include "module.hpp"
+#include "../core/sparse_tensor.hpp"
 
 namespace nnlib
 {
@@ -40,8 +41,23 @@ public:
     virtual Tensor<T> &forward(const Tensor<T> &input) override;
     virtual Tensor<T> &backward(const Tensor<T> &input, const Tensor<T> &outGrad) override;
 
+    /// Forward a batch of sparse rows, with work proportional to their nonzeros.
+    Tensor<T> &forward(const SparseTensor<T> &input);
+
+    /// \brief Backward a batch of sparse rows, with work proportional to their nonzeros.
+    ///
+    /// Only the rows of the weight gradient named by a nonzero column of the input are accumulated into, and
+    /// they are reported by touchedList() as long as no dense backward has run since clearTouched(). The input
+    /// gradient is not computed, since sparse input is data rather than the output of another module, so
+    /// nothing is returned and inGrad() is left as it was.
+    void backward(const SparseTensor<T> &input, const Tensor<T> &outGrad);
+    virtual const Storage<size_t> &prepare(const Storage<size_t> &inputShape) override;
+    virtual bool backwardUsesOutput() const override;
+
     virtual Storage<Tensor<T> *> paramsList() override;
     virtual Storage<Tensor<T> *> gradList() override;
+    virtual Storage<const Storage<size_t> *> touchedList() override;
+    virtual void clearTouched() override;
 
 protected:
     using Module<T>::m_output;
@@ -54,7 +70,9 @@ protected:
     Tensor<T> m_bias;
     Tensor<T> m_biasGrad;
 
-    Tensor<T> m_ones;
+    Storage<size_t> m_touched; ///< The rows of the weight gradient touched by sparse backward.
+    Storage<bool> m_isTouched; ///< Whether each row is in m_touched; allocated by the first sparse backward.
+    bool m_rowSparse;          ///< Whether only sparse backward has run since the last clearTouched().
 };
 
 }
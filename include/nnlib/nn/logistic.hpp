@@ -1,20 +1,22 @@
 #ifndef NN_LOGISTIC_HPP
 #define NN_LOGISTIC_HPP
 
-#include "map.hpp"
+#include "staticmap.hpp"
 
 namespace nnlib
 {
 
 /// Sigmoidal logistic activation function.
 template <typename T = NN_REAL_T>
-class Logistic : public Map<T>
+class Logistic : public StaticMap<Logistic<T>, T>
 {
 public:
-    using Map<T>::Map;
+    using StaticMap<Logistic<T>, T>::StaticMap;
 
-    virtual T forwardOne(const T &x) override;
-    virtual T backwardOne(const T &x, const T &y) override;
+    T apply(const T &x) const;
+    T derivative(const T &x, const T &y) const;
+
+    virtual bool outputGradient() const override;
 };
 
 }
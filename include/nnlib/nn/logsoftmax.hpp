@@ -16,13 +16,23 @@ public:
     using Module<T>::Module;
 
     LogSoftMax();
+    LogSoftMax(const LogSoftMax &module);
+
+    LogSoftMax &operator=(const LogSoftMax &module);
 
     virtual Tensor<T> &forward(const Tensor<T> &input) override;
     virtual Tensor<T> &backward(const Tensor<T> &input, const Tensor<T> &outGrad) override;
+    virtual const Storage<size_t> &prepare(const Storage<size_t> &inputShape) override;
 
 protected:
     using Module<T>::m_output;
     using Module<T>::m_inGrad;
+
+    /// Per-row reductions of the input or gradient, shaped to broadcast across each row.
+    Tensor<T> m_rows;
+
+    /// The axis reduced over to get m_rows.
+    const Storage<size_t> m_features = { 1 };
 };
 
 }
@@ -38,10 +38,12 @@ public:
     T gradClip() const;
 
     virtual void forget() override;
+    virtual void inference(bool inference = true) override;
     virtual void save(Serialized &node) const override;
 
     virtual Tensor<T> &forward(const Tensor<T> &input) override;
     virtual Tensor<T> &backward(const Tensor<T> &input, const Tensor<T> &outGrad) override;
+    virtual const Storage<size_t> &prepare(const Storage<size_t> &inputShape) override;
 
     virtual Storage<Tensor<T> *> paramsList() override;
     virtual Storage<Tensor<T> *> gradList() override;
@@ -13,15 +13,56 @@ class Map : public Module<T>
 public:
     using Module<T>::Module;
 
+    Map();
+    Map(const Map &module);
+    Map(const Serialized &node);
+
+    Map &operator=(const Map &module);
+
+    virtual void save(Serialized &node) const override;
+
     virtual T forwardOne(const T &x) = 0;
     virtual T backwardOne(const T &x, const T &y) = 0;
 
+    /// \brief Apply forwardOne to n contiguous values.
+    ///
+    /// forward uses this when the input is contiguous; override it with a loop the compiler can vectorize.
+    virtual void forwardSpan(const T *x, T *y, size_t n);
+
+    /// Compute inGrad = outGrad * backwardOne(x, y) for n contiguous values.
+    virtual void backwardSpan(const T *x, const T *y, const T *outGrad, T *inGrad, size_t n);
+
     virtual Tensor<T> &forward(const Tensor<T> &input) override;
     virtual Tensor<T> &backward(const Tensor<T> &input, const Tensor<T> &outGrad) override;
+    virtual const Storage<size_t> &prepare(const Storage<size_t> &inputShape) override;
+
+    /// \brief Forward in place, overwriting the input buffer.
+    ///
+    /// The output becomes a view of the input, so no output buffer is kept. Unless the gradient can be
+    /// computed from the output alone, backward will no longer see the original input.
+    virtual Tensor<T> &forwardInPlace(Tensor<T> &input);
+
+    /// Whether backwardOne depends only on the output, so that forward can safely run in place.
+    virtual bool outputGradient() const;
+
+    /// \brief Whether this map runs in place when it is part of a Sequential.
+    ///
+    /// In place, the map overwrites the preceding module's output instead of keeping its own, roughly
+    /// halving activation memory; Sequential only does this when the preceding module's backward does
+    /// not read its output. This requires outputGradient().
+    bool inPlace() const;
+    Map &inPlace(bool inPlace);
 
 protected:
     using Module<T>::m_output;
     using Module<T>::m_inGrad;
+
+    /// Resize the output to match the input, first detaching it if it is a view of an in-place input.
+    void resizeOutput(const Storage<size_t> &shape);
+
+private:
+    bool m_inPlace = false;  ///< Whether to run in place in a Sequential.
+    bool m_aliased = false;  ///< Whether the output is currently a view of the last input.
 };
 
 }
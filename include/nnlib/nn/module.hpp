@@ -32,6 +32,16 @@ public:
     /// Reset the internal state of this module. Useful for recurrent modules that have additional inner state.
     virtual void forget();
 
+    /// \brief Set whether this module is only used for inference.
+    ///
+    /// In inference mode, gradient buffers are released, state that only backward needs is not kept,
+    /// and calling backward is an error. Leaving inference mode reallocates the gradients (zeroed).
+    /// Modules that own other modules pass this on to them. Copies start outside of inference mode.
+    virtual void inference(bool inference = true);
+
+    /// Whether this module is in inference mode.
+    bool isInference() const;
+
     /// \brief Save the current module to a serialized node.
     ///
     /// The load method is omitted; instead, a constructor taking a Serialized& should be implemented
@@ -44,12 +54,48 @@ public:
     /// Take the derivative of the module and return the gradient of the input.
     virtual Tensor<T> &backward(const Tensor<T> &input, const Tensor<T> &outGrad) = 0;
 
+    /// \brief Size every buffer for inputs of the given shape and return the resulting output shape.
+    ///
+    /// Preparing with the largest batch that will be used allocates everything up front; forward and
+    /// backward with that batch size or smaller then reuse the buffers instead of allocating. Modules that
+    /// own other modules prepare them too. The default is only for modules whose output has the same shape
+    /// as their input, and asserts that it does; modules that change the shape must override it.
+    /// A buffer that is shared, such as the output taken over by an in-place map, still reallocates when
+    /// it grows back after a smaller batch.
+    virtual const Storage<size_t> &prepare(const Storage<size_t> &inputShape);
+
+    /// \brief Whether backward reads this module's output.
+    ///
+    /// If not, an in-place activation that follows this module in a Sequential may overwrite the output.
+    virtual bool backwardUsesOutput() const;
+
     virtual Storage<Tensor<T> *> paramsList();
     virtual Storage<Tensor<T> *> gradList();
     virtual Storage<Tensor<T> *> stateList();
 
+    /// \brief For each tensor in gradList(), the rows (along its first dimension) that backward has accumulated into.
+    ///
+    /// A null entry means any row may have been touched; this is the default. Modules whose gradients are row-sparse,
+    /// such as Embedding, record the rows they touch until clearTouched() is called, so that an optimizer can clear
+    /// and update only those rows instead of the whole flat grad() vector.
+    virtual Storage<const Storage<size_t> *> touchedList();
+
+    /// Forget the rows recorded for touchedList(). Modules that own other modules pass this on to them.
+    virtual void clearTouched();
+
+    /// \brief All parameters of this module as one flat vector.
+    ///
+    /// The first call moves every parameter into a single contiguous arena, leaving the module's (and its
+    /// sub-modules') parameter tensors as views into it. Later calls return the cached arena as long as it
+    /// still spans exactly the tensors in paramsList(); a parameter that was replaced, swapped or removed
+    /// causes the arena to be rebuilt. Checking this walks paramsList(), so each call is linear in the number
+    /// of parameter tensors. A newly built arena starts on an NN_ALIGNMENT boundary; the arena of a sub-module
+    /// is a view into its container's arena and may not be.
     Tensor<T> &params();
+
+    /// All parameter gradients as one flat vector, in the same order as params(); cached the same way.
     Tensor<T> &grad();
+
     Tensor<T> &state();
 
     virtual Tensor<T> &output();
@@ -67,6 +113,12 @@ protected:
     Tensor<T> m_params;
     Tensor<T> m_grad;
     Tensor<T> m_state;
+
+private:
+    /// Whether flat is an arena holding exactly the tensors in list.
+    static bool covers(const Tensor<T> &flat, const Storage<Tensor<T> *> &list);
+
+    bool m_inference = false;
 };
 
 }
@@ -1,14 +1,14 @@
 #ifndef NN_RELU_HPP
 #define NN_RELU_HPP
 
-#include "map.hpp"
+#include "staticmap.hpp"
 
 namespace nnlib
 {
 
 /// Rectified linear activation function.
 template <typename T = NN_REAL_T>
-class ReLU : public Map<T>
+class ReLU : public StaticMap<ReLU<T>, T>
 {
 public:
     ReLU(T leak = 0.1);
@@ -22,8 +22,10 @@ public:
     T leak() const;
     ReLU &leak(T leak);
 
-    virtual T forwardOne(const T &x) override;
-    virtual T backwardOne(const T &x, const T &y) override;
+    T apply(const T &x) const;
+    T derivative(const T &x, const T &y) const;
+
+    virtual bool outputGradient() const override;
 
 private:
     T m_leak;
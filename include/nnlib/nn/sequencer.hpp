@@ -47,15 +47,19 @@ public:
 
     virtual void training(bool training = true) override;
     virtual void forget() override;
+    virtual void inference(bool inference = true) override;
 
     virtual void save(Serialized &node) const override;
 
     virtual Tensor<T> &forward(const Tensor<T> &input) override;
     virtual Tensor<T> &backward(const Tensor<T> &input, const Tensor<T> &outGrad) override;
+    virtual const Storage<size_t> &prepare(const Storage<size_t> &inputShape) override;
 
     virtual Storage<Tensor<T> *> paramsList() override;
     virtual Storage<Tensor<T> *> gradList() override;
     virtual Storage<Tensor<T> *> stateList() override;
+    virtual Storage<const Storage<size_t> *> touchedList() override;
+    virtual void clearTouched() override;
 
 protected:
     using Module<T>::m_output;
@@ -65,6 +69,9 @@ private:
     Module<T> *m_module;
     Tensor<T> m_states;
     bool m_reverse;
+
+    /// Resize t to { length, step... }, only building the new shape if it differs.
+    static void resizeSequence(Tensor<T> &t, size_t length, const Storage<size_t> &step);
 };
 
 }
@@ -6,7 +6,10 @@
 namespace nnlib
 {
 
-/// A standard feed-forward neural network module.
+/// \brief A standard feed-forward neural network module.
+///
+/// Each component runs (forward, backward and prepare) inside a MemoryTracker::Scope tagged with the
+/// component itself, so MemoryTracker::stats(sequential.component(i)) reports what that layer allocated.
 template <typename T = NN_REAL_T>
 class Sequential : public Container<T>
 {
@@ -22,6 +25,7 @@ public:
 
     virtual Tensor<T> &forward(const Tensor<T> &input) override;
     virtual Tensor<T> &backward(const Tensor<T> &input, const Tensor<T> &outGrad) override;
+    virtual const Storage<size_t> &prepare(const Storage<size_t> &inputShape) override;
     virtual Tensor<T> &output() override;
     virtual Tensor<T> &inGrad() override;
 
@@ -1,20 +1,23 @@
 #ifndef NN_SIN_HPP
 #define NN_SIN_HPP
 
-#include "map.hpp"
+#include "staticmap.hpp"
 
 namespace nnlib
 {
 
 /// Sinusoid activation function.
 template <typename T = NN_REAL_T>
-class Sin : public Map<T>
+class Sin : public StaticMap<Sin<T>, T>
 {
 public:
-    using Map<T>::Map;
+    using StaticMap<Sin<T>, T>::StaticMap;
 
-    virtual T forwardOne(const T &x) override;
-    virtual T backwardOne(const T &x, const T &y) override;
+    T apply(const T &x) const;
+    T derivative(const T &x, const T &y) const;
+
+    virtual void forwardSpan(const T *x, T *y, size_t n) override;
+    virtual void backwardSpan(const T *x, const T *y, const T *outGrad, T *inGrad, size_t n) override;
 };
 
 }
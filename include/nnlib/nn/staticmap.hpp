@@ -0,0 +1,42 @@
+#ifndef NN_STATIC_MAP_HPP
+#define NN_STATIC_MAP_HPP
+
+#include "map.hpp"
+
+namespace nnlib
+{
+
+/// \brief A Map whose pointwise function is known at compile time.
+///
+/// Derived implements the function as non-virtual `T apply(const T &x) const` and its derivative as
+/// `T derivative(const T &x, const T &y) const`, where y = apply(x). Calls to these are resolved
+/// statically, so the element loops in forward and backward inline them and can be vectorized.
+/// Derived is still a Map, so it is registered and serialized through Factory like any other module.
+template <typename Derived, typename T = NN_REAL_T>
+class StaticMap : public Map<T>
+{
+public:
+    using Map<T>::Map;
+
+    virtual T forwardOne(const T &x) override final;
+    virtual T backwardOne(const T &x, const T &y) override final;
+
+    virtual void forwardSpan(const T *x, T *y, size_t n) override;
+    virtual void backwardSpan(const T *x, const T *y, const T *outGrad, T *inGrad, size_t n) override;
+
+    virtual Tensor<T> &forward(const Tensor<T> &input) override;
+    virtual Tensor<T> &backward(const Tensor<T> &input, const Tensor<T> &outGrad) override;
+
+protected:
+    using Map<T>::m_output;
+    using Map<T>::m_inGrad;
+
+private:
+    Derived &derived();
+};
+
+}
+
+#include "detail/staticmap.tpp"
+
+#endif
@@ -1,20 +1,22 @@
 #ifndef NN_TANH_HPP
 #define NN_TANH_HPP
 
-#include "map.hpp"
+#include "staticmap.hpp"
 
 namespace nnlib
 {
 
 /// Hyperbolic tangent activation function.
 template <typename T = NN_REAL_T>
-class TanH : public Map<T>
+class TanH : public StaticMap<TanH<T>, T>
 {
 public:
-    using Map<T>::Map;
+    using StaticMap<TanH<T>, T>::StaticMap;
 
-    virtual T forwardOne(const T &x) override;
-    virtual T backwardOne(const T &x, const T &y) override;
+    T apply(const T &x) const;
+    T derivative(const T &x, const T &y) const;
+
+    virtual bool outputGradient() const override;
 };
 
 }
@@ -48,6 +48,7 @@ T Nadam<T>::beta2() const
 template <typename T>
 void Nadam<T>::reset()
 {
+    Optimizer<T>::reset();
     m_normalize1 = 1;
     m_normalize2 = 1;
     math::fill(m_mean, 0);
@@ -55,30 +56,34 @@ void Nadam<T>::reset()
 }
 
 template <typename T>
-Nadam<T> &Nadam<T>::step(const Tensor<T> &input, const Tensor<T> &target)
+void Nadam<T>::update(const Storage<Range> &ranges)
 {
     m_normalize1 *= m_beta1;
     m_normalize2 *= m_beta2;
 
     T lr = m_learningRate / (1 - m_normalize1) * sqrt(1 - m_normalize2);
 
-    // calculate gradient
-    math::fill(m_grad, 0);
-    m_model.backward(input, m_critic->backward(m_model.forward(input), target));
-
-    for(size_t i = 0, end = m_grad.size(); i != end; ++i)
+    for(const auto &range : ranges)
     {
-        // update mean
-        m_mean(i) = m_beta1 * m_mean(i) + (1 - m_beta1) * m_grad(i);
-
-        // update variance
-        m_variance(i) = m_beta2 * m_variance(i) + (1 - m_beta2) * m_grad(i) * m_grad(i);
-
-        // update parameters
-        m_params(i) -= lr * ((1 - m_beta1) * m_grad(i) + m_beta1 * m_mean(i)) / (sqrt(m_variance(i)) + 1e-8);
+        for(size_t i = range.begin; i != range.end; ++i)
+        {
+            // catch up on the decay from skipped steps
+            if(size_t skipped = this->skipped(i))
+            {
+                m_mean(i) *= pow(m_beta1, skipped);
+                m_variance(i) *= pow(m_beta2, skipped);
+            }
+
+            // update mean
+            m_mean(i) = m_beta1 * m_mean(i) + (1 - m_beta1) * m_grad(i);
+
+            // update variance
+            m_variance(i) = m_beta2 * m_variance(i) + (1 - m_beta2) * m_grad(i) * m_grad(i);
+
+            // update parameters
+            m_params(i) -= lr * ((1 - m_beta1) * m_grad(i) + m_beta1 * m_mean(i)) / (sqrt(m_variance(i)) + 1e-8);
+        }
     }
-
-    return *this;
 }
 
 }
@@ -3,6 +3,8 @@
 
 #include "../optimizer.hpp"
 #include "nnlib/critics/mse.hpp"
+#include "nnlib/math/math.hpp"
+#include <algorithm>
 
 namespace nnlib
 {
@@ -13,7 +15,9 @@ Optimizer<T>::Optimizer(Module<T> &model, Critic<T> *critic) :
     m_critic(critic != nullptr ? critic : new MSE<T>()),
     m_params(model.params()),
     m_grad(model.grad()),
-    m_learningRate(0.01)
+    m_learningRate(0.01),
+    m_sparse(false),
+    m_steps(0)
 {}
 
 template <typename T>
@@ -59,12 +63,141 @@ Optimizer<T> &Optimizer<T>::learningRate(T learningRate)
     return *this;
 }
 
+template <typename T>
+Optimizer<T> &Optimizer<T>::sparse(bool sparse)
+{
+    // dense steps have updated every element so far
+    if(sparse && !lazy())
+        m_updated.resize(m_grad.size(), m_steps);
+    m_sparse = sparse;
+    return *this;
+}
+
+template <typename T>
+bool Optimizer<T>::sparse() const
+{
+    return m_sparse;
+}
+
 template <typename T>
 T Optimizer<T>::evaluate(const Tensor<T> &input, const Tensor<T> &target)
 {
     return m_critic->forward(m_model.forward(input), target);
 }
 
+template <typename T>
+void Optimizer<T>::reset()
+{
+    m_steps = 0;
+    if(m_sparse)
+    {
+        for(size_t &step : m_updated)
+            step = 0;
+    }
+    else
+        m_updated = Storage<size_t>();
+}
+
+template <typename T>
+Optimizer<T> &Optimizer<T>::step(const Tensor<T> &input, const Tensor<T> &target)
+{
+    return step([&]()
+    {
+        m_model.backward(input, m_critic->backward(m_model.forward(input), target));
+    });
+}
+
+template <typename T>
+Optimizer<T> &Optimizer<T>::step(const std::function<void()> &pass)
+{
+    ++m_steps;
+
+    // only the rows touched since the last clear can be nonzero
+    if(m_sparse)
+    {
+        collectRanges();
+        T *grad = m_grad.ptr();
+        for(const Range &range : m_ranges)
+            std::fill(grad + range.begin, grad + range.end, T(0));
+    }
+    else
+        math::fill(m_grad, 0);
+
+    m_model.clearTouched();
+    pass();
+
+    if(m_sparse)
+        collectRanges();
+    else
+    {
+        m_ranges.clear();
+        if(m_grad.size() > 0)
+            m_ranges.push(Range{ 0, m_grad.size() });
+    }
+
+    update(m_ranges);
+    return *this;
+}
+
+template <typename T>
+bool Optimizer<T>::lazy() const
+{
+    return m_updated.size() > 0;
+}
+
+template <typename T>
+size_t Optimizer<T>::skipped(size_t i)
+{
+    if(!lazy())
+        return 0;
+
+    size_t skipped = m_steps - 1 - m_updated[i];
+    m_updated[i] = m_steps;
+    return skipped;
+}
+
+template <typename T>
+void Optimizer<T>::collectRanges()
+{
+    auto grads = m_model.gradList();
+    auto touched = m_model.touchedList();
+    NNAssertEquals(grads.size(), touched.size(), "Incompatible gradient and touched lists!");
+
+    // gradients are views into the flat gradient in list order, so ranges come out ascending
+    m_ranges.clear();
+    auto add = [&](size_t begin, size_t end)
+    {
+        if(m_ranges.size() > 0 && m_ranges.back().end == begin)
+            m_ranges.back().end = end;
+        else
+            m_ranges.push(Range{ begin, end });
+    };
+
+    const T *flat = m_model.grad().ptr();
+    for(size_t i = 0, count = grads.size(); i < count; ++i)
+    {
+        size_t offset = grads[i]->ptr() - flat, size = grads[i]->size();
+        if(size == 0)
+            continue;
+
+        NNAssertLessThanOrEquals(offset + size, m_grad.size(), "Expected a view into the flat gradient!");
+        if(touched[i] == nullptr)
+        {
+            add(offset, offset + size);
+            continue;
+        }
+
+        size_t width = size / grads[i]->size(0);
+        m_rows.clear().append(*touched[i]);
+        std::sort(m_rows.begin(), m_rows.end());
+        for(size_t j = 0, rows = m_rows.size(); j < rows; ++j)
+        {
+            if(j == 0 || m_rows[j] != m_rows[j - 1])
+                add(offset + m_rows[j] * width, offset + (m_rows[j] + 1) * width);
+        }
+    }
+}
+
 }
 
 #endif
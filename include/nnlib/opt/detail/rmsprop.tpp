@@ -31,26 +31,28 @@ RMSProp<T> &RMSProp<T>::gamma(T gamma)
 template <typename T>
 void RMSProp<T>::reset()
 {
+    Optimizer<T>::reset();
     math::fill(m_variance, 0);
 }
 
 template <typename T>
-RMSProp<T> &RMSProp<T>::step(const Tensor<T> &input, const Tensor<T> &target)
+void RMSProp<T>::update(const Storage<Range> &ranges)
 {
-    // calculate gradient
-    math::fill(m_grad, 0);
-    m_model.backward(input, m_critic->backward(m_model.forward(input), target));
-
-    for(size_t i = 0, end = m_grad.size(); i != end; ++i)
+    for(const auto &range : ranges)
     {
-        // update variance
-        m_variance(i) = m_gamma * m_variance(i) + (1 - m_gamma) * m_grad(i) * m_grad(i);
-
-        // update parameters
-        m_params(i) -= m_learningRate * m_grad(i) / (sqrt(m_variance(i)) + 1e-8);
+        for(size_t i = range.begin; i != range.end; ++i)
+        {
+            // catch up on the decay from skipped steps
+            if(size_t skipped = this->skipped(i))
+                m_variance(i) *= pow(m_gamma, skipped);
+
+            // update variance
+            m_variance(i) = m_gamma * m_variance(i) + (1 - m_gamma) * m_grad(i) * m_grad(i);
+
+            // update parameters
+            m_params(i) -= m_learningRate * m_grad(i) / (sqrt(m_variance(i)) + 1e-8);
+        }
     }
-
-    return *this;
 }
 
 }
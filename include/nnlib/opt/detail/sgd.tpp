@@ -33,28 +33,44 @@ T SGD<T>::momentum() const
 template <typename T>
 void SGD<T>::reset()
 {
+    Optimizer<T>::reset();
     math::fill(m_velocity, 0);
 }
 
 template <typename T>
-SGD<T> &SGD<T>::step(const Tensor<T> &input, const Tensor<T> &target)
+void SGD<T>::update(const Storage<Range> &ranges)
 {
-    // calculate gradient
-    math::fill(m_grad, 0);
-    m_model.backward(input, m_critic->backward(m_model.forward(input), target));
-
-    // Nesterov momentum
-    if(m_momentum)
+    if(!this->lazy())
     {
-        math::scale(m_velocity, m_momentum);
-        math::vAdd_v(m_grad, m_velocity, -m_learningRate);
-        math::vAdd_v(m_velocity, m_params, m_momentum);
+        // Nesterov momentum
+        if(m_momentum)
+        {
+            math::scale(m_velocity, m_momentum);
+            math::vAdd_v(m_grad, m_velocity, -m_learningRate);
+            math::vAdd_v(m_velocity, m_params, m_momentum);
+        }
+
+        // update parameters
+        math::vAdd_v(m_grad, m_params, -m_learningRate);
+        return;
     }
 
-    // update parameters
-    math::vAdd_v(m_grad, m_params, -m_learningRate);
+    for(const auto &range : ranges)
+    {
+        for(size_t i = range.begin; i != range.end; ++i)
+        {
+            // catch up on the decay from skipped steps, then apply Nesterov momentum
+            size_t skipped = this->skipped(i);
+            if(m_momentum)
+            {
+                m_velocity(i) = pow(m_momentum, skipped + 1) * m_velocity(i) - m_learningRate * m_grad(i);
+                m_params(i) += m_momentum * m_velocity(i);
+            }
 
-    return *this;
+            // update parameters
+            m_params(i) -= m_learningRate * m_grad(i);
+        }
+    }
 }
 
 }
@@ -24,7 +24,10 @@ public:
     T beta2() const;
 
     virtual void reset() override;
-    virtual Nadam &step(const Tensor<T> &input, const Tensor<T> &target) override;
+
+protected:
+    using typename Optimizer<T>::Range;
+    virtual void update(const Storage<Range> &ranges) override;
 
 private:
     Tensor<T> m_mean;
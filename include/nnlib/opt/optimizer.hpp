@@ -3,6 +3,7 @@
 
 #include "../critics/critic.hpp"
 #include "../nn/module.hpp"
+#include <functional>
 
 namespace nnlib
 {
@@ -25,21 +26,68 @@ public:
     T learningRate() const;
     Optimizer<T> &learningRate(T learningRate);
 
+    /// \brief Set whether each step updates only the rows of the gradient that backward touched.
+    ///
+    /// Touched rows are reported by Module::touchedList(); gradients without such a record are updated in full.
+    /// A sparse step also clears only the previously touched rows of the gradient, so its cost is proportional
+    /// to the touched parameters rather than to the whole model. Decaying state, like momentum and moment
+    /// estimates, is caught up lazily when a row is next touched; unlike a dense step, parameters in untouched
+    /// rows do not keep moving with their momentum in the meantime.
+    Optimizer<T> &sparse(bool sparse);
+    bool sparse() const;
+
     /// Evaluate the error on the given input/target pair.
     T evaluate(const Tensor<T> &input, const Tensor<T> &target);
 
-    /// Reset the state of the optimizer (i.e. momentum).
+    /// Reset the state of the optimizer (i.e. momentum). Subclasses must call this to reset the step count.
     virtual void reset() = 0;
 
     /// Perform a single step of training given an input and a target.
-    virtual Optimizer &step(const Tensor<T> &input, const Tensor<T> &target) = 0;
+    Optimizer &step(const Tensor<T> &input, const Tensor<T> &target);
+
+    /// \brief Perform a single step of training, letting the caller run forward and backward.
+    ///
+    /// The gradient is cleared before pass is called, and pass must add the gradient of the error to the model.
+    /// This is how to train on inputs that step cannot take as a Tensor, like a SparseTensor fed to a Linear,
+    /// whose touched rows are then all that a sparse step clears and updates.
+    Optimizer &step(const std::function<void()> &pass);
 
 protected:
+    /// A half-open range [begin, end) of the flat parameter and gradient vectors.
+    struct Range
+    {
+        size_t begin;
+        size_t end;
+    };
+
+    /// \brief Update the parameters in the given ranges from the accumulated gradient.
+    ///
+    /// This is called once per step. In dense mode, the only range is the whole gradient.
+    virtual void update(const Storage<Range> &ranges) = 0;
+
+    /// \brief Whether elements may have skipped steps, so that updates must check skipped().
+    ///
+    /// This is true once sparse mode has been used, until the next reset.
+    bool lazy() const;
+
+    /// The number of steps that did not update the given element since it was last updated, marking it updated now.
+    size_t skipped(size_t i);
+
     Module<T> &m_model;
     Critic<T> *m_critic;
     Tensor<T> &m_params;
     Tensor<T> &m_grad;
     T m_learningRate;
+
+private:
+    /// Collect the touched rows of the model's gradient as merged ranges of the flat gradient.
+    void collectRanges();
+
+    bool m_sparse;
+    size_t m_steps;            ///< The number of steps taken since the last reset.
+    Storage<size_t> m_updated; ///< In sparse mode, the step at which each element was last updated.
+    Storage<Range> m_ranges;   ///< The ranges to update in the current step.
+    Storage<size_t> m_rows;    ///< Scratch space for sorting touched rows.
 };
 
 }
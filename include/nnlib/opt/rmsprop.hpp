@@ -21,7 +21,10 @@ public:
     RMSProp &gamma(T gamma);
 
     virtual void reset() override;
-    virtual RMSProp &step(const Tensor<T> &input, const Tensor<T> &target) override;
+
+protected:
+    using typename Optimizer<T>::Range;
+    virtual void update(const Storage<Range> &ranges) override;
 
 private:
     Tensor<T> m_variance;
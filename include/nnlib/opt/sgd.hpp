@@ -21,7 +21,10 @@ public:
     T momentum() const;
 
     virtual void reset() override;
-    virtual SGD &step(const Tensor<T> &input, const Tensor<T> &target) override;
+
+protected:
+    using typename Optimizer<T>::Range;
+    virtual void update(const Storage<Range> &ranges) override;
 
 private:
     Tensor<T> m_velocity;
@@ -3,6 +3,7 @@
 
 #include "../math/random.hpp"
 #include "../core/tensor.hpp"
+#include "../core/sparse_tensor.hpp"
 
 namespace nnlib
 {
@@ -10,6 +11,7 @@ namespace nnlib
 /// Takes two tensors and returns random slices along the major dimensions, one slice at at time.
 /// This is useful for optimization.
 /// Batcher requires non-const inputs and will shuffle them unless the copy flag is true.
+/// Shuffling writes to the inputs, so memory-mapped inputs (see Tensor::map) must be mapped copy-on-write.
 template <typename T = NN_REAL_T>
 class Batcher
 {
@@ -73,11 +75,47 @@ private:
     size_t m_sequenceLength;
 };
 
+/// This variation of Batcher yields batches of sparse feature rows with dense labels.
+/// Rather than shuffling the inputs in place, it shuffles the order in which rows are visited and
+/// gathers each batch, so a batch costs time proportional to its nonzeros rather than to the width.
+template <typename T = NN_REAL_T>
+class SparseBatcher
+{
+public:
+    SparseBatcher(const SparseTensor<T> &feat, const Tensor<T> &lab, size_t bats = 1);
+
+    SparseBatcher &batch(size_t bats);
+    size_t batch() const;
+    size_t batches() const;
+
+    SparseBatcher &reset();
+
+    bool next(bool autoReset = false);
+
+    SparseTensor<T> &features();
+    Tensor<T> &labels();
+    SparseTensor<T> &allFeatures();
+    Tensor<T> &allLabels();
+
+private:
+    SparseTensor<T> m_feat;
+    Tensor<T> m_lab;
+    SparseTensor<T> m_featBatch;
+    Tensor<T> m_labBatch;
+    Storage<size_t> m_order;
+    size_t m_offset;
+    size_t m_batch;
+
+    /// Gather the rows of the current batch.
+    void gather();
+};
+
 }
 
 #if defined NN_REAL_T && !defined NN_IMPL
     extern template class nnlib::Batcher<NN_REAL_T>;
     extern template class nnlib::SequenceBatcher<NN_REAL_T>;
+    extern template class nnlib::SparseBatcher<NN_REAL_T>;
 #elif !defined NN_IMPL
     #include "detail/batcher.tpp"
 #endif
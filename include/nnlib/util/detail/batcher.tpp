@@ -3,6 +3,7 @@
 
 #include "../batcher.hpp"
 #include "nnlib/math/random.hpp"
+#include <utility>
 
 namespace nnlib
 {
@@ -215,6 +216,111 @@ Tensor<T> &SequenceBatcher<T>::allLabels()
     return m_lab;
 }
 
+template <typename T>
+SparseBatcher<T>::SparseBatcher(const SparseTensor<T> &feat, const Tensor<T> &lab, size_t bats) :
+    m_feat(feat),
+    m_lab(lab.copy()),
+    m_featBatch(0, feat.size(1)),
+    m_labBatch(bats, lab.size(1)),
+    m_order(feat.size(0)),
+    m_batch(bats)
+{
+    NNHardAssertEquals(lab.dims(), 2, "Invalid labels!");
+    NNHardAssertEquals(feat.size(0), lab.size(0), "Incompatible features and labels!");
+    NNHardAssertLessThanOrEquals(bats, feat.size(0), "Invalid batch size!");
+    for(size_t i = 0; i < m_order.size(); ++i)
+        m_order[i] = i;
+    reset();
+}
+
+template <typename T>
+SparseBatcher<T> &SparseBatcher<T>::batch(size_t bats)
+{
+    NNAssertLessThanOrEquals(bats, m_feat.size(0), "Invalid batch size!");
+    m_batch = bats;
+    m_labBatch.resizeDim(0, bats);
+    reset();
+    return *this;
+}
+
+template <typename T>
+size_t SparseBatcher<T>::batch() const
+{
+    return m_batch;
+}
+
+template <typename T>
+size_t SparseBatcher<T>::batches() const
+{
+    return m_feat.size(0) / m_batch;
+}
+
+template <typename T>
+SparseBatcher<T> &SparseBatcher<T>::reset()
+{
+    m_offset = 0;
+    for(size_t i = 0, end = m_order.size(); i < end; ++i)
+    {
+        size_t j = Random<size_t>::sharedRandom().uniform(end);
+        std::swap(m_order[i], m_order[j]);
+    }
+
+    gather();
+    return *this;
+}
+
+template <typename T>
+bool SparseBatcher<T>::next(bool autoReset)
+{
+    m_offset += m_batch;
+    if(m_offset + m_batch > m_feat.size(0))
+    {
+        if(autoReset)
+            reset();
+        else
+            return false;
+    }
+
+    gather();
+    return true;
+}
+
+template <typename T>
+SparseTensor<T> &SparseBatcher<T>::features()
+{
+    return m_featBatch;
+}
+
+template <typename T>
+Tensor<T> &SparseBatcher<T>::labels()
+{
+    return m_labBatch;
+}
+
+template <typename T>
+SparseTensor<T> &SparseBatcher<T>::allFeatures()
+{
+    return m_feat;
+}
+
+template <typename T>
+Tensor<T> &SparseBatcher<T>::allLabels()
+{
+    return m_lab;
+}
+
+template <typename T>
+void SparseBatcher<T>::gather()
+{
+    m_featBatch.resize(0, m_feat.size(1));
+    for(size_t i = 0; i < m_batch; ++i)
+    {
+        size_t row = m_order[m_offset + i];
+        m_featBatch.appendRow(m_feat, row);
+        m_labBatch.select(0, i).copy(m_lab.select(0, row));
+    }
+}
+
 }
 
 #endif
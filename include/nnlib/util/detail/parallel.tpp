@@ -0,0 +1,109 @@
+#ifndef UTIL_PARALLEL_TPP
+#define UTIL_PARALLEL_TPP
+
+#include "../parallel.hpp"
+#include "../../math/random.hpp"
+#include <exception>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace nnlib
+{
+
+namespace detail
+{
+
+/// Shared implementation of parallelFor and parallelForUnseeded.
+template <typename F>
+void parallelFor(size_t n, size_t threads, bool seeded, F &&fn)
+{
+    NNHardAssertGreaterThan(threads, 0, "Expected at least one thread!");
+
+    if(threads > n)
+        threads = n;
+
+    if(threads <= 1)
+    {
+        if(n > 0)
+            fn(0, n, 0);
+        return;
+    }
+
+    // derive the worker key from the calling thread's engine so successive regions differ
+    uint64_t key = 0;
+    if(seeded)
+    {
+        Philox &parent = RandomEngine::threadEngine().philox();
+        key = parent();
+        key = (key << 32) | parent();
+    }
+
+    std::vector<std::exception_ptr> errors(threads);
+    auto run = [&](size_t begin, size_t end, size_t thread)
+    {
+        try
+        {
+            fn(begin, end, thread);
+        }
+        catch(...)
+        {
+            errors[thread] = std::current_exception();
+        }
+    };
+
+    auto worker = [&](size_t thread)
+    {
+        size_t chunk = n / threads, extra = n % threads;
+        size_t begin = thread * chunk + (thread < extra ? thread : extra);
+        size_t end = begin + chunk + (thread < extra ? 1 : 0);
+
+        if(!seeded)
+        {
+            run(begin, end, thread);
+            return;
+        }
+
+        RandomEngine engine(key, thread);
+        RandomEngine *previous = RandomEngine::bindThreadEngine(&engine);
+        run(begin, end, thread);
+        RandomEngine::bindThreadEngine(previous);
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for(size_t i = 1; i < threads; ++i)
+        pool.emplace_back(worker, i);
+
+    worker(0);
+
+    for(std::thread &t : pool)
+        t.join();
+
+    for(std::exception_ptr &e : errors)
+        if(e)
+            std::rethrow_exception(e);
+}
+
+}
+
+template <typename F>
+void parallelFor(size_t n, size_t threads, F &&fn)
+{
+    detail::parallelFor(n, threads, true, std::forward<F>(fn));
+}
+
+template <typename F>
+void parallelForUnseeded(size_t n, size_t threads, F &&fn)
+{
+    detail::parallelFor(n, threads, false, std::forward<F>(fn));
+}
+
+inline size_t hardwareThreads()
+{
+    size_t threads = std::thread::hardware_concurrency();
+    return threads > 0 ? threads : 1;
+}
+}
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef UTIL_PARALLEL_HPP
+#define UTIL_PARALLEL_HPP
+
+#include <cstddef>
+
+namespace nnlib
+{
+
+/// \brief Run fn(begin, end, thread) over [0, n), split into one contiguous range per thread.
+///
+/// The ranges depend only on n and threads. Each worker has its own RandomEngine bound for the
+/// duration of the call, keyed on a value drawn from the calling thread's engine, with the worker
+/// index as its stream. Random draws made through Random<T>::sharedRandom() inside fn are therefore
+/// bitwise reproducible for a given seed and thread count. With one thread, fn runs inline on the
+/// calling thread's engine. The first exception thrown by a worker is rethrown after all have joined.
+template <typename F>
+void parallelFor(size_t n, size_t threads, F &&fn);
+
+/// \brief Run fn(begin, end, thread) over [0, n) like parallelFor, without touching any random engine.
+///
+/// For kernels that make no random draws, so that running them in parallel leaves the calling
+/// thread's random sequence exactly as a serial run would. fn must not draw random numbers.
+template <typename F>
+void parallelForUnseeded(size_t n, size_t threads, F &&fn);
+
+/// The number of threads to use when a caller asks for as many as are useful; at least one.
+size_t hardwareThreads();
+
+}
+
+#include "detail/parallel.tpp"
+
+#endif
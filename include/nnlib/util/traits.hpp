@@ -1,6 +1,7 @@
 #ifndef UTIL_TRAITS_HPP
 #define UTIL_TRAITS_HPP
 
+#include <string>
 #include <typeindex>
 #include <type_traits>
 #include <unordered_map>
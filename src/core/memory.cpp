@@ -0,0 +1,7 @@
+#ifdef NN_REAL_T
+#define NN_IMPL
+
+#include "nnlib/core/memory.hpp"
+#include "nnlib/core/detail/memory.tpp"
+
+#endif
@@ -0,0 +1,9 @@
+#ifdef NN_REAL_T
+#define NN_IMPL
+
+#include "nnlib/core/sparse_tensor.hpp"
+#include "nnlib/core/detail/sparse_tensor.tpp"
+
+template class nnlib::SparseTensor<NN_REAL_T>;
+
+#endif
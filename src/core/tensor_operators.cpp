@@ -6,13 +6,8 @@
 
 template std::ostream &operator<<(std::ostream &, const nnlib::Tensor<NN_REAL_T> &);
 template nnlib::Tensor<NN_REAL_T> &operator+=(nnlib::Tensor<NN_REAL_T> &, const nnlib::Tensor<NN_REAL_T> &);
-template nnlib::Tensor<NN_REAL_T> operator+(const nnlib::Tensor<NN_REAL_T> &, const nnlib::Tensor<NN_REAL_T> &);
 template nnlib::Tensor<NN_REAL_T> &operator-=(nnlib::Tensor<NN_REAL_T> &, const nnlib::Tensor<NN_REAL_T> &);
-template nnlib::Tensor<NN_REAL_T> operator-(const nnlib::Tensor<NN_REAL_T> &, const nnlib::Tensor<NN_REAL_T> &);
 template nnlib::Tensor<NN_REAL_T> &operator*=(nnlib::Tensor<NN_REAL_T> &, NN_REAL_T);
-template nnlib::Tensor<NN_REAL_T> operator*(const nnlib::Tensor<NN_REAL_T> &, NN_REAL_T);
-template nnlib::Tensor<NN_REAL_T> operator*(NN_REAL_T, const nnlib::Tensor<NN_REAL_T> &);
 template nnlib::Tensor<NN_REAL_T> &operator/=(nnlib::Tensor<NN_REAL_T> &, NN_REAL_T);
-template nnlib::Tensor<NN_REAL_T> operator/(const nnlib::Tensor<NN_REAL_T> &, NN_REAL_T);
 
 #endif
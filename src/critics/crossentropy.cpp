@@ -0,0 +1,9 @@
+#ifdef NN_REAL_T
+#define NN_IMPL
+
+#include "nnlib/critics/crossentropy.hpp"
+#include "nnlib/critics/detail/crossentropy.tpp"
+
+template class nnlib::CrossEntropy<NN_REAL_T>;
+
+#endif
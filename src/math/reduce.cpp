@@ -0,0 +1,25 @@
+#ifdef NN_REAL_T
+#define NN_IMPL
+
+#include "nnlib/math/reduce.hpp"
+#include "nnlib/math/detail/reduce.tpp"
+
+namespace nnlib
+{
+
+namespace math
+{
+
+template Tensor<NN_REAL_T> &sum(const Tensor<NN_REAL_T> &, Tensor<NN_REAL_T> &, const Storage<size_t> &, size_t);
+template Tensor<NN_REAL_T> &mean(const Tensor<NN_REAL_T> &, Tensor<NN_REAL_T> &, const Storage<size_t> &, size_t);
+template Tensor<NN_REAL_T> &variance(const Tensor<NN_REAL_T> &, Tensor<NN_REAL_T> &, const Storage<size_t> &, bool, size_t);
+template Tensor<NN_REAL_T> &max(const Tensor<NN_REAL_T> &, Tensor<NN_REAL_T> &, const Storage<size_t> &, size_t);
+template Tensor<NN_REAL_T> &min(const Tensor<NN_REAL_T> &, Tensor<NN_REAL_T> &, const Storage<size_t> &, size_t);
+template Tensor<NN_REAL_T> &logsumexp(const Tensor<NN_REAL_T> &, Tensor<NN_REAL_T> &, const Storage<size_t> &, size_t);
+template Storage<size_t> &argmax(const Tensor<NN_REAL_T> &, Storage<size_t> &, size_t, size_t);
+
+} // namespace math
+
+} // namespace nnlib
+
+#endif
@@ -0,0 +1,9 @@
+#ifdef NN_REAL_T
+#define NN_IMPL
+
+#include "nnlib/nn/embedding.hpp"
+#include "nnlib/nn/detail/embedding.tpp"
+
+template class nnlib::Embedding<NN_REAL_T>;
+
+#endif
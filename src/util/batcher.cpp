@@ -6,5 +6,6 @@
 
 template class nnlib::Batcher<NN_REAL_T>;
 template class nnlib::SequenceBatcher<NN_REAL_T>;
+template class nnlib::SparseBatcher<NN_REAL_T>;
 
 #endif
@@ -0,0 +1,73 @@
+#include "../test_allocator.hpp"
+#include "nnlib/core/allocator.hpp"
+#include "nnlib/core/storage.hpp"
+#include <cstdint>
+using namespace nnlib;
+
+NNTestClassImpl(Allocator)
+{
+    NNTestMethod(AlignedAllocator)
+    {
+        NNTestParams(size_t)
+        {
+            for(size_t bytes : { 0, 1, 7, 64, 1000 })
+            {
+                void *ptr = AlignedAllocator::allocate(bytes);
+                NNTestEquals(reinterpret_cast<uintptr_t>(ptr) % NN_ALIGNMENT, 0ul);
+                NNTestEquals(AlignedAllocator::capacity(ptr), bytes);
+                AlignedAllocator::deallocate(ptr, bytes);
+            }
+
+            Storage<char> s(3), t(5);
+            NNTestEquals(reinterpret_cast<uintptr_t>(s.ptr()) % NN_ALIGNMENT, 0ul);
+            NNTestEquals(reinterpret_cast<uintptr_t>(t.ptr()) % NN_ALIGNMENT, 0ul);
+        }
+    }
+
+    NNTestMethod(PoolAllocator)
+    {
+        NNTestParams(size_t)
+        {
+            NNTestEquals(PoolAllocator::enabled(), false);
+            PoolAllocator::enable();
+
+            const int *first;
+            {
+                Storage<int> s(100, 1);
+                first = s.ptr();
+            }
+            NNTestGreaterThanOrEquals(PoolAllocator::cached(), 100 * sizeof(int));
+
+            // a request in the same bucket reuses the freed block without allocating
+            size_t allocations = test::allocations();
+            {
+                Storage<int> s(120, 2);
+                NNTestEquals(s.ptr(), first);
+            }
+            NNTestEquals(test::allocations(), allocations);
+
+            PoolAllocator::release();
+            NNTestEquals(PoolAllocator::cached(), 0ul);
+
+            PoolAllocator::enable(false);
+            NNTestEquals(PoolAllocator::enabled(), false);
+        }
+    }
+
+    NNTestMethod(Storage)
+    {
+        NNTestParams(size_t)
+        {
+            // growing keeps the existing elements
+            Storage<int, AlignedAllocator> s({ 1, 2, 3 });
+            s.resize(1000, 4);
+            NNTestEquals(s[0], 1);
+            NNTestEquals(s[2], 3);
+            NNTestEquals(s[999], 4);
+            NNTestEquals(reinterpret_cast<uintptr_t>(s.ptr()) % NN_ALIGNMENT, 0ul);
+
+            Storage<int, AlignedAllocator> t(s);
+            NNTestEquals(t, s);
+        }
+    }
+}
@@ -0,0 +1,96 @@
+#include "../test_fixed_tensor.hpp"
+#include "nnlib/core/fixed_tensor.hpp"
+#include "nnlib/math/math.hpp"
+using namespace nnlib;
+using T = NN_REAL_T;
+
+NNTestClassImpl(FixedTensor)
+{
+    NNTestMethod(FixedTensor)
+    {
+        NNTestParams()
+        {
+            FixedTensor<T, 2> empty;
+            NNTestEquals(empty.size(), 0);
+            NNTestEquals(empty.size(1), 0);
+        }
+
+        NNTestParams(size_t, size_t)
+        {
+            FixedTensor<T, 2> t(3, 4);
+            NNTestEquals(t.dims(), 2);
+            NNTestEquals(t.size(), 12);
+            NNTestEquals(t.size(0), 3);
+            NNTestEquals(t.stride(0), 4);
+            NNTestEquals(t.stride(1), 1);
+            NNTest(t.contiguous());
+        }
+
+        NNTestParams(const Tensor &)
+        {
+            Tensor<T> t = Tensor<T>({ 1, 2, 3, 4, 5, 6 }).resize(2, 3);
+            FixedTensor<T, 2> f = t.transpose();
+            NNTestEquals(f.size(0), 3);
+            NNTestEquals(f.size(1), 2);
+            NNTest(!f.contiguous());
+            NNTestAlmostEquals(f(2, 1), 6, 1e-12);
+
+            f(0, 1) = 42;
+            NNTestAlmostEquals(t(1, 0), 42, 1e-12);
+
+            Tensor<T> select = t.select(0, 1);
+            size_t allocations = test::allocations();
+            FixedTensor<T, 1> row = select;
+            NNTestEquals(test::allocations(), allocations);
+            NNTestAlmostEquals(row(2), 6, 1e-12);
+
+            bool ok = true;
+            try
+            {
+                FixedTensor<T, 3> wrong = t;
+            }
+            catch(const Error &)
+            {
+                ok = false;
+            }
+            NNTest(!ok);
+        }
+    }
+
+    NNTestMethod(operator Tensor)
+    {
+        NNTestParams()
+        {
+            FixedTensor<T, 2> f(2, 3);
+            Tensor<T> t = f;
+            NNTestEquals(t.dims(), 2);
+            NNTestEquals(t.size(1), 3);
+            math::fill(t, 7);
+            NNTestAlmostEquals(f(1, 2), 7, 1e-12);
+
+            Tensor<T> u = Tensor<T>(4, 5).narrow(1, 1, 2);
+            FixedTensor<T, 2> g = u;
+            Tensor<T> v = g;
+            NNTest(v.sharedWith(u));
+            NNTestEquals(v.stride(0), 5);
+            NNTest(!v.contiguous());
+            NNTestEquals(&v(3, 1), &u(3, 1));
+        }
+    }
+
+    NNTestMethod(forEach)
+    {
+        NNTestParams(std::function, FixedTensor &, Tensor &)
+        {
+            Tensor<T> t = Tensor<T>({ 1, 2, 3, 4, 5, 6 }).resize(2, 3);
+            Tensor<T> u = t.transpose().copy();
+            FixedTensor<T, 2> f = t, g = u.transpose();
+            forEach([](T &x, T y)
+            {
+                x += y;
+            }, f, g);
+            NNTestAlmostEquals(t(0, 0), 2, 1e-12);
+            NNTestAlmostEquals(t(1, 2), 12, 1e-12);
+        }
+    }
+}
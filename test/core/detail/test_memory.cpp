@@ -0,0 +1,102 @@
+#include "../test_memory.hpp"
+#include "nnlib/core/memory.hpp"
+#include "nnlib/core/storage.hpp"
+using namespace nnlib;
+
+NNTestClassImpl(Memory)
+{
+    NNTestMethod(enable)
+    {
+        NNTestParams(bool)
+        {
+            MemoryTracker::reset();
+            Storage<int> untracked(4);
+            NNTestEquals(MemoryTracker::total().allocations, 0ul);
+
+            MemoryTracker::enable();
+            NNTestEquals(MemoryTracker::enabled(), true);
+            {
+                Storage<int> s(4);
+                NNTestEquals(MemoryTracker::total().allocations, 1ul);
+                NNTestEquals(MemoryTracker::total().bytes, 4 * sizeof(int));
+            }
+            MemoryTracker::enable(false);
+            NNTestEquals(MemoryTracker::enabled(), false);
+
+            // buffers allocated while disabled are never counted
+            untracked.resize(16);
+            NNTestEquals(MemoryTracker::total().frees, 1ul);
+        }
+    }
+
+    NNTestMethod(total)
+    {
+        NNTestParams()
+        {
+            MemoryTracker::reset();
+            MemoryTracker::enable();
+            {
+                Storage<int> s(4);
+                Storage<int> t(s);
+                s.resize(8);
+                s.resize(2);
+                t.reserve(2);
+            }
+            MemoryTracker::enable(false);
+
+            MemoryStats stats = MemoryTracker::total();
+            NNTestEquals(stats.allocations, 3ul);
+            NNTestEquals(stats.frees, 3ul);
+            NNTestEquals(stats.bytes, 16 * sizeof(int));
+            NNTestEquals(stats.resident, 0ul);
+            NNTestEquals(stats.peak, 16 * sizeof(int));
+
+            MemoryTracker::reset();
+            NNTestEquals(MemoryTracker::total().bytes, 0ul);
+        }
+    }
+
+    NNTestMethod(stats)
+    {
+        NNTestParams(const void *)
+        {
+            int a, b;
+            MemoryTracker::reset();
+            MemoryTracker::enable();
+
+            Storage<int> s;
+            {
+                MemoryTracker::Scope scope(&a);
+                NNTestEquals(MemoryTracker::currentTag(), (const void *) &a);
+                s.resize(4);
+                {
+                    MemoryTracker::Scope inner(&b);
+                    Storage<int> t(2);
+                }
+                NNTestEquals(MemoryTracker::currentTag(), (const void *) &a);
+            }
+            NNTestEquals(MemoryTracker::currentTag(), (const void *) nullptr);
+
+            // frees are counted against the tag the buffer was allocated under
+            s.resize(8);
+            MemoryTracker::enable(false);
+
+            MemoryStats stats = MemoryTracker::stats(&a);
+            NNTestEquals(stats.allocations, 1ul);
+            NNTestEquals(stats.frees, 1ul);
+            NNTestEquals(stats.resident, 0ul);
+            NNTestEquals(stats.peak, 4 * sizeof(int));
+
+            stats = MemoryTracker::stats(&b);
+            NNTestEquals(stats.allocations, 1ul);
+            NNTestEquals(stats.frees, 1ul);
+            NNTestEquals(stats.peak, 2 * sizeof(int));
+
+            stats = MemoryTracker::stats(nullptr);
+            NNTestEquals(stats.allocations, 2ul);
+            NNTestEquals(stats.resident, 8 * sizeof(int));
+
+            MemoryTracker::reset();
+        }
+    }
+}
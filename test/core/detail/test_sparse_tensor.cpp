@@ -0,0 +1,94 @@
+#include "../test_sparse_tensor.hpp"
+#include "nnlib/core/sparse_tensor.hpp"
+#include <type_traits>
+using namespace nnlib;
+using T = NN_REAL_T;
+
+NNTestClassImpl(SparseTensor)
+{
+    NNTestMethod(SparseTensor)
+    {
+        NNTestParams(size_t, size_t)
+        {
+            SparseTensor<T> s(3, 1000000);
+            NNTestEquals(s.size(0), 3);
+            NNTestEquals(s.size(1), 1000000);
+            NNTestEquals(s.nonzeros(), 0);
+            NNTestEquals(s.offsets().size(), 4);
+            NNTest(!(std::is_convertible<size_t, SparseTensor<T>>::value));
+        }
+
+        NNTestParams(const Tensor &)
+        {
+            Tensor<T> dense = Tensor<T>({ 0, 2, 0, 0, 0, 0, 3, 0, 4 }).resize(3, 3);
+            SparseTensor<T> s(dense);
+            NNTestEquals(s.nonzeros(), 3);
+            NNTestEquals(s.offsets(), Storage<size_t>({ 0, 1, 1, 3 }));
+            NNTestEquals(s.indices(), Storage<size_t>({ 1, 0, 2 }));
+            NNTestEquals(s.values(), Storage<T>({ 2, 3, 4 }));
+        }
+
+        NNTestParams(size_t, const Storage<size_t> &, const Storage<size_t> &, const Storage<T> &)
+        {
+            SparseTensor<T> s(4, { 0, 2, 3 }, { 0, 3, 1 }, { 1, 2, 3 });
+            NNTestEquals(s.size(0), 2);
+            NNTestEquals(s.nonzeros(), 3);
+
+            bool ok = true;
+            try
+            {
+                SparseTensor<T> bad(2, { 0, 2, 3 }, { 0, 3, 1 }, { 1, 2, 3 });
+            }
+            catch(const Error &)
+            {
+                ok = false;
+            }
+            NNTest(!ok);
+        }
+    }
+
+    NNTestMethod(appendRow)
+    {
+        NNTestParams(const SparseTensor &, size_t)
+        {
+            SparseTensor<T> s(0, 5);
+            s.appendRow().append(4, 1).append(0, 2);
+            s.appendRow();
+            NNTestEquals(s.size(0), 2);
+            NNTestEquals(s.offsets(), Storage<size_t>({ 0, 2, 2 }));
+
+            SparseTensor<T> t(0, 5);
+            t.appendRow(s, 1).appendRow(s, 0);
+            NNTestEquals(t.offsets(), Storage<size_t>({ 0, 0, 2 }));
+            NNTestEquals(t.indices(), Storage<size_t>({ 4, 0 }));
+        }
+    }
+
+    NNTestMethod(resize)
+    {
+        NNTestParams(size_t, size_t)
+        {
+            SparseTensor<T> s(0, 5);
+            s.appendRow().append(1, 1);
+            s.resize(2, 3);
+            NNTestEquals(s.size(0), 2);
+            NNTestEquals(s.size(1), 3);
+            NNTestEquals(s.nonzeros(), 0);
+            NNTestEquals(s.offsets(), Storage<size_t>({ 0, 0, 0 }));
+        }
+    }
+
+    NNTestMethod(dense)
+    {
+        NNTestParams()
+        {
+            Tensor<T> dense = Tensor<T>({ 0, 2, 0, 0, 0, 0, 3, 0, 4 }).resize(3, 3);
+            Tensor<T> copy = SparseTensor<T>(dense).dense();
+            NNTestEquals(copy.shape(), dense.shape());
+            forEach([&](T actual, T expected)
+            {
+                NNTestEquals(actual, expected);
+            }, copy, dense);
+        }
+    }
+}
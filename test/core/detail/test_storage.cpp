@@ -1,6 +1,8 @@
 #include "../test_storage.hpp"
 #include "nnlib/core/storage.hpp"
 #include "nnlib/serialization/serialized.hpp"
+#include <cstdio>
+#include <fstream>
 using namespace nnlib;
 
 NNTestClassImpl(Storage)
@@ -85,6 +87,102 @@ NNTestClassImpl(Storage)
         }
     }
 
+    NNTestMethod(borrow)
+    {
+        NNTestParams(T *, size_t, const std::function &)
+        {
+            int values[] = { 0, 1, 2, 3 };
+            {
+                Storage<int> s = Storage<int>::borrow(values, 3);
+                NNTest(s.external());
+                NNTestEquals(s.ptr(), values);
+                s[1] = 5;
+                NNTestEquals(values[1], 5);
+            }
+            NNTestEquals(values[1], 5);
+
+            size_t deleted = 0;
+            {
+                Storage<int> s = Storage<int>::borrow(values, 4, [&](int *ptr)
+                {
+                    NNTestEquals(ptr, values);
+                    ++deleted;
+                });
+
+                Storage<int> t(std::move(s));
+                NNTestEquals(deleted, 0ul);
+
+                // growing moves the data into allocated memory and gives the buffer back
+                t.push(6);
+                NNTestEquals(deleted, 1ul);
+                NNTest(!t.external());
+                NNTestEquals(t, Storage<int>({ 0, 5, 2, 3, 6 }));
+            }
+            NNTestEquals(deleted, 1ul);
+        }
+    }
+
+#ifdef NN_MMAP
+    NNTestMethod(map)
+    {
+        NNTestParams(const std::string &, size_t, size_t, bool)
+        {
+            int values[] = { 7, 0, 1, 2, 3 };
+            std::ofstream("storage_map.bin", std::ios::binary).write(reinterpret_cast<const char *>(values), sizeof(values));
+
+            {
+                Storage<int> s = Storage<int>::map("storage_map.bin", sizeof(int), 4);
+                NNTest(s.external());
+                NNTest(!s.writable());
+                NNTestEquals(s, Storage<int>({ 0, 1, 2, 3 }));
+
+                // a copy is allocated normally
+                Storage<int> t(s);
+                NNTest(!t.external());
+                NNTest(t.writable());
+                NNTestEquals(t, s);
+            }
+
+            {
+                Storage<int> s = Storage<int>::map("storage_map.bin", 0, 5, true);
+                NNTest(s.writable());
+                s[0] = 8;
+                NNTestEquals(s[0], 8);
+
+                // growing moves the data into allocated memory
+                s.resize(10, 9);
+                NNTest(!s.external());
+                NNTestEquals(s[0], 8);
+                NNTestEquals(s[4], 3);
+                NNTestEquals(s[9], 9);
+            }
+
+            // copy-on-write changes are never written back
+            NNTestEquals(Storage<int>::map("storage_map.bin", 0, 1)[0], 7);
+
+            bool ok = true;
+            try
+            {
+                Storage<int>::map("storage_map.bin", 0, 6);
+                ok = false;
+            }
+            catch(const Error &e) {}
+            NNTest(ok);
+
+            // a size that wraps around when converted to bytes is still too large
+            try
+            {
+                Storage<int>::map("storage_map.bin", 0, size_t(-1) / sizeof(int) + 2);
+                ok = false;
+            }
+            catch(const Error &e) {}
+            NNTest(ok);
+
+            std::remove("storage_map.bin");
+        }
+    }
+#endif
+
     NNTestMethod(resize)
     {
         NNTestParams(size_t, const T &)
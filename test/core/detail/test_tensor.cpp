@@ -1,5 +1,8 @@
 #include "../test_tensor.hpp"
 #include "nnlib/core/tensor.hpp"
+#include "nnlib/math/math.hpp"
+#include <cstdio>
+#include <fstream>
 using namespace nnlib;
 using T = NN_REAL_T;
 
@@ -62,6 +65,97 @@ NNTestClassImpl(Tensor)
         }
     }
 
+    NNTestMethod(borrow)
+    {
+        NNTestParams(T *, const Storage<size_t> &, const Storage<size_t> &, const std::function &)
+        {
+            T values[] = { 0, 1, 2, 3, 4, 5 };
+            Tensor<T> t = Tensor<T>::borrow(values, { 2, 3 });
+            NNTest(t.contiguous());
+            NNTestEquals(t.ptr(), values);
+            NNTestEquals(t(1, 2), 5);
+
+            // views and math write straight through to the buffer
+            math::scale(t.select(0, 1).narrow(0, 1, 2), 2);
+            NNTestEquals(values[4], 8);
+            NNTestEquals(values[5], 10);
+
+            size_t deleted = 0;
+            {
+                // a column-major 3x2 matrix over the same buffer
+                Tensor<T> u = Tensor<T>::borrow(values, { 3, 2 }, { 1, 3 }, [&](T *) { ++deleted; });
+                NNTest(!u.contiguous());
+                NNTestEquals(u(2, 0), 2);
+                NNTestEquals(u(1, 1), 8);
+
+                Tensor<T> column = u.select(1, 1);
+                u = Tensor<T>();
+                NNTestEquals(deleted, 0ul);
+                NNTestEquals(column(2), 10);
+            }
+            NNTestEquals(deleted, 1ul);
+        }
+    }
+
+#ifdef NN_MMAP
+    NNTestMethod(map)
+    {
+        NNTestParams(const std::string &, bool)
+        {
+            Tensor<T> t = Tensor<T>({ 0, 1, 2, 3, 4, 5 }).view(2, 3);
+            t.transpose().write("tensor_map.bin");
+
+            Tensor<T> u = Tensor<T>::map("tensor_map.bin");
+            NNTestEquals(u.shape(), Storage<size_t>({ 3, 2 }));
+            for(size_t i = 0; i < 3; ++i)
+                for(size_t j = 0; j < 2; ++j)
+                    NNTestEquals(u(i, j), t(j, i));
+            NNTestEquals(reinterpret_cast<uintptr_t>(u.ptr()) % 64, 0ul);
+
+            Tensor<T> v = Tensor<T>::map("tensor_map.bin", true);
+            forEach([](T &x) { x = 1; }, v);
+            NNTestEquals(u(2, 1), 5);
+
+            // corrupt headers claiming too many dimensions or elements are rejected before mapping
+            bool ok = true;
+            uint64_t dims = 33, huge = uint64_t(1) << 33;
+            for(size_t offset : { 16, 24 })
+            {
+                t.write("tensor_map.bin");
+                std::fstream file("tensor_map.bin", std::ios::in | std::ios::out | std::ios::binary);
+                file.seekp(offset);
+                if(offset == 16)
+                    file.write(reinterpret_cast<const char *>(&dims), sizeof(dims));
+                else
+                {
+                    file.write(reinterpret_cast<const char *>(&huge), sizeof(huge));
+                    file.write(reinterpret_cast<const char *>(&huge), sizeof(huge));
+                }
+                file.close();
+
+                try
+                {
+                    Tensor<T>::map("tensor_map.bin");
+                    ok = false;
+                }
+                catch(const Error &e) {}
+                NNTest(ok);
+            }
+
+            std::ofstream("tensor_map.bin") << "not a tensor file";
+            try
+            {
+                Tensor<T>::map("tensor_map.bin");
+                ok = false;
+            }
+            catch(const Error &e) {}
+            NNTest(ok);
+
+            std::remove("tensor_map.bin");
+        }
+    }
+#endif
+
     NNTestMethod(Tensor)
     {
         NNTestParams()
@@ -279,6 +373,14 @@ NNTestClassImpl(Tensor)
             NNTestEquals(t.size(), 6);
             NNTestEquals(t.size(0), 3);
             NNTestEquals(t.size(1), 2);
+
+            // neither the same shape nor a smaller one allocates
+            size_t allocations = test::allocations();
+            t.resize(3, 2);
+            t.resize(2, 2);
+            t.resize(3, 2);
+            NNTestEquals(test::allocations(), allocations);
+            NNTestEquals(t.stride(0), 2);
         }
     }
 
@@ -293,6 +395,14 @@ NNTestClassImpl(Tensor)
             t.resizeDim(0, 5);
             NNTestEquals(t.size(), 5);
             NNTestEquals(t.dims(), 1);
+
+            Tensor<T> m(4, 3);
+            size_t allocations = test::allocations();
+            m.resizeDim(0, 2);
+            m.resizeDim(1, 6);
+            NNTestEquals(test::allocations(), allocations);
+            NNTestEquals(m.size(), 12);
+            NNTestEquals(m.stride(0), 6);
         }
     }
 
@@ -490,6 +600,38 @@ NNTestClassImpl(Tensor)
         }
     }
 
+    NNTestMethod(broadcast)
+    {
+        NNTestParams(const Storage<size_t> &)
+        {
+            Tensor<T> t = Tensor<T>({ 1, 2, 3 }).resize(3, 1);
+            Tensor<T> v = t.broadcast({ 2, 3, 4 });
+            NNTestEquals(v.dims(), 3);
+            NNTestEquals(v.size(), 24);
+            NNTestEquals(v.stride(0), 0);
+            NNTestEquals(v.stride(2), 0);
+            for(size_t i = 0; i < 2; ++i)
+                for(size_t j = 0; j < 3; ++j)
+                    for(size_t k = 0; k < 4; ++k)
+                        NNTestEquals(&v(i, j, k), &t(j, 0));
+
+            const Tensor<T> &u = const_cast<const Tensor<T> &>(t).broadcast({ 3, 2 });
+            NNTestEquals(u.size(1), 2);
+            NNTestEquals(&u(2, 1), &t(2, 0));
+
+            bool ok = true;
+            try
+            {
+                t.broadcast({ 2, 2 });
+            }
+            catch(const Error &)
+            {
+                ok = false;
+            }
+            NNTest(!ok);
+        }
+    }
+
     NNTestMethod(sub)
     {
         NNTestParams(Tensor &, const std::initializer_list<const std::initializer_list<size_t>> &)
@@ -561,6 +703,38 @@ NNTestClassImpl(Tensor)
             NNTestEquals(s.dims(), 1);
             for(size_t i = 0; i < 6; ++i)
                 NNTestEquals(s(i), i);
+
+            Tensor<T> u = Tensor<T>(4, 6).narrow(1, 1, 3);
+            Tensor<T> v = t.view(3, 2).transpose();
+            u.narrow(0, 1, 2).copy(v);
+            NNTestEquals(u(1, 0), 0);
+            NNTestEquals(u(1, 2), 4);
+            NNTestEquals(u(2, 0), 1);
+            NNTestEquals(u(2, 2), 5);
+        }
+
+        NNTestParams(const Tensor &, size_t)
+        {
+            Tensor<T> t(3, 40);
+            for(size_t i = 0; i < t.size(); ++i)
+                t.data()[i] = i;
+
+            Tensor<T> s(40, 3);
+            s.copy(t.transpose());
+            NNTestEquals(s(0, 2), t(2, 0));
+            NNTestEquals(s(39, 1), t(1, 39));
+
+            Tensor<T> r = Tensor<T>(3, 50).narrow(1, 5, 40);
+            r.copy(t, 2);
+            NNTestEquals(r(2, 39), t(2, 39));
+
+            Tensor<T> big(1 << 19), copied(1 << 19);
+            for(size_t i = 0; i < big.size(); ++i)
+                big(i) = i;
+            copied.copy(big, 4);
+            NNTestEquals(copied(0), 0);
+            NNTestEquals(copied(123456), 123456);
+            NNTestEquals(copied((1 << 19) - 1), (1 << 19) - 1);
         }
     }
 
@@ -679,17 +853,19 @@ NNTestClassImpl(Tensor)
 
     NNTestMethod(makeContiguous)
     {
-        NNTestParams()
+        NNTestParams(size_t)
         {
             Tensor<T> t(3, 2);
             T *ptr = t.ptr();
             t.makeContiguous();
             NNTestEquals(ptr, t.ptr());
+            t(2, 0) = 42;
             Tensor<T> s = t.transpose();
             ptr = s.ptr();
-            s.makeContiguous();
+            s.makeContiguous(2);
             NNTestNotEquals(ptr, s.ptr());
             NNTest(s.contiguous());
+            NNTestEquals(s(0, 2), 42);
         }
     }
 
@@ -93,4 +93,48 @@ NNTestClassImpl(TensorIterator)
             NNTest(++itr3 != itr4);
         }
     }
+
+    NNTestMethod(runLength)
+    {
+        NNTestParams()
+        {
+            Tensor<T> t(4, 3, 5);
+            NNTestEquals(t.begin().runLength(), 60);
+            NNTestEquals(t.begin().runStride(), 1);
+
+            Tensor<T> s = t.narrow(1, 1, 2);
+            TensorIterator<T> itr(&s);
+            NNTestEquals(itr.runLength(), 10);
+            ++itr;
+            NNTestEquals(itr.runLength(), 9);
+
+            Tensor<T> u = t.select(2, 0);
+            NNTestEquals(u.begin().runLength(), 12);
+            NNTestEquals(u.begin().runStride(), 5);
+        }
+    }
+
+    NNTestMethod(nextRun)
+    {
+        NNTestParams()
+        {
+            Tensor<T> t(4, 3, 5);
+            Tensor<T> s = t.narrow(1, 1, 2);
+            size_t runs = 0, elements = 0;
+            for(TensorIterator<T> itr = s.begin(), end = s.end(); itr != end; itr.nextRun())
+            {
+                NNTestEquals(&*itr, &s(runs, 0, 0));
+                elements += itr.runLength();
+                ++runs;
+            }
+            NNTestEquals(runs, 4);
+            NNTestEquals(elements, s.size());
+
+            TensorIterator<T> itr = s.begin();
+            itr.advance(3);
+            NNTestEquals(&*itr, &s(0, 0, 3));
+            itr.advance(7);
+            NNTestEquals(&*itr, &s(1, 0, 0));
+        }
+    }
 }
@@ -1,5 +1,6 @@
 #include "../test_tensor_operators.hpp"
 #include "nnlib/core/detail/tensor_operators.hpp"
+#include "nnlib/math/math.hpp"
 #include <sstream>
 using namespace nnlib;
 using T = NN_REAL_T;
@@ -29,6 +30,14 @@ NNTestClassImpl(TensorOperators)
             NNTestEquals(&(t += s), &t);
             NNTestAlmostEquals(t(0), 2, 1e-12);
         }
+
+        NNTestParams(Tensor &, const TensorExpression &)
+        {
+            Tensor<T> t({ 1, 2 }), s({ 3, 4 });
+            NNTestEquals(&(t += s * 2 - t), &t);
+            NNTestAlmostEquals(t(0), 6, 1e-12);
+            NNTestAlmostEquals(t(1), 8, 1e-12);
+        }
     }
 
     NNTestMethod(operator+)
@@ -44,6 +53,87 @@ NNTestClassImpl(TensorOperators)
             NNTest(!u.sharedWith(t));
             NNTest(!u.sharedWith(s));
         }
+
+        NNTestParams(const TensorExpression &, const TensorExpression &)
+        {
+            Tensor<T> a = Tensor<T>({ 1, 2, 3, 4, 5, 6 }).resize(2, 3);
+            Tensor<T> b = Tensor<T>({ 6, 5, 4, 3, 2, 1 }).resize(3, 2).transpose();
+            Tensor<T> c = math::fill(Tensor<T>(3, 4), 1).narrow(1, 0, 3).narrow(0, 1, 2);
+            Tensor<T> u = a * 2 + b - 0.5 * c;
+            NNTestEquals(u.shape(), a.shape());
+            NNTestAlmostEquals(u(0, 0), 7.5, 1e-12);
+            NNTestAlmostEquals(u(0, 1), 7.5, 1e-12);
+            NNTestAlmostEquals(u(0, 2), 7.5, 1e-12);
+            NNTestAlmostEquals(u(1, 0), 12.5, 1e-12);
+            NNTestAlmostEquals(u(1, 1), 12.5, 1e-12);
+            NNTestAlmostEquals(u(1, 2), 12.5, 1e-12);
+
+            Tensor<T> v = Tensor<T>(3, 3).narrow(1, 1, 2).transpose();
+            v = a * 2 + b - 0.5 * c;
+            NNTestEquals(v.shape(), a.shape());
+            NNTestAlmostEquals(v(1, 2), 12.5, 1e-12);
+
+            bool ok = true;
+            try
+            {
+                a + a.transpose();
+            }
+            catch(const Error &e)
+            {
+                ok = false;
+            }
+            NNTest(!ok);
+        }
+
+        NNTestParams(Tensor &, const TensorExpression &)
+        {
+            Tensor<T> a({ 1, 2, 3 }), b({ 4, 5, 6 }), c({ 7, 8, 9 });
+            T *ptr = c.ptr();
+            size_t allocations = test::allocations();
+            c = a * 2 + b - c;
+            NNTestEquals(test::allocations(), allocations);
+            NNTestEquals(c.ptr(), ptr);
+            NNTestAlmostEquals(c(0), -1, 1e-12);
+            NNTestAlmostEquals(c(1), 1, 1e-12);
+            NNTestAlmostEquals(c(2), 3, 1e-12);
+        }
+
+        NNTestParams(Tensor &, const TensorExpression &)
+        {
+            Tensor<T> a = math::fill(Tensor<T>(2, 2), 0);
+            Tensor<T> c = Tensor<T>({ 1, 2, 3, 4 }).resize(2, 2);
+            c = c.transpose() + a;
+            NNTestAlmostEquals(c(0, 0), 1, 1e-12);
+            NNTestAlmostEquals(c(0, 1), 3, 1e-12);
+            NNTestAlmostEquals(c(1, 0), 2, 1e-12);
+            NNTestAlmostEquals(c(1, 1), 4, 1e-12);
+
+            c += c.transpose() + a;
+            NNTestAlmostEquals(c(0, 1), 5, 1e-12);
+            NNTestAlmostEquals(c(1, 0), 5, 1e-12);
+
+            // disjoint views of one buffer need no temporary
+            Tensor<T> top = c.narrow(0, 0, 1), bottom = c.narrow(0, 1, 1);
+            size_t allocations = test::allocations();
+            top = bottom * 2;
+            NNTestEquals(test::allocations(), allocations);
+            NNTestAlmostEquals(c(0, 0), 10, 1e-12);
+            NNTestAlmostEquals(c(0, 1), 16, 1e-12);
+        }
+
+        NNTestParams(Tensor &, const TensorExpression &)
+        {
+            // resizing the destination must not disturb an operand in the same storage
+            Tensor<T> buffer({ 1, 2, 3, 4, 5, 6 });
+            Tensor<T> dst = buffer.narrow(0, 0, 2);
+            dst = buffer.narrow(0, 2, 3) * 2;
+            NNTestEquals(dst.shape(), Storage<size_t>({ 3 }));
+            NNTestAlmostEquals(dst(0), 6, 1e-12);
+            NNTestAlmostEquals(dst(1), 8, 1e-12);
+            NNTestAlmostEquals(dst(2), 10, 1e-12);
+            for(size_t i = 0; i < 6; ++i)
+                NNTestAlmostEquals(buffer(i), i + 1, 1e-12);
+        }
     }
 
     NNTestMethod(operator-=)
@@ -54,6 +144,14 @@ NNTestClassImpl(TensorOperators)
             NNTestEquals(&(t -= s), &t);
             NNTestAlmostEquals(t(0), -2, 1e-12);
         }
+
+        NNTestParams(Tensor &, const TensorExpression &)
+        {
+            Tensor<T> t({ 1, 2 }), s({ 3, 4 });
+            NNTestEquals(&(t -= s / 2 + t), &t);
+            NNTestAlmostEquals(t(0), -1.5, 1e-12);
+            NNTestAlmostEquals(t(1), -2, 1e-12);
+        }
     }
 
     NNTestMethod(operator-)
@@ -58,4 +58,51 @@ NNTestClassImpl(TensorUtil)
             {}
         }
     }
+
+    NNTestMethod(forEachBroadcast)
+    {
+        NNTestParams(std::function, Tensor &)
+        {
+            Tensor<T> x = Tensor<T>({ 1, 2, 3, 4, 5, 6 }).resize(2, 3);
+            Tensor<T> row({ 10, 20, 30 });
+            Tensor<T> column = Tensor<T>({ 100, 200 }).resize(2, 1);
+            Tensor<T> y(2, 3);
+            forEachBroadcast([](T x, T r, T c, T &y)
+            {
+                y = x + r + c;
+            }, x, row, column, y);
+            NNTestAlmostEquals(y(0, 0), 111, 1e-12);
+            NNTestAlmostEquals(y(0, 2), 133, 1e-12);
+            NNTestAlmostEquals(y(1, 0), 214, 1e-12);
+            NNTestAlmostEquals(y(1, 2), 236, 1e-12);
+
+            Tensor<T> transposed = x.transpose();
+            Tensor<T> sums({ 0, 0 });
+            forEachBroadcast([](T x, T &sum)
+            {
+                sum += x;
+            }, transposed, sums.resize(1, 2));
+            NNTestAlmostEquals(sums(0, 0), 6, 1e-12);
+            NNTestAlmostEquals(sums(0, 1), 15, 1e-12);
+
+            size_t allocations = test::allocations();
+            forEachBroadcast([](T &y, T r)
+            {
+                y *= r;
+            }, y, row);
+            NNTestEquals(test::allocations(), allocations);
+            NNTestAlmostEquals(y(1, 2), 236 * 30, 1e-12);
+
+            bool ok = true;
+            try
+            {
+                forEachBroadcast([](T, T){}, x, Tensor<T>(2));
+            }
+            catch(const Error &)
+            {
+                ok = false;
+            }
+            NNTest(!ok);
+        }
+    }
 }
@@ -0,0 +1,7 @@
+#ifndef TEST_ALLOCATOR_HPP
+#define TEST_ALLOCATOR_HPP
+
+#include "../test.hpp"
+NNTestClassDecl(Allocator);
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef TEST_FIXED_TENSOR_HPP
+#define TEST_FIXED_TENSOR_HPP
+
+#include "../test.hpp"
+NNTestClassDecl(FixedTensor);
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef TEST_MEMORY_HPP
+#define TEST_MEMORY_HPP
+
+#include "../test.hpp"
+NNTestClassDecl(Memory);
+
+#endif
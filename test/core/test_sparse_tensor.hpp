@@ -0,0 +1,7 @@
+#ifndef TEST_SPARSE_TENSOR_HPP
+#define TEST_SPARSE_TENSOR_HPP
+
+#include "../test.hpp"
+NNTestClassDecl(SparseTensor);
+
+#endif
@@ -0,0 +1,112 @@
+#include "../test_crossentropy.hpp"
+#include "nnlib/critics/crossentropy.hpp"
+#include "nnlib/critics/nll.hpp"
+#include "nnlib/math/math.hpp"
+#include "nnlib/nn/logsoftmax.hpp"
+using namespace nnlib;
+using T = NN_REAL_T;
+
+NNTestClassImpl(CrossEntropy)
+{
+    NNTestMethod(CrossEntropy)
+    {
+        NNTestParams()
+        {
+            CrossEntropy<T> critic;
+            NNTestEquals(critic.average(), true);
+        }
+
+        NNTestParams(bool)
+        {
+            CrossEntropy<T> critic(false);
+            NNTestEquals(critic.average(), false);
+        }
+    }
+
+    NNTestMethod(average)
+    {
+        NNTestParams(bool)
+        {
+            CrossEntropy<T> critic;
+            NNTestEquals(&critic.average(false), &critic);
+            NNTestEquals(critic.average(), false);
+        }
+    }
+
+    NNTestMethod(misclassifications)
+    {
+        NNTestParams(const Tensor<T> &, const Tensor<T> &)
+        {
+            CrossEntropy<T> critic;
+            Tensor<T> inputs = Tensor<T>({
+                3.0, -1.0, 0.5, 1.0,
+                0.7, 2.2, -0.7, 0.0,
+                -0.6, 0.6, 4.3, 0.6
+            }).resize(3, 4);
+            Tensor<T> target = Tensor<T>({ 0, 1, 3 }).resize(3, 1);
+            NNTestEquals(critic.misclassifications(inputs, target), 1);
+        }
+    }
+
+    NNTestMethod(forward)
+    {
+        NNTestParams(const Tensor &, const Tensor &)
+        {
+            Tensor<T> inputs = Tensor<T>({
+                3.0, -1.0, 0.5, 1.0,
+                0.7, 2.2, -0.7, 0.0,
+                -0.6, 0.6, 4.3, 0.6
+            }).resize(3, 4);
+            Tensor<T> target = Tensor<T>({ 0, 1, 3 }).resize(3, 1);
+
+            for(bool average : { false, true })
+            {
+                CrossEntropy<T> critic(average);
+                NLL<T> nll(average);
+                LogSoftMax<T> logSoftMax;
+                NNTestAlmostEquals(critic.forward(inputs, target), nll.forward(logSoftMax.forward(inputs), target), 1e-12);
+            }
+
+            CrossEntropy<T> critic(false);
+            Tensor<T> large = Tensor<T>({ 1000, 1001, 999, -1000, 1000, 1000 }).resize(2, 3);
+            Tensor<T> largeTarget = Tensor<T>({ 1, 1 }).resize(2, 1);
+            NNTestAlmostEquals(critic.forward(large, largeTarget), 0.40760596 + 0.69314718, 1e-6);
+        }
+    }
+
+    NNTestMethod(backward)
+    {
+        NNTestParams(const Tensor &, const Tensor &)
+        {
+            Tensor<T> inputs = Tensor<T>({
+                3.0, -1.0, 0.5, 1.0,
+                0.7, 2.2, -0.7, 0.0,
+                -0.6, 0.6, 4.3, 0.6
+            }).resize(3, 4);
+            Tensor<T> target = Tensor<T>({ 0, 1, 3 }).resize(3, 1);
+
+            for(bool average : { false, true })
+            {
+                CrossEntropy<T> critic(average);
+                NLL<T> nll(average);
+                LogSoftMax<T> logSoftMax;
+
+                logSoftMax.forward(inputs);
+                nll.backward(logSoftMax.output(), target);
+                logSoftMax.backward(inputs, nll.inGrad());
+
+                forEach([&](T actual, T expected)
+                {
+                    NNTestAlmostEquals(actual, expected, 1e-12);
+                }, critic.backward(inputs, target), logSoftMax.inGrad());
+            }
+
+            CrossEntropy<T> critic(false);
+            Tensor<T> large = Tensor<T>({ 1000, 1000 }).resize(1, 2);
+            Tensor<T> largeTarget = Tensor<T>({ 1 }).resize(1, 1);
+            critic.backward(large, largeTarget);
+            NNTestAlmostEquals(critic.inGrad()(0, 0), 0.5, 1e-12);
+            NNTestAlmostEquals(critic.inGrad()(0, 1), -0.5, 1e-12);
+        }
+    }
+}
@@ -0,0 +1,7 @@
+#ifndef TEST_CROSSENTROPY_HPP
+#define TEST_CROSSENTROPY_HPP
+
+#include "../test.hpp"
+NNTestClassDecl(CrossEntropy);
+
+#endif
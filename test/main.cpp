@@ -5,23 +5,32 @@
 #endif
 
 #include "test.hpp"
+#include "core/test_allocator.hpp"
 #include "core/test_error.hpp"
+#include "core/test_fixed_tensor.hpp"
+#include "core/test_memory.hpp"
+#include "core/test_sparse_tensor.hpp"
 #include "core/test_storage.hpp"
 #include "core/test_tensor.hpp"
 #include "core/test_tensor_iterator.hpp"
 #include "core/test_tensor_operators.hpp"
 #include "core/test_tensor_util.hpp"
 #include "critics/test_criticsequencer.hpp"
+#include "critics/test_crossentropy.hpp"
 #include "critics/test_mse.hpp"
 #include "critics/test_nll.hpp"
 #include "math/test_algebra.hpp"
+#include "math/test_bitmask.hpp"
 #include "math/test_math.hpp"
 #include "math/test_random.hpp"
+#include "math/test_reduce.hpp"
+#include "math/test_vecmath.hpp"
 #include "nn/test_batchnorm.hpp"
 #include "nn/test_concat.hpp"
 #include "nn/test_dropconnect.hpp"
 #include "nn/test_dropout.hpp"
 #include "nn/test_elu.hpp"
+#include "nn/test_embedding.hpp"
 #include "nn/test_identity.hpp"
 #include "nn/test_linear.hpp"
 #include "nn/test_logistic.hpp"
@@ -48,10 +57,34 @@
 #include "toy_problems/timeseries.hpp"
 #include "util/test_args.hpp"
 #include "util/test_batcher.hpp"
+#include "util/test_parallel.hpp"
 #include "util/test_progress.hpp"
 #include "util/test_timer.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
 #include <unordered_set>
 
+static std::atomic<size_t> allocationCount(0);
+
+size_t nnlib::test::allocations()
+{
+    return allocationCount;
+}
+
+void *operator new(size_t n)
+{
+    ++allocationCount;
+    if(void *ptr = std::malloc(n > 0 ? n : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
 #define RunTest(Class)                                         \
     if(tests.size() == 0 || tests.find(#Class) != tests.end()) \
         NNRunTest(Class);
@@ -80,7 +113,11 @@ int main(int argc, const char **argv)
     }
 
     // Core
+    RunTest(Allocator);
     RunTest(Error);
+    RunTest(FixedTensor);
+    RunTest(Memory);
+    RunTest(SparseTensor);
     RunTest(Storage);
     RunTest(Tensor);
     RunTest(TensorIterator);
@@ -89,13 +126,18 @@ int main(int argc, const char **argv)
 
     // Critics
     RunTest(CriticSequencer);
+    RunTest(CrossEntropy);
     RunTest(MSE);
     RunTest(NLL);
 
     // Math
     RunTest(Algebra);
+    RunTest(BitMask);
     RunTest(Math);
+    RunTest(Philox);
     RunTest(Random);
+    RunTest(Reduce);
+    RunTest(VecMath);
 
     // Neural Network Modules
     RunTest(BatchNorm);
@@ -103,6 +145,7 @@ int main(int argc, const char **argv)
     RunTest(DropConnect);
     RunTest(Dropout);
     RunTest(ELU);
+    RunTest(Embedding);
     RunTest(Identity);
     RunTest(Linear);
     RunTest(Logistic);
@@ -135,6 +178,8 @@ int main(int argc, const char **argv)
     RunTest(ArgsParser);
     RunTest(Batcher);
     RunTest(SequenceBatcher);
+    RunTest(SparseBatcher);
+    RunTest(Parallel);
     RunTest(Progress);
     RunTest(Timer);
 
@@ -1,5 +1,6 @@
 #include "../test_algebra.hpp"
 #include "nnlib/core/tensor.hpp"
+#include "nnlib/core/sparse_tensor.hpp"
 #include "nnlib/math/algebra.hpp"
 #include "nnlib/math/math.hpp"
 using namespace nnlib;
@@ -371,4 +372,64 @@ NNTestClassImpl(Algebra)
             }, C, D);
         }
     }
+
+    NNTestMethod(mAdd_sm)
+    {
+        NNTestParams(const SparseTensor &, const Tensor &, Tensor &, T, T)
+        {
+            Tensor<T> A = Tensor<T>({ 1, 0, 3, 0, 5, 0 }).resize(2, 3);
+            Tensor<T> B = Tensor<T>({ 7, 8, 9, 0, 1, 2 }).resize(3, 2);
+            Tensor<T> C = Tensor<T>({ 2, 4, 6, 8 }).resize(2, 2);
+            Tensor<T> D = Tensor<T>({ 2, 4, 6, 8 }).resize(2, 2);
+            mAdd_mm(A, B, D, 1, 0.5);
+            mAdd_sm(SparseTensor<T>(A), B, C, 1, 0.5);
+            forEach([&](T c, T d)
+            {
+                NNTestAlmostEquals(c, d, 1e-12);
+            }, C, D);
+        }
+
+        NNTestParams(const SparseTensor &, const Tensor &, Tensor &&, T, T)
+        {
+            Tensor<T> A = Tensor<T>({ 1, 0, 3, 0, 5, 0 }).resize(2, 3);
+            Tensor<T> B = Tensor<T>({ 7, 8, 9, 0, 1, 2 }).resize(3, 2);
+            Tensor<T> C = Tensor<T>({ 2, 4, 6, 8 }).resize(2, 2);
+            Tensor<T> D = Tensor<T>({ 0, 0, 0, 0 }).resize(2, 2);
+            mAdd_mm(A, B, D, 2, 0);
+            mAdd_sm(SparseTensor<T>(A), B, std::move(C), 2, 0);
+            forEach([&](T c, T d)
+            {
+                NNTestAlmostEquals(c, d, 1e-12);
+            }, C, D);
+        }
+    }
+
+    NNTestMethod(mAdd_stm)
+    {
+        NNTestParams(const SparseTensor &, const Tensor &, Tensor &, T, T)
+        {
+            Tensor<T> A = Tensor<T>({ 1, 0, 0, 5, 3, 0 }).resize(3, 2);
+            Tensor<T> B = Tensor<T>({ 7, 8, 9, 0, 1, 2 }).resize(3, 2);
+            Tensor<T> C = Tensor<T>({ 2, 4, 6, 8 }).resize(2, 2);
+            Tensor<T> D = Tensor<T>({ 2, 4, 6, 8 }).resize(2, 2);
+            mAdd_mtm(A, B, D, 1, 0.5);
+            mAdd_stm(SparseTensor<T>(A), B, C, 1, 0.5);
+            forEach([&](T c, T d)
+            {
+                NNTestAlmostEquals(c, d, 1e-12);
+            }, C, D);
+        }
+
+        NNTestParams(const SparseTensor &, const Tensor &, Tensor &&, T, T)
+        {
+            Tensor<T> A = Tensor<T>({ 1, 0, 0, 0, 3, 0 }).resize(3, 2);
+            Tensor<T> B = Tensor<T>({ 7, 8, 9, 0, 1, 2 }).resize(3, 2);
+            Tensor<T> C = Tensor<T>({ 2, 4, 6, 8 }).resize(2, 2);
+            mAdd_stm(SparseTensor<T>(A), B, std::move(C));
+            NNTestAlmostEquals(C(0, 0), 12, 1e-12);
+            NNTestAlmostEquals(C(0, 1), 18, 1e-12);
+            NNTestAlmostEquals(C(1, 0), 6, 1e-12);
+            NNTestAlmostEquals(C(1, 1), 8, 1e-12);
+        }
+    }
 }
@@ -0,0 +1,103 @@
+#include "../test_bitmask.hpp"
+#include "nnlib/core/tensor.hpp"
+#include "nnlib/math/bitmask.hpp"
+#include "nnlib/math/math.hpp"
+#include "nnlib/math/random.hpp"
+using namespace nnlib;
+using namespace nnlib::math;
+using T = NN_REAL_T;
+
+NNTestClassImpl(BitMask)
+{
+    NNTestMethod(BitMask)
+    {
+        NNTestParams(size_t)
+        {
+            BitMask m(130);
+            NNTestEquals(m.size(), 130);
+            m.fill(true);
+            NNTestEquals(m.count(), 130);
+            m.resize(3);
+            NNTestEquals(m.size(), 3);
+            NNTestEquals(m.count(), 3);
+        }
+    }
+
+    NNTestMethod(set)
+    {
+        NNTestParams(size_t, bool)
+        {
+            BitMask m(100);
+            m.fill(false);
+            m.set(0).set(63).set(64).set(99);
+            NNTest(m.get(0));
+            NNTest(!m.get(1));
+            NNTest(m.get(63));
+            NNTest(m.get(64));
+            NNTest(m.get(99));
+            NNTestEquals(m.count(), 4);
+            m.set(63, false);
+            NNTest(!m.get(63));
+            NNTestEquals(m.count(), 3);
+        }
+    }
+
+    NNTestMethod(bernoulli)
+    {
+        NNTestParams(double)
+        {
+            RandomEngine::sharedEngine().seed(0);
+            BitMask m(10000);
+            NNTestAlmostEquals(m.bernoulli(0.25).count(), 2500, 150);
+            NNTestEquals(m.bernoulli(0).count(), 0);
+            NNTestEquals(m.bernoulli(1).count(), 10000);
+
+            BitMask a(77), b(77);
+            RandomEngine::sharedEngine().seed(1);
+            a.bernoulli(0.5);
+            RandomEngine::sharedEngine().seed(1);
+            b.bernoulli(0.5);
+            for(size_t i = 0; i < 77; ++i)
+                NNTestEquals(a.get(i), b.get(i));
+        }
+    }
+
+    NNTestMethod(apply)
+    {
+        NNTestParams(const Tensor &, Tensor &, T, size_t)
+        {
+            BitMask m(8);
+            m.fill(false);
+            m.set(1).set(2).set(5);
+
+            Tensor<T> x = Tensor<T>({ 1, 2, 3, 4, 5, 6 }).resize(2, 3);
+            Tensor<T> y(2, 3);
+            m.apply(x, y, T(2));
+            Tensor<T> expected = Tensor<T>({ 0, 4, 6, 0, 0, 12 }).resize(2, 3);
+            forEach([&](T y, T expected)
+            {
+                NNTestAlmostEquals(y, expected, 1e-12);
+            }, y, expected);
+
+            Tensor<T> z(3, 2);
+            m.apply(x.transpose(), z, T(1), 2);
+            expected = Tensor<T>({ 1, 0, 0, 5, 0, 0 }).resize(3, 2);
+            forEach([&](T z, T expected)
+            {
+                NNTestAlmostEquals(z, expected, 1e-12);
+            }, z, expected);
+        }
+
+        NNTestParams(Tensor &, T, size_t)
+        {
+            BitMask m(3);
+            m.fill(false);
+            m.set(1);
+            Tensor<T> x({ 1, 2, 3 });
+            m.apply(x);
+            NNTestAlmostEquals(x(0), 0, 1e-12);
+            NNTestAlmostEquals(x(1), 2, 1e-12);
+            NNTestAlmostEquals(x(2), 0, 1e-12);
+        }
+    }
+}
@@ -32,6 +32,17 @@ NNTestClassImpl(Math)
             Tensor<T> x({ 8, -6, 7, 5, 3, 0, 9, 3.14159 });
             NNTestAlmostEquals(sum(x), 29.14159, 1e-12);
         }
+
+        NNTestParams(const TensorExpression &)
+        {
+            Tensor<T> x({ 8, -6, 7, 5, 3, 0, 9, 3.14159 });
+            Tensor<T> y({ 1, 1, 1, 1, 1, 1, 1, 1 });
+            NNTestAlmostEquals(sum(x * 2 - y), 50.28318, 1e-12);
+            NNTestAlmostEquals(mean(x * 2 - y), 6.2853975, 1e-12);
+            NNTestAlmostEquals(min(x * 2 - y), -13, 1e-12);
+            NNTestAlmostEquals(max(x * 2 - y), 17, 1e-12);
+            NNTestAlmostEquals(variance(x + y), variance(x), 1e-12);
+        }
     }
 
     NNTestMethod(mean)
@@ -243,7 +254,7 @@ NNTestClassImpl(Math)
         NNTestParams(Tensor &, T, T)
         {
             RandomEngine::sharedEngine().seed(0);
-            Tensor<T> x(1000);
+            Tensor<T> x(10000);
             randn(x, -1, 3.14);
             NNTestAlmostEquals(mean(x), -1, 0.5);
             NNTestAlmostEquals(variance(x), 9.8596, 0.5);
@@ -252,7 +263,7 @@ NNTestClassImpl(Math)
         NNTestParams(Tensor &&, T, T)
         {
             RandomEngine::sharedEngine().seed(0);
-            Tensor<T> x = randn(Tensor<T>(1000), -1, 3.14);
+            Tensor<T> x = randn(Tensor<T>(10000), -1, 3.14);
             NNTestAlmostEquals(mean(x), -1, 0.5);
             NNTestAlmostEquals(variance(x), 9.8596, 0.5);
         }
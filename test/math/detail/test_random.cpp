@@ -6,6 +6,74 @@ using namespace nnlib;
 using namespace nnlib::math;
 using T = NN_REAL_T;
 
+NNTestClassImpl(Philox)
+{
+    NNTestMethod(Philox)
+    {
+        NNTestParams(size_t, size_t)
+        {
+            // known answer for a zero key and zero counter
+            Philox p(0, 0);
+            NNTestEquals(p(), 0x6627e8d5);
+            NNTestEquals(p(), 0xe169c58d);
+            NNTestEquals(p(), 0xbc57ac4c);
+            NNTestEquals(p(), 0x9b00dbd8);
+
+            Philox q(1234, 5), r(1234, 5), s(1234, 6);
+            size_t different = 0;
+            for(size_t i = 0; i < 100; ++i)
+            {
+                uint32_t a = q(), b = r(), c = s();
+                NNTestEquals(a, b);
+                if(a != c)
+                    ++different;
+            }
+            NNTestGreaterThan(different, 90);
+        }
+    }
+
+    NNTestMethod(seed)
+    {
+        NNTestParams(size_t, size_t)
+        {
+            Philox p(1, 2);
+            uint32_t first = p();
+            p();
+            p.seed(1, 2);
+            NNTestEquals(p(), first);
+            NNTestEquals(p.stream(), 2);
+        }
+    }
+
+    NNTestMethod(discard)
+    {
+        NNTestParams(unsigned long long)
+        {
+            Philox p(7), q(7);
+            for(size_t i = 0; i < 11; ++i)
+                p();
+            q.discard(3);
+            q.discard(8);
+            NNTestEquals(p(), q());
+        }
+    }
+
+    NNTestMethod(generate)
+    {
+        NNTestParams(uint32_t *, size_t)
+        {
+            Philox p(42), q(42);
+            uint32_t values[23];
+            p();
+            p.generate(values, 10);
+            p.generate(values + 10, 13);
+            q();
+            for(size_t i = 0; i < 23; ++i)
+                NNTestEquals(values[i], q());
+        }
+    }
+}
+
 NNTestClassImpl(RandomEngine)
 {
     NNTestMethod(sharedEngine)
@@ -52,6 +120,26 @@ NNTestClassImpl(RandomEngine)
         }
     }
 
+    NNTestMethod(threadEngine)
+    {
+        NNTestParams()
+        {
+            NNTestEquals(&RandomEngine::threadEngine(), &RandomEngine::sharedEngine());
+
+            RandomEngine e(3, 1);
+            RandomEngine *previous = RandomEngine::bindThreadEngine(&e);
+            NNTestEquals(previous, nullptr);
+            NNTestEquals(&RandomEngine::threadEngine(), &e);
+
+            Random<T> r(new RandomEngine(3, 1));
+            T value = r.uniform();
+            NNTestEquals(Random<T>::sharedRandom().uniform(), value);
+
+            RandomEngine::bindThreadEngine(previous);
+            NNTestEquals(&RandomEngine::threadEngine(), &RandomEngine::sharedEngine());
+        }
+    }
+
     NNTestMethod(engine)
     {
         NNTestParams()
@@ -143,6 +231,15 @@ NNTestClassImpl(Random)
             NNTestAlmostEquals(mean(x), 100, 5);
             NNTestAlmostEquals(variance(x), 133.3333, 20);
         }
+        NNTestParams(double *, size_t, double, double)
+        {
+            Tensor<T> x(1001);
+            Random<T>().uniform(x.ptr(), x.size(), 80, 120);
+            NNTestAlmostEquals(mean(x), 100, 5);
+            NNTestAlmostEquals(variance(x), 133.3333, 20);
+            NNTestGreaterThanOrEquals(min(x), 80);
+            NNTestLessThan(max(x), 120);
+        }
     }
 
     NNTestMethod(normal)
@@ -171,6 +268,22 @@ NNTestClassImpl(Random)
             NNTestGreaterThanOrEquals(min(x), -4);
             NNTestLessThanOrEquals(max(x), 2);
         }
+        NNTestParams(double *, size_t, double, double)
+        {
+            Tensor<T> x(1001);
+            Random<T>().normal(x.ptr(), x.size(), -1, 3.14);
+            NNTestAlmostEquals(mean(x), -1, 0.5);
+            NNTestAlmostEquals(variance(x), 9.8596, 1);
+        }
+
+        NNTestParams(double *, size_t, double, double, double)
+        {
+            Tensor<T> x(1001);
+            Random<T>().normal(x.ptr(), x.size(), -1, 3.14, 3);
+            NNTestAlmostEquals(mean(x), -1, 0.5);
+            NNTestGreaterThanOrEquals(min(x), -4);
+            NNTestLessThanOrEquals(max(x), 2);
+        }
     }
 
     NNTestMethod(bernoulli)
@@ -191,5 +304,18 @@ NNTestClassImpl(Random)
             }, x);
             NNTestAlmostEquals(n, 0.25 * x.size(), 50);
         }
+
+        NNTestParams(double *, size_t, double)
+        {
+            Tensor<T> x(1001);
+            Random<T>().bernoulli(x.ptr(), x.size(), 0.25);
+            size_t n = 0;
+            forEach([&](T x)
+            {
+                if(x > 0.5)
+                    ++n;
+            }, x);
+            NNTestAlmostEquals(n, 0.25 * x.size(), 50);
+        }
     }
 }
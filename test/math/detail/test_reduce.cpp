@@ -0,0 +1,154 @@
+#include "../test_reduce.hpp"
+#include "nnlib/math/math.hpp"
+#include "nnlib/math/reduce.hpp"
+#include <math.h>
+using namespace nnlib;
+using namespace nnlib::math;
+using T = NN_REAL_T;
+
+NNTestClassImpl(Reduce)
+{
+    NNTestMethod(sum)
+    {
+        NNTestParams(const Tensor &, Tensor &, const Storage<size_t> &, size_t)
+        {
+            Tensor<T> x = Tensor<T>({ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 }).resize(2, 3, 2);
+            Tensor<T> y;
+
+            sum(x, y, { 1 });
+            NNTestEquals(y.shape(), Storage<size_t>({ 2, 2 }));
+            NNTestAlmostEquals(y(0, 0), 9, 1e-12);
+            NNTestAlmostEquals(y(0, 1), 12, 1e-12);
+            NNTestAlmostEquals(y(1, 0), 27, 1e-12);
+            NNTestAlmostEquals(y(1, 1), 30, 1e-12);
+
+            sum(x, y, { 0, 2 });
+            NNTestEquals(y.shape(), Storage<size_t>({ 3 }));
+            NNTestAlmostEquals(y(0), 1 + 2 + 7 + 8, 1e-12);
+            NNTestAlmostEquals(y(2), 5 + 6 + 11 + 12, 1e-12);
+
+            sum(x, y, { 0, 1, 2 });
+            NNTestEquals(y.shape(), Storage<size_t>({ 1 }));
+            NNTestAlmostEquals(y(0), 78, 1e-12);
+
+            Tensor<T> kept(2, 1, 2);
+            sum(x, kept, { 1 });
+            NNTestEquals(kept.shape(), Storage<size_t>({ 2, 1, 2 }));
+            NNTestAlmostEquals(kept(1, 0, 1), 30, 1e-12);
+
+            Tensor<T> transposed = x.transpose(0, 2);
+            sum(transposed, y, { 2 });
+            NNTestEquals(y.shape(), Storage<size_t>({ 2, 3 }));
+            NNTestAlmostEquals(y(0, 0), 1 + 7, 1e-12);
+            NNTestAlmostEquals(y(1, 2), 6 + 12, 1e-12);
+
+            Tensor<T> big(100, 1000);
+            fill(big, 0.1);
+            Tensor<T> columns;
+            sum(big, columns, { 0 }, 4);
+            NNTestEquals(columns.size(), 1000);
+            for(size_t j = 0; j < 1000; ++j)
+                NNTestAlmostEquals(columns(j), 10, 1e-12);
+
+            Tensor<T> rows;
+            sum(big, rows, { 1 }, 4);
+            NNTestEquals(rows.size(), 100);
+            for(size_t i = 0; i < 100; ++i)
+                NNTestAlmostEquals(rows(i), 100, 1e-10);
+
+            bool ok = true;
+            try
+            {
+                sum(x, y, { 3 });
+            }
+            catch(const Error &)
+            {
+                ok = false;
+            }
+            NNTest(!ok);
+        }
+    }
+
+    NNTestMethod(mean)
+    {
+        NNTestParams(const Tensor &, Tensor &, const Storage<size_t> &, size_t)
+        {
+            Tensor<T> x = Tensor<T>({ 1, 2, 3, 4, 5, 6 }).resize(2, 3);
+            Tensor<T> y;
+            mean(x, y, { 0 });
+            NNTestAlmostEquals(y(0), 2.5, 1e-12);
+            NNTestAlmostEquals(y(2), 4.5, 1e-12);
+        }
+    }
+
+    NNTestMethod(variance)
+    {
+        NNTestParams(const Tensor &, Tensor &, const Storage<size_t> &, bool, size_t)
+        {
+            Tensor<T> x = Tensor<T>({ 1, 2, 3, 4, 5, 9 }).resize(2, 3);
+            Tensor<T> y;
+            variance(x, y, { 1 });
+            NNTestAlmostEquals(y(0), 2.0 / 3.0, 1e-12);
+            NNTestAlmostEquals(y(1), 14.0 / 3.0, 1e-12);
+            variance(x, y, { 1 }, true);
+            NNTestAlmostEquals(y(1), 7, 1e-12);
+            variance(x, y, { 0 });
+            NNTestAlmostEquals(y(2), 9, 1e-12);
+        }
+    }
+
+    NNTestMethod(max)
+    {
+        NNTestParams(const Tensor &, Tensor &, const Storage<size_t> &, size_t)
+        {
+            Tensor<T> x = Tensor<T>({ 1, 8, 3, 4, -5, 6 }).resize(2, 3);
+            Tensor<T> y;
+            max(x, y, { 1 });
+            NNTestAlmostEquals(y(0), 8, 1e-12);
+            NNTestAlmostEquals(y(1), 6, 1e-12);
+            max(x, y, { 0 });
+            NNTestAlmostEquals(y(0), 4, 1e-12);
+            NNTestAlmostEquals(y(1), 8, 1e-12);
+            NNTestAlmostEquals(y(2), 6, 1e-12);
+        }
+    }
+
+    NNTestMethod(min)
+    {
+        NNTestParams(const Tensor &, Tensor &, const Storage<size_t> &, size_t)
+        {
+            Tensor<T> x = Tensor<T>({ 1, 8, 3, 4, -5, 6 }).resize(2, 3);
+            Tensor<T> y;
+            min(x, y, { 1 });
+            NNTestAlmostEquals(y(0), 1, 1e-12);
+            NNTestAlmostEquals(y(1), -5, 1e-12);
+            min(x, y, { 0, 1 });
+            NNTestAlmostEquals(y(0), -5, 1e-12);
+        }
+    }
+
+    NNTestMethod(logsumexp)
+    {
+        NNTestParams(const Tensor &, Tensor &, const Storage<size_t> &, size_t)
+        {
+            Tensor<T> x = Tensor<T>({ 1, 2, 3, 1000, 1000, 1000 }).resize(2, 3);
+            Tensor<T> y;
+            logsumexp(x, y, { 1 });
+            NNTestAlmostEquals(y(0), log(exp(1) + exp(2) + exp(3)), 1e-12);
+            NNTestAlmostEquals(y(1), 1000 + log(3), 1e-9);
+        }
+    }
+
+    NNTestMethod(argmax)
+    {
+        NNTestParams(const Tensor &, Storage<size_t> &, size_t, size_t)
+        {
+            Tensor<T> x = Tensor<T>({ 1, 8, 3, 4, -5, 6 }).resize(2, 3);
+            Storage<size_t> y;
+            argmax(x, y, 1);
+            NNTestEquals(y, Storage<size_t>({ 1, 2 }));
+            argmax(x, y, 0);
+            NNTestEquals(y, Storage<size_t>({ 1, 0, 1 }));
+        }
+    }
+}
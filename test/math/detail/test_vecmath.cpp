@@ -0,0 +1,138 @@
+#include "../test_vecmath.hpp"
+#include "nnlib/math/vecmath.hpp"
+#include <cmath>
+#include <limits>
+#include <vector>
+using namespace nnlib;
+using T = NN_REAL_T;
+
+namespace
+{
+    /// Whether a is within the given number of ulps of b, measured relative to b.
+    bool withinUlps(T a, T b, T ulps)
+    {
+        T scale = std::max(std::fabs(b), std::numeric_limits<T>::min());
+        return std::fabs(a - b) <= ulps * std::numeric_limits<T>::epsilon() * scale;
+    }
+}
+
+NNTestClassImpl(VecMath)
+{
+    NNTestMethod(exp)
+    {
+        NNTestParams(T)
+        {
+            for(T x = -80; x < 80; x += 0.0137)
+                NNTest(withinUlps(vecmath::exp(x), std::exp(x), 1));
+        }
+
+        NNTestParams(T)
+        {
+            NNTestEquals(vecmath::exp(T(0)), 1);
+            NNTestEquals(vecmath::exp(-std::numeric_limits<T>::infinity()), 0);
+            NNTestEquals(vecmath::exp(std::numeric_limits<T>::infinity()), std::numeric_limits<T>::infinity());
+            NNTestEquals(vecmath::exp(T(1e4)), std::numeric_limits<T>::infinity());
+            NNTestEquals(vecmath::exp(T(-1e4)), 0);
+            NNTest(std::isnan(vecmath::exp(std::numeric_limits<T>::quiet_NaN())));
+        }
+    }
+
+    NNTestMethod(log)
+    {
+        NNTestParams(T)
+        {
+            for(T x = 1e-30; x < 1e30; x *= 1.0731)
+                NNTest(withinUlps(vecmath::log(x), std::log(x), 1));
+        }
+
+        NNTestParams(T)
+        {
+            T denorm = std::numeric_limits<T>::denorm_min();
+            NNTest(withinUlps(vecmath::log(denorm), std::log(denorm), 1));
+            NNTestEquals(vecmath::log(T(1)), 0);
+            NNTestEquals(vecmath::log(T(0)), -std::numeric_limits<T>::infinity());
+            NNTestEquals(vecmath::log(std::numeric_limits<T>::infinity()), std::numeric_limits<T>::infinity());
+            NNTest(std::isnan(vecmath::log(T(-1))));
+        }
+    }
+
+    NNTestMethod(tanh)
+    {
+        NNTestParams(T)
+        {
+            for(T x = -25; x < 25; x += 0.0113)
+                NNTest(withinUlps(vecmath::tanh(x), std::tanh(x), 3));
+            NNTestEquals(vecmath::tanh(T(1e-20)), T(1e-20));
+            NNTestEquals(vecmath::tanh(std::numeric_limits<T>::infinity()), 1);
+            NNTestEquals(vecmath::tanh(-std::numeric_limits<T>::infinity()), -1);
+        }
+    }
+
+    NNTestMethod(sigmoid)
+    {
+        NNTestParams(T)
+        {
+            for(T x = -80; x < 80; x += 0.0137)
+                NNTest(withinUlps(vecmath::sigmoid(x), 1 / (1 + std::exp(-x)), 3));
+            NNTestEquals(vecmath::sigmoid(T(0)), 0.5);
+        }
+    }
+
+    NNTestMethod(sin)
+    {
+        NNTestParams(T)
+        {
+            for(T x = -100; x < 100; x += 0.0071)
+                NNTest(withinUlps(vecmath::sin(x), std::sin(x), 3));
+            NNTestEquals(vecmath::sin(T(1e7)), std::sin(T(1e7)));
+            NNTest(std::isnan(vecmath::sin(std::numeric_limits<T>::infinity())));
+        }
+    }
+
+    NNTestMethod(cos)
+    {
+        NNTestParams(T)
+        {
+            for(T x = -100; x < 100; x += 0.0071)
+                NNTest(withinUlps(vecmath::cos(x), std::cos(x), 3));
+            NNTestEquals(vecmath::cos(T(1e7)), std::cos(T(1e7)));
+        }
+    }
+
+    NNTestMethod(span)
+    {
+        NNTestParams(const T *, T *, size_t)
+        {
+            std::vector<T> x(1000), y(1000);
+            for(size_t i = 0; i < x.size(); ++i)
+                x[i] = (i * 0.37) - 180;
+            x[17] = 1e7;
+
+            vecmath::exp(x.data(), y.data(), x.size());
+            for(size_t i = 0; i < x.size(); ++i)
+                NNTestEquals(y[i], vecmath::exp(x[i]));
+
+            vecmath::sin(x.data(), y.data(), x.size());
+            for(size_t i = 0; i < x.size(); ++i)
+                NNTestEquals(y[i], vecmath::sin(x[i]));
+
+            vecmath::cos(x.data(), y.data(), x.size());
+            for(size_t i = 0; i < x.size(); ++i)
+                NNTestEquals(y[i], vecmath::cos(x[i]));
+        }
+
+        NNTestParams(const T *, T *, size_t)
+        {
+            std::vector<T> x(300), y(300);
+            for(size_t i = 0; i < x.size(); ++i)
+                x[i] = y[i] = (i * 0.71) - 100;
+            y[299] = 1e7;
+            x[299] = 1e7;
+
+            // in place
+            vecmath::sin(y.data(), y.data(), y.size());
+            for(size_t i = 0; i < x.size(); ++i)
+                NNTestEquals(y[i], vecmath::sin(x[i]));
+        }
+    }
+}
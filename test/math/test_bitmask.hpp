@@ -0,0 +1,7 @@
+#ifndef TEST_BITMASK_HPP
+#define TEST_BITMASK_HPP
+
+#include "../test.hpp"
+NNTestClassDecl(BitMask);
+
+#endif
@@ -2,6 +2,7 @@
 #define TEST_RANDOM_HPP
 
 #include "../test.hpp"
+NNTestClassDecl(Philox);
 NNTestClassDecl(RandomEngine);
 NNTestClassDecl(Random);
 
@@ -0,0 +1,7 @@
+#ifndef TEST_REDUCE_HPP
+#define TEST_REDUCE_HPP
+
+#include "../test.hpp"
+NNTestClassDecl(Reduce);
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef TEST_VECMATH_HPP
+#define TEST_VECMATH_HPP
+
+#include "../test.hpp"
+NNTestClassDecl(VecMath);
+
+#endif
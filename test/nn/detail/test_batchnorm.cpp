@@ -187,6 +187,47 @@ NNTestClassImpl(BatchNorm)
         }
     }
 
+    NNTestMethod(threads)
+    {
+        NNTestParams(size_t)
+        {
+            Tensor<T> input = math::rand(Tensor<T>(7, 10));
+            Tensor<T> blame = math::rand(Tensor<T>(7, 10));
+
+            BatchNorm<T> serial(10);
+            BatchNorm<T> parallel(serial);
+            parallel.threads(3);
+            NNTestEquals(serial.threads(), 1);
+            NNTestEquals(parallel.threads(), 3);
+
+            for(bool training : { true, false })
+            {
+                serial.training(training);
+                parallel.training(training);
+
+                serial.forward(input);
+                serial.backward(input, blame);
+                parallel.forward(input);
+                parallel.backward(input, blame);
+
+                forEach([&](T a, T b)
+                {
+                    NNTestAlmostEquals(a, b, 1e-12);
+                }, serial.output(), parallel.output());
+
+                forEach([&](T a, T b)
+                {
+                    NNTestAlmostEquals(a, b, 1e-12);
+                }, serial.inGrad(), parallel.inGrad());
+
+                forEach([&](T a, T b)
+                {
+                    NNTestAlmostEquals(a, b, 1e-12);
+                }, serial.grad(), parallel.grad());
+            }
+        }
+    }
+
     NNTestMethod(paramsList)
     {
         NNTestParams()
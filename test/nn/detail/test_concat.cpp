@@ -131,6 +131,36 @@ NNTestClassImpl(Concat)
         }
     }
 
+    NNTestMethod(prepare)
+    {
+        NNTestParams(const Storage<size_t> &)
+        {
+            auto comp1 = new Linear<T>(2, 2, false);
+            auto comp2 = new Linear<T>(2, 3, false);
+            comp1->params().copy({ 0, 1, 2, 3 });
+            comp2->params().copy({ 4, 5, 6, 7, 8, 9 });
+
+            Concat<T> module(comp1, comp2);
+            NNTestEquals(module.prepare({ 4, 2 }), Storage<size_t>({ 4, 5 }));
+
+            Tensor<T> input = Tensor<T>({ 0.5, 2, 0.5, 2, 0.5, 2, 0.5, 2 }).resize(4, 2);
+            Tensor<T> target({ 4, 6.5, 16, 18.5, 21 });
+
+            // the components write straight into the prepared output
+            Tensor<T> output = module.output();
+            module.forward(input);
+            NNTest(module.output().sharedWith(output));
+
+            for(size_t i = 0; i < 4; ++i)
+            {
+                forEach([&](T output, T target)
+                {
+                    NNTestAlmostEquals(output, target, 1e-12);
+                }, module.output().select(0, i), target);
+            }
+        }
+    }
+
     NNTestMethod(backward)
     {
         NNTestParams(const Tensor &)
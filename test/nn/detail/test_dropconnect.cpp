@@ -4,6 +4,7 @@
 #include "nnlib/math/random.hpp"
 #include "nnlib/nn/dropconnect.hpp"
 #include "nnlib/nn/linear.hpp"
+#include "nnlib/nn/sequential.hpp"
 using namespace nnlib;
 using T = NN_REAL_T;
 
@@ -61,6 +62,22 @@ NNTestClassImpl(DropConnect)
         }
     }
 
+    NNTestMethod(groupSize)
+    {
+        NNTestParams(size_t)
+        {
+            DropConnect<T> module(new Linear<T>(3, 4));
+            NNTestEquals(module.groupSize(), 1);
+            module.groupSize(8);
+            NNTestEquals(module.groupSize(), 8);
+
+            Serialized node;
+            module.save(node);
+            DropConnect<T> loaded(node);
+            NNTestEquals(loaded.groupSize(), 8);
+        }
+    }
+
     NNTestMethod(training)
     {
         NNTestParams(bool)
@@ -155,4 +172,78 @@ NNTestClassImpl(DropConnect)
             NNTestAlmostEquals(sum1, sum2, 1e-12);
         }
     }
+
+    NNTestMethod(forwardLinear)
+    {
+        NNTestParams(const Tensor &)
+        {
+            auto linear = new Linear<T>(5, 3);
+            DropConnect<T> fast(linear, 0.5);
+            DropConnect<T> generic(new Sequential<T>(new Linear<T>(*linear)), 0.5);
+
+            Tensor<T> input = math::rand(Tensor<T>(6, 5));
+            Tensor<T> blame = math::rand(Tensor<T>(6, 3));
+
+            RandomEngine::sharedEngine().seed(0);
+            fast.forward(input);
+            fast.backward(input, blame);
+
+            RandomEngine::sharedEngine().seed(0);
+            generic.forward(input);
+            generic.backward(input, blame);
+
+            forEach([&](T a, T b)
+            {
+                NNTestAlmostEquals(a, b, 1e-12);
+            }, fast.output(), generic.output());
+
+            forEach([&](T a, T b)
+            {
+                NNTestAlmostEquals(a, b, 1e-12);
+            }, fast.inGrad(), generic.inGrad());
+
+            forEach([&](T a, T b)
+            {
+                NNTestAlmostEquals(a, b, 1e-12);
+            }, fast.grad(), generic.grad());
+
+            forEach([&](T a, T b)
+            {
+                NNTestAlmostEquals(a, b, 1e-12);
+            }, fast.params(), generic.params());
+        }
+    }
+
+    NNTestMethod(forwardGroups)
+    {
+        NNTestParams(const Tensor &)
+        {
+            RandomEngine::sharedEngine().seed(0);
+
+            DropConnect<T> module(new Linear<T>(8, 6), 0.5);
+            module.groupSize(4);
+
+            Tensor<T> row = math::rand(Tensor<T>(8));
+            Tensor<T> input(6, 8);
+            for(size_t i = 0; i < 6; ++i)
+                input.select(0, i).copy(row);
+
+            module.forward(input);
+            for(size_t i = 1; i < 4; ++i)
+            {
+                forEach([&](T a, T b)
+                {
+                    NNTestAlmostEquals(a, b, 1e-12);
+                }, module.output().select(0, 0), module.output().select(0, i));
+            }
+            forEach([&](T a, T b)
+            {
+                NNTestAlmostEquals(a, b, 1e-12);
+            }, module.output().select(0, 4), module.output().select(0, 5));
+
+            module.backward(input, math::ones(6, 6));
+            NNTestEquals(module.inGrad().size(0), 6);
+            NNTestEquals(module.inGrad().size(1), 8);
+        }
+    }
 }
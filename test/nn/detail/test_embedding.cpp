@@ -0,0 +1,176 @@
+#include "../test_embedding.hpp"
+#include "nnlib/math/math.hpp"
+#include "nnlib/nn/embedding.hpp"
+#include "nnlib/nn/linear.hpp"
+#include "nnlib/nn/sequential.hpp"
+using namespace nnlib;
+using T = NN_REAL_T;
+
+NNTestClassImpl(Embedding)
+{
+    NNTestMethod(Embedding)
+    {
+        NNTestParams(size_t, size_t)
+        {
+            Embedding<T> module(5, 3);
+            NNTestEquals(module.entries(), 5);
+            NNTestEquals(module.features(), 3);
+            NNTestEquals(module.weights().shape(), Storage<size_t>({ 5, 3 }));
+            NNTestEquals(module.touched().size(), 0);
+        }
+
+        NNTestParams(const Serialized &)
+        {
+            Embedding<T> module(5, 3);
+            Module<T> *copy = Serialized(module).get<Module<T> *>();
+            NNTestEquals(copy->inputShape(), module.inputShape());
+            NNTestEquals(copy->outputShape(), module.outputShape());
+            forEach([&](T orig, T copy)
+            {
+                NNTestAlmostEquals(orig, copy, 1e-12);
+            }, module.params(), copy->params());
+            delete copy;
+        }
+    }
+
+    NNTestMethod(operator=)
+    {
+        NNTestParams(const Embedding &)
+        {
+            Embedding<T> orig(5, 3);
+            Embedding<T> copy(1, 1);
+            copy = orig;
+            NNTestEquals(copy.entries(), orig.entries());
+            NNTestEquals(copy.features(), orig.features());
+            forEach([&](T orig, T copy)
+            {
+                NNTestAlmostEquals(orig, copy, 1e-12);
+            }, orig.params(), copy.params());
+        }
+    }
+
+    NNTestMethod(forward)
+    {
+        NNTestParams(const Tensor &)
+        {
+            Embedding<T> module(4, 2);
+            module.weights().copy({ 1, 2, 3, 4, 5, 6, 7, 8 });
+            auto input = Tensor<T>({ 2, 0, 3, 3 }).resize(2, 2);
+            auto target = Tensor<T>({ 5, 6, 1, 2, 7, 8, 7, 8 }).resize(2, 4);
+
+            module.forward(input);
+            NNTestEquals(module.output().shape(), target.shape());
+            forEach([&](T actual, T target)
+            {
+                NNTestAlmostEquals(actual, target, 1e-12);
+            }, module.output(), target);
+
+            bool ok = true;
+            try
+            {
+                module.forward(Tensor<T>({ 4 }).resize(1, 1));
+            }
+            catch(const Error &)
+            {
+                ok = false;
+            }
+            NNTest(!ok);
+        }
+    }
+
+    NNTestMethod(backward)
+    {
+        NNTestParams(const Tensor &, const Tensor &)
+        {
+            Embedding<T> module(5, 3);
+            Linear<T> linear(5, 3, false);
+            linear.weights().copy(module.weights());
+            math::fill(module.grad(), 0);
+            math::fill(linear.grad(), 0);
+
+            auto input = Tensor<T>({ 3, 1, 3 }).resize(3, 1);
+            auto oneHot = Tensor<T>({ 0, 0, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0 }).resize(3, 5);
+            auto blame = Tensor<T>({ 1, 2, 3, -4, -3, 2, 0.5, 1, -1 }).resize(3, 3);
+
+            forEach([&](T actual, T target)
+            {
+                NNTestAlmostEquals(actual, target, 1e-12);
+            }, module.forward(input), linear.forward(oneHot));
+
+            module.backward(input, blame);
+            linear.backward(oneHot, blame);
+            forEach([&](T actual, T target)
+            {
+                NNTestAlmostEquals(actual, target, 1e-12);
+            }, module.grad(), linear.grad());
+
+            NNTestEquals(module.inGrad().shape(), input.shape());
+            NNTestAlmostEquals(math::sum(module.inGrad()), 0, 1e-12);
+            NNTestEquals(module.touched(), Storage<size_t>({ 3, 1 }));
+        }
+    }
+
+    NNTestMethod(touchedList)
+    {
+        NNTestParams()
+        {
+            Sequential<T> model(new Embedding<T>(5, 2), new Linear<T>(2, 1));
+            auto touched = model.touchedList();
+            NNTestEquals(touched.size(), model.gradList().size());
+            NNTestEquals(touched.size(), 3);
+            NNTestEquals(touched[0]->size(), 0);
+            NNTest(touched[1] == nullptr);
+            NNTest(touched[2] == nullptr);
+
+            auto input = Tensor<T>({ 4, 0, 4 }).resize(3, 1);
+            model.forward(input);
+            model.backward(input, Tensor<T>({ 1, 1, 1 }).resize(3, 1));
+            NNTestEquals(*model.touchedList()[0], Storage<size_t>({ 4, 0 }));
+
+            model.clearTouched();
+            NNTestEquals(model.touchedList()[0]->size(), 0);
+
+            model.forward(input.narrow(0, 1));
+            model.backward(input.narrow(0, 1), Tensor<T>({ 1 }).resize(1, 1));
+            NNTestEquals(*model.touchedList()[0], Storage<size_t>({ 0 }));
+        }
+    }
+
+    NNTestMethod(prepare)
+    {
+        NNTestParams(const Storage<size_t> &)
+        {
+            Embedding<T> module(5, 3);
+            NNTestEquals(module.prepare({ 8, 2 }), Storage<size_t>({ 8, 6 }));
+            NNTestEquals(module.inputShape(), Storage<size_t>({ 8, 2 }));
+
+            Tensor<T> input = math::fill(Tensor<T>(8, 2), 1);
+            Tensor<T> outGrad = math::rand(Tensor<T>(8, 6));
+
+            size_t allocations = test::allocations();
+            module.forward(input);
+            module.backward(input, outGrad);
+            NNTestEquals(test::allocations(), allocations);
+        }
+    }
+
+    NNTestMethod(inference)
+    {
+        NNTestParams(bool)
+        {
+            Embedding<T> module(5, 3);
+            auto input = Tensor<T>({ 2 }).resize(1, 1);
+            module.forward(input);
+            module.backward(input, Tensor<T>({ 1, 1, 1 }).resize(1, 3));
+            NNTestEquals(module.touched().size(), 1);
+
+            module.inference();
+            NNTestEquals(module.touched().size(), 0);
+            NNTestEquals(module.grad().size(), 0);
+
+            module.inference(false);
+            NNTestEquals(module.grad().size(), module.params().size());
+            NNTestEquals(math::sum(module.grad()), 0);
+        }
+    }
+}
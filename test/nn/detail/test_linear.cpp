@@ -1,5 +1,6 @@
 #include "../test_linear.hpp"
 #include "../test_module.hpp"
+#include "nnlib/core/sparse_tensor.hpp"
 #include "nnlib/math/math.hpp"
 #include "nnlib/nn/linear.hpp"
 using namespace nnlib;
@@ -95,6 +96,18 @@ NNTestClassImpl(Linear)
                 NNTestAlmostEquals(unbiased, target - bias, 1e-12);
             }, unbiased.output(), module.bias(), target.select(0, 0));
         }
+
+        NNTestParams(const SparseTensor &)
+        {
+            Linear<T> module(4, 3);
+            auto input = Tensor<T>({ 0, 2, 0, -1, 3, 0, 0, 0 }).resize(2, 4);
+            Tensor<T> dense = module.forward(input).copy();
+            module.forward(SparseTensor<T>(input));
+            forEach([&](T actual, T target)
+            {
+                NNTestAlmostEquals(actual, target, 1e-12);
+            }, module.output(), dense);
+        }
     }
 
     NNTestMethod(backward)
@@ -143,5 +156,99 @@ NNTestClassImpl(Linear)
                 NNTestAlmostEquals(unbiased, target, 1e-12);
             }, unbiased.inGrad(), inGrad.select(0, 0));
         }
+
+        NNTestParams(const SparseTensor &, const Tensor &)
+        {
+            Linear<T> module(4, 3), dense(module);
+            auto input = Tensor<T>({ 0, 2, 0, -1, 3, 0, 0, 0 }).resize(2, 4);
+            auto blame = Tensor<T>({ 1, 2, 3, -4, -3, 2 }).resize(2, 3);
+            math::fill(module.grad(), 0);
+            math::fill(dense.grad(), 0);
+
+            dense.forward(input);
+            dense.backward(input, blame);
+            Tensor<T> inGrad = module.inGrad().copy();
+            module.forward(SparseTensor<T>(input));
+            module.backward(SparseTensor<T>(input), blame);
+            forEach([&](T actual, T target)
+            {
+                NNTestAlmostEquals(actual, target, 1e-12);
+            }, module.inGrad(), inGrad);
+            forEach([&](T actual, T target)
+            {
+                NNTestAlmostEquals(actual, target, 1e-12);
+            }, module.grad(), dense.grad());
+
+            NNTest(module.touchedList()[0] == nullptr);
+            module.clearTouched();
+            module.backward(SparseTensor<T>(input), blame);
+            NNTestEquals(*module.touchedList()[0], Storage<size_t>({ 1, 3, 0 }));
+            NNTest(module.touchedList()[1] == nullptr);
+            module.backward(input, blame);
+            NNTest(module.touchedList()[0] == nullptr);
+        }
+    }
+
+    NNTestMethod(prepare)
+    {
+        NNTestParams(const Storage<size_t> &)
+        {
+            Linear<T> module(2, 3);
+            NNTestEquals(module.prepare({ 8, 2 }), Storage<size_t>({ 8, 3 }));
+            NNTestEquals(module.inputShape(), Storage<size_t>({ 8, 2 }));
+
+            Tensor<T> input = math::rand(Tensor<T>(8, 2));
+            Tensor<T> small = input.narrow(0, 0, 5).copy();
+            Tensor<T> outGrad = math::rand(Tensor<T>(8, 3));
+            Tensor<T> smallGrad = outGrad.narrow(0, 0, 5).copy();
+
+            size_t allocations = test::allocations();
+            module.forward(input);
+            module.backward(input, outGrad);
+            module.forward(small);
+            module.backward(small, smallGrad);
+            NNTestEquals(test::allocations(), allocations);
+        }
+    }
+
+    NNTestMethod(inference)
+    {
+        NNTestParams(bool)
+        {
+            Linear<T> module(2, 3);
+            Storage<size_t> inputShape = module.inputShape();
+            module.grad();
+
+            module.inference();
+            NNTest(module.isInference());
+            NNTestEquals(module.grad().size(), 0);
+            NNTestEquals(module.inputShape(), inputShape);
+
+            Tensor<T> input({ 1, 2 });
+            Tensor<T> output = module.forward(input).copy();
+
+            bool rejected = false;
+            try
+            {
+                module.backward(input, Tensor<T>({ 1, 1, 1 }));
+            }
+            catch(const Error &)
+            {
+                rejected = true;
+            }
+            NNTest(rejected);
+
+            module.inference(false);
+            NNTest(!module.isInference());
+            NNTestEquals(module.grad().size(), module.params().size());
+            NNTestEquals(module.inGrad().shape(), inputShape);
+            NNTestEquals(math::sum(module.grad()), 0);
+
+            module.backward(input, Tensor<T>({ 1, 1, 1 }));
+            forEach([&](T a, T b)
+            {
+                NNTestAlmostEquals(a, b, 1e-12);
+            }, output, module.forward(input));
+        }
     }
 }
@@ -150,4 +150,50 @@ NNTestClassImpl(LSTM)
             }, module.grad(), pGrad);
         }
     }
+
+    NNTestMethod(inference)
+    {
+        NNTestParams(bool)
+        {
+            LSTM<T> module(1, 1);
+            module.params().copy({
+                -0.2, 0.5, 0.1, 0,
+                0.75, -0.6, 0.25, 0,
+                1.0, -0.7, 0,
+                0.3, 0.3, -0.75, 0
+            });
+            size_t stateSize = module.stateList().size();
+            module.inference();
+
+            auto input = Tensor<T>({ 8, 6, 0 }).resize(3, 1, 1);
+            auto target = Tensor<T>({ 0.15089258930, 0.32260369939, 0.03848645247 });
+
+            Tensor<T> outputs(3);
+            outputs(0) = module.forward(input.select(0, 0))(0, 0);
+            outputs(1) = module.forward(input.select(0, 1))(0, 0);
+            outputs(2) = module.forward(input.select(0, 2))(0, 0);
+
+            forEach([&](T actual, T target)
+            {
+                NNTestAlmostEquals(actual, target, 1e-9);
+            }, outputs, target);
+
+            NNTestEquals(module.grad().size(), 0);
+            NNTestLessThan(module.stateList().size(), stateSize);
+
+            bool rejected = false;
+            try
+            {
+                module.backward(input.select(0, 2), math::fill(Tensor<T>(1, 1), 1));
+            }
+            catch(const Error &)
+            {
+                rejected = true;
+            }
+            NNTest(rejected);
+
+            module.inference(false);
+            NNTestEquals(module.grad().size(), module.params().size());
+        }
+    }
 }
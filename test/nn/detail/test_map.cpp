@@ -9,6 +9,33 @@ NNTestAbstractClassImpl(Map, Map<T>)
 {
     NNRunAbstractTest(Module, Map, nnImpl.copy());
 
+    NNTestMethod(forwardSpan)
+    {
+        NNTestParams(const T *, T *, size_t)
+        {
+            RandomEngine::sharedEngine().seed(0);
+            auto wide = math::rand(Tensor<T>(4, 12), -3, 3);
+            auto grad = math::rand(Tensor<T>(4, 6));
+            Tensor<T> strided = wide.narrow(1, 0, 6);
+            Tensor<T> packed = strided.copy();
+
+            Tensor<T> output = nnImpl.forward(packed).copy();
+            Tensor<T> inGrad = nnImpl.backward(packed, grad).copy();
+
+            nnImpl.forward(strided);
+            forEach([&](T spanOutput, T stridedOutput)
+            {
+                NNTestAlmostEquals(spanOutput, stridedOutput, 1e-12);
+            }, output, nnImpl.output());
+
+            nnImpl.backward(strided, grad);
+            forEach([&](T spanInGrad, T stridedInGrad)
+            {
+                NNTestAlmostEquals(spanInGrad, stridedInGrad, 1e-12);
+            }, inGrad, nnImpl.inGrad());
+        }
+    }
+
     NNTestMethod(save)
     {
         NNTestParams(Serialized &)
@@ -55,4 +55,61 @@ NNTestClassImpl(ReLU)
             NNTestAlmostEquals(module.inGrad()(2), 1, 1e-12);
         }
     }
+
+    NNTestMethod(forwardInPlace)
+    {
+        NNTestParams(Tensor &)
+        {
+            ReLU<T> module(0.75);
+            Tensor<T> input = { -1.3, 1.0, 3.14 };
+            module.forwardInPlace(input);
+            NNTest(module.output().sharedWith(input));
+            NNTestAlmostEquals(input(0), -0.975, 1e-12);
+            NNTestAlmostEquals(input(1), 1.0, 1e-12);
+            NNTestAlmostEquals(input(2), 3.14, 1e-12);
+
+            module.forward({ 2.0, -2.0, 1.0 });
+            NNTest(!module.output().sharedWith(input));
+            NNTestAlmostEquals(input(0), -0.975, 1e-12);
+            NNTestAlmostEquals(module.output()(1), -1.5, 1e-12);
+        }
+
+        NNTestParams(Tensor &)
+        {
+            ReLU<T> module(0.75);
+            Tensor<T> wide = { -1.3, 5.0, 1.0, 5.0, 3.14, 5.0 };
+            wide.resize(3, 2);
+            Tensor<T> input = wide.select(1, 0);
+            module.forwardInPlace(input);
+            NNTestAlmostEquals(wide(0, 0), -0.975, 1e-12);
+            NNTestAlmostEquals(wide(1, 0), 1.0, 1e-12);
+            NNTestAlmostEquals(wide(2, 0), 3.14, 1e-12);
+            NNTestAlmostEquals(wide(0, 1), 5.0, 1e-12);
+        }
+    }
+
+    NNTestMethod(inPlace)
+    {
+        NNTestParams(bool)
+        {
+            ReLU<T> orig(0.5);
+            orig.inPlace(true);
+            NNTest(orig.outputGradient());
+
+            ReLU<T> copy(orig);
+            NNTest(copy.inPlace());
+
+            ReLU<T> assigned;
+            assigned = orig;
+            NNTest(assigned.inPlace());
+
+            Module<T> *serialized = Serialized(orig).get<Module<T> *>();
+            NNTest(static_cast<ReLU<T> *>(serialized)->inPlace());
+            delete serialized;
+
+            Serialized node;
+            ReLU<T>().save(node);
+            NNTest(!node.has("inPlace"));
+        }
+    }
 }
@@ -131,6 +131,33 @@ NNTestClassImpl(Sequencer)
         }
     }
 
+    NNTestMethod(prepare)
+    {
+        NNTestParams(const Storage<size_t> &)
+        {
+            Sequencer<T> module(new LSTM<T>(1, 1));
+            module.params().copy({
+                -0.2, 0.5, 0.1, 0,
+                0.75, -0.6, 0.25, 0,
+                1.0, -0.7, 0,
+                0.3, 0.3, -0.75, 0
+            });
+
+            NNTestEquals(module.prepare({ 3, 4, 1 }), Storage<size_t>({ 3, 4, 1 }));
+            NNTestEquals(module.module().outputShape(), Storage<size_t>({ 4, 1 }));
+
+            auto input = Tensor<T>({ 8, 6, 0 }).resize(3, 1, 1);
+            auto target = Tensor<T>({ 0.15089258930, 0.32260369939, 0.03848645247 }).resize(3, 1, 1);
+
+            module.forward(input);
+
+            forEach([&](T actual, T target)
+            {
+                NNTestAlmostEquals(actual, target, 1e-9);
+            }, module.output(), target);
+        }
+    }
+
     NNTestMethod(backward)
     {
         NNTestParams(const Tensor &, const Tensor &)
@@ -1,9 +1,17 @@
 #include "../test_container.hpp"
 #include "../test_sequential.hpp"
 #include "nnlib/math/math.hpp"
+#include "nnlib/math/random.hpp"
+#include "nnlib/core/memory.hpp"
 #include "nnlib/nn/sequential.hpp"
 #include "nnlib/nn/batchnorm.hpp"
+#include "nnlib/nn/dropout.hpp"
 #include "nnlib/nn/linear.hpp"
+#include "nnlib/nn/logistic.hpp"
+#include "nnlib/nn/relu.hpp"
+#include "nnlib/nn/tanh.hpp"
+#include "nnlib/opt/sgd.hpp"
+#include <cstdint>
 using namespace nnlib;
 using T = NN_REAL_T;
 
@@ -45,9 +53,19 @@ NNTestClassImpl(Sequential)
         NNTestParams(Module *)
         {
             Sequential<T> module(new Linear<T>(3, 4), new Linear<T>(4, 2));
+            Tensor<T> params = module.params();
+
             module.add(new Linear<T>(2, 12));
             NNTestEquals(module.components(), 3);
             NNTestEquals(module.outputShape()[1], 12);
+
+            // the arena is rebuilt to include the new component, and sub-modules view into it
+            NNTestEquals(module.params().size(), params.size() + 2 * 12 + 12);
+            NNTest(!module.params().sharedWith(params));
+            NNTest(module.component(0)->params().sharedWith(module.params()));
+            NNTest(module.component(2)->params().sharedWith(module.params()));
+            NNTestEquals(reinterpret_cast<uintptr_t>(module.params().ptr()) % NN_ALIGNMENT, 0);
+            NNTestEquals(reinterpret_cast<uintptr_t>(module.grad().ptr()) % NN_ALIGNMENT, 0);
         }
     }
 
@@ -61,6 +79,7 @@ NNTestClassImpl(Sequential)
             auto comp4 = new Linear<T>(4, 5);
             auto comp5 = new Linear<T>(5, 10);
             Sequential<T> module(comp1, comp2, comp3, comp4, comp5);
+            module.params();
             NNTestEquals(module.remove(1), comp2);
             NNTestEquals(module.remove(1), comp3);
             NNTestEquals(module.components(), 3);
@@ -68,6 +87,7 @@ NNTestClassImpl(Sequential)
             NNTestEquals(module.outputShape()[1], 10);
             NNTestEquals(module.remove(2), comp5);
             NNTestEquals(module.components(), 2);
+            NNTestEquals(module.params().size(), comp1->params().size() + comp4->params().size());
             NNTestEquals(module.inputShape()[1], 3);
             NNTestEquals(module.outputShape()[1], 5);
             NNTestEquals(module.remove(0), comp1);
@@ -134,4 +154,120 @@ NNTestClassImpl(Sequential)
             }, module.grad(), pGrad);
         }
     }
+
+    NNTestMethod(prepare)
+    {
+        NNTestParams(const Storage<size_t> &)
+        {
+            RandomEngine::sharedEngine().seed(0);
+            Sequential<T> module(
+                new Linear<T>(3, 6), new BatchNorm<T>(6), new ReLU<T>(),
+                new Dropout<T>(0.5), new Linear<T>(6, 2), new TanH<T>()
+            );
+            NNTestEquals(module.prepare({ 8, 3 }), Storage<size_t>({ 8, 2 }));
+
+            Tensor<T> input = math::rand(Tensor<T>(8, 3));
+            Tensor<T> small = input.narrow(0, 0, 5).copy();
+            Tensor<T> outGrad = math::rand(Tensor<T>(8, 2));
+            Tensor<T> smallGrad = outGrad.narrow(0, 0, 5).copy();
+
+            size_t allocations = test::allocations();
+            for(size_t i = 0; i < 2; ++i)
+            {
+                module.forward(input);
+                module.backward(input, outGrad);
+                module.forward(small);
+                module.backward(small, smallGrad);
+            }
+            NNTestEquals(test::allocations(), allocations);
+            NNTestEquals(module.output().shape(), Storage<size_t>({ 5, 2 }));
+
+            // an in-place map takes over its input on the first forward; after that, nothing is allocated
+            static_cast<ReLU<T> *>(module.component(2))->inPlace(true);
+            module.forward(input);
+
+            allocations = test::allocations();
+            module.forward(input);
+            module.backward(input, outGrad);
+            NNTestEquals(test::allocations(), allocations);
+        }
+    }
+
+    NNTestMethod(inPlace)
+    {
+        NNTestParams(const Tensor &)
+        {
+            auto relu = new ReLU<T>();
+            auto logistic = new Logistic<T>();
+            auto tanh = new TanH<T>();
+            Sequential<T> normal(new Linear<T>(3, 5), new ReLU<T>(), new Linear<T>(5, 4), new Logistic<T>(), new TanH<T>());
+            Sequential<T> inPlace(new Linear<T>(3, 5), relu, new Linear<T>(5, 4), logistic, tanh);
+            relu->inPlace(true);
+            logistic->inPlace(true);
+            tanh->inPlace(true);
+            inPlace.params().copy(normal.params());
+
+            RandomEngine::sharedEngine().seed(0);
+            auto input = math::rand(Tensor<T>(6, 3));
+            auto grad = math::rand(Tensor<T>(6, 4));
+
+            normal.forward(input);
+            normal.backward(input, grad);
+            inPlace.forward(input);
+            inPlace.backward(input, grad);
+
+            // the ReLU and Logistic overwrite the Linear outputs; the TanH may not overwrite the Logistic output
+            NNTest(relu->output().sharedWith(inPlace.component(0)->output()));
+            NNTest(logistic->output().sharedWith(inPlace.component(2)->output()));
+            NNTest(!tanh->output().sharedWith(logistic->output()));
+
+            forEach([&](T a, T b)
+            {
+                NNTestAlmostEquals(a, b, 1e-12);
+            }, normal.output(), inPlace.output());
+
+            forEach([&](T a, T b)
+            {
+                NNTestAlmostEquals(a, b, 1e-12);
+            }, normal.inGrad(), inPlace.inGrad());
+
+            forEach([&](T a, T b)
+            {
+                NNTestAlmostEquals(a, b, 1e-12);
+            }, normal.grad(), inPlace.grad());
+        }
+    }
+
+    NNTestMethod(memory)
+    {
+        NNTestParams()
+        {
+            RandomEngine::sharedEngine().seed(0);
+            Sequential<T> module(new Linear<T>(3, 6), new BatchNorm<T>(6), new ReLU<T>(), new Linear<T>(6, 2));
+            SGD<T> opt(module);
+
+            Tensor<T> input = math::rand(Tensor<T>(8, 3));
+            Tensor<T> target = math::rand(Tensor<T>(8, 2));
+
+            // each layer's buffers are attributed to it
+            MemoryTracker::reset();
+            MemoryTracker::enable();
+            module.prepare({ 8, 3 });
+            NNTestEquals(MemoryTracker::stats(module.component(3)).resident, (8 * 2 + 8 * 6) * sizeof(T));
+            for(size_t i = 0; i < 4; ++i)
+                NNTestGreaterThan(MemoryTracker::stats(module.component(i)).allocations, 0);
+
+            // after a warm-up step, training allocates nothing
+            opt.step(input, target);
+            MemoryTracker::reset();
+            for(size_t i = 0; i < 5; ++i)
+                opt.step(input, target);
+            MemoryTracker::enable(false);
+
+            NNTestEquals(MemoryTracker::total().allocations, 0ul);
+            for(size_t i = 0; i < 4; ++i)
+                NNTestEquals(MemoryTracker::stats(module.component(i)).allocations, 0ul);
+            MemoryTracker::reset();
+        }
+    }
 }
@@ -32,4 +32,25 @@ NNTestClassImpl(Sin)
             NNTestAlmostEquals(module.inGrad()(2), -0.99999873172, 1e-9);
         }
     }
+
+    NNTestMethod(inPlace)
+    {
+        NNTestParams(bool)
+        {
+            Sin<T> module;
+            NNTest(!module.outputGradient());
+
+            bool rejected = false;
+            try
+            {
+                module.inPlace(true);
+            }
+            catch(const Error &)
+            {
+                rejected = true;
+            }
+            NNTest(rejected);
+            NNTest(!module.inPlace());
+        }
+    }
 }
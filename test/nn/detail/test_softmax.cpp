@@ -1,5 +1,6 @@
 #include "../test_module.hpp"
 #include "../test_softmax.hpp"
+#include "nnlib/math/math.hpp"
 #include "nnlib/nn/softmax.hpp"
 using namespace nnlib;
 using T = NN_REAL_T;
@@ -29,4 +30,22 @@ NNTestClassImpl(SoftMax)
         NNTestAlmostEquals(module.inGrad()(0, 1), -0.46768084505, 1e-9);
         NNTestAlmostEquals(module.inGrad()(0, 2), 0.45190622721, 1e-9);
     }
+
+    NNTestMethod(prepare)
+    {
+        SoftMax<T> module;
+        NNTestEquals(module.prepare({ 8, 3 }), Storage<size_t>({ 8, 3 }));
+
+        Tensor<T> input = math::rand(Tensor<T>(8, 3));
+        Tensor<T> small = input.narrow(0, 0, 5).copy();
+        Tensor<T> blame = math::rand(Tensor<T>(8, 3));
+        Tensor<T> smallBlame = blame.narrow(0, 0, 5).copy();
+
+        size_t allocations = test::allocations();
+        module.forward(input);
+        module.backward(input, blame);
+        module.forward(small);
+        module.backward(small, smallBlame);
+        NNTestEquals(test::allocations(), allocations);
+    }
 }
@@ -0,0 +1,7 @@
+#ifndef TEST_EMBEDDING_HPP
+#define TEST_EMBEDDING_HPP
+
+#include "../test.hpp"
+NNTestClassDecl(Embedding);
+
+#endif
@@ -2,6 +2,7 @@
 #include "../test_optimizer.hpp"
 #include "nnlib/math/math.hpp"
 #include "nnlib/math/random.hpp"
+#include "nnlib/nn/embedding.hpp"
 #include "nnlib/nn/linear.hpp"
 #include "nnlib/opt/adam.hpp"
 using namespace nnlib;
@@ -60,6 +61,34 @@ NNTestClassImpl(Adam)
         }
     }
 
+    NNTestMethod(sparse)
+    {
+        NNTestParams(bool)
+        {
+            RandomEngine::sharedEngine().seed(0);
+            Embedding<T> model(4, 2), lazy(model);
+            Adam<T> opt(model), sparse(lazy);
+            opt.beta1(0);
+            sparse.beta1(0);
+            sparse.sparse(true);
+            NNTest(sparse.sparse());
+
+            // with no first moment, untouched rows do not move in a dense step either, so the two agree
+            Tensor<T> target = math::rand(Tensor<T>(1, 2));
+            for(T index : { 0, 1, 0, 0, 2, 1 })
+            {
+                Tensor<T> input = Tensor<T>({ index }).resize(1, 1);
+                opt.step(input, target);
+                sparse.step(input, target);
+            }
+
+            forEach([&](T expected, T actual)
+            {
+                NNTestAlmostEquals(expected, actual, 1e-12);
+            }, opt.params(), sparse.params());
+        }
+    }
+
     NNTestMethod(step)
     {
         NNTestParams(const Tensor &, const Tensor &)
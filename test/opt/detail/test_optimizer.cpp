@@ -49,6 +49,40 @@ NNTestAbstractClassImpl(Optimizer, Optimizer<T>)
         }
     }
 
+    NNTestMethod(sparse)
+    {
+        NNTestParams(bool)
+        {
+            RandomEngine::sharedEngine().seed(0);
+
+            auto inputs = math::rand(Tensor<T>(nnImpl.model().inputShape(), true));
+            auto target = math::rand(Tensor<T>(nnImpl.model().outputShape(), true));
+
+            auto before = nnImpl.params().copy();
+            nnImpl.reset();
+            for(size_t i = 0; i < 3; ++i)
+                nnImpl.step(inputs, target);
+            auto after = nnImpl.params().copy();
+
+            // without a record of touched rows, a sparse step updates everything
+            nnImpl.params().copy(before);
+            nnImpl.reset();
+            nnImpl.sparse(true);
+            NNTest(nnImpl.sparse());
+            for(size_t i = 0; i < 3; ++i)
+                nnImpl.step(inputs, target);
+
+            forEach([&](T dense, T sparse)
+            {
+                NNTestAlmostEquals(dense, sparse, 1e-12);
+            }, after, nnImpl.params());
+
+            nnImpl.sparse(false);
+            NNTest(!nnImpl.sparse());
+            nnImpl.reset();
+        }
+    }
+
     NNTestMethod(evaluate)
     {
         NNTestParams(const Tensor &, const Tensor &)
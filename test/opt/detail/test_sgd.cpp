@@ -1,7 +1,9 @@
 #include "../test_optimizer.hpp"
 #include "../test_sgd.hpp"
+#include "nnlib/core/sparse_tensor.hpp"
 #include "nnlib/math/math.hpp"
 #include "nnlib/math/random.hpp"
+#include "nnlib/nn/embedding.hpp"
 #include "nnlib/nn/linear.hpp"
 #include "nnlib/opt/sgd.hpp"
 using namespace nnlib;
@@ -35,6 +37,30 @@ NNTestClassImpl(SGD)
         }
     }
 
+    NNTestMethod(sparse)
+    {
+        NNTestParams(bool)
+        {
+            Embedding<T> model(3, 1);
+            model.params().copy({ 1, 1, 1 });
+
+            SGD<T> opt(model);
+            opt.learningRate(0.25);
+            opt.momentum(0.5);
+            opt.sparse(true);
+            NNTest(opt.sparse());
+
+            Tensor<T> target = Tensor<T>({ 0 }).resize(1, 1);
+            for(T index : { 0, 1, 0 })
+                opt.step(Tensor<T>({ index }).resize(1, 1), target);
+
+            // the velocity of row 0 decays through step 2 before it is updated again; row 2 is never touched
+            NNTestAlmostEquals(opt.params()(0), 0, 1e-12);
+            NNTestAlmostEquals(opt.params()(1), 0.25, 1e-12);
+            NNTestAlmostEquals(opt.params()(2), 1, 1e-12);
+        }
+    }
+
     NNTestMethod(step)
     {
         NNTestParams(const Tensor &, const Tensor &)
@@ -55,5 +81,37 @@ NNTestClassImpl(SGD)
             opt.step(inputs, target);
             NNTestAlmostEquals(opt.params()(0), 0.25, 1e-12);
         }
+
+        NNTestParams(const std::function<void()> &)
+        {
+            Linear<T> model(4, 2), dense(model);
+            SGD<T> opt(model), denseOpt(dense);
+            opt.learningRate(0.25).sparse(true);
+            denseOpt.learningRate(0.25);
+
+            auto before = model.weights().copy();
+            auto input = Tensor<T>({ 0, 2, 0, -1, 3, 0, 0, 0 }).resize(2, 4);
+            auto target = Tensor<T>({ 1, -1, 0, 2 }).resize(2, 2);
+            SparseTensor<T> sparse(input);
+
+            for(size_t i = 0; i < 2; ++i)
+            {
+                opt.step([&]()
+                {
+                    model.backward(sparse, opt.critic().backward(model.forward(sparse), target));
+                });
+                denseOpt.step(input, target);
+            }
+
+            // row 2 is zero in every sample, so it is neither cleared nor updated
+            forEach([&](T actual, T expected)
+            {
+                NNTestAlmostEquals(actual, expected, 1e-12);
+            }, model.weights().select(0, 2), before.select(0, 2));
+            forEach([&](T actual, T expected)
+            {
+                NNTestAlmostEquals(actual, expected, 1e-12);
+            }, opt.params(), denseOpt.params());
+        }
     }
 }
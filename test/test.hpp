@@ -11,6 +11,9 @@ namespace nnlib
 namespace test
 {
 
+/// The number of heap allocations made so far, counted by the replacement operator new in main.cpp.
+size_t allocations();
+
 class Test
 {
 public:
@@ -258,3 +258,66 @@ NNTestClassImpl(SequenceBatcher)
         }
     }
 }
+
+NNTestClassImpl(SparseBatcher)
+{
+    NNTestMethod(SparseBatcher)
+    {
+        NNTestParams(const SparseTensor &, const Tensor &, size_t)
+        {
+            SparseTensor<T> feat(0, 1000000);
+            Tensor<T> lab(6, 1);
+            for(size_t i = 0; i < 6; ++i)
+            {
+                feat.appendRow().append(i * 1000, i);
+                lab(i, 0) = i;
+            }
+
+            SparseBatcher<T> batcher(feat, lab, 2);
+            NNTestEquals(batcher.features().size(0), 2);
+            NNTestEquals(batcher.features().size(1), 1000000);
+            NNTestEquals(batcher.labels().size(0), 2);
+            NNTestEquals(batcher.batches(), 3);
+        }
+    }
+
+    NNTestMethod(reset)
+    {
+        NNTestParams()
+        {
+            SparseTensor<T> feat(0, 1000000);
+            Tensor<T> lab(6, 1);
+            for(size_t i = 0; i < 6; ++i)
+            {
+                feat.appendRow().append(i * 1000, i);
+                lab(i, 0) = i;
+            }
+
+            SparseBatcher<T> batcher(feat, lab, 1);
+            Storage<bool> included(6);
+            for(size_t trial = 0; trial < 10; ++trial)
+            {
+                batcher.reset();
+                for(size_t i = 0; i < 6; ++i)
+                    included[i] = false;
+
+                for(size_t i = 0; i < 6; ++i)
+                {
+                    size_t row = batcher.labels()(0, 0);
+                    NNTestEquals(batcher.features().nonzeros(), 1);
+                    NNTestEquals(batcher.features().indices()[0], row * 1000);
+                    NNTestEquals(batcher.features().values()[0], row);
+                    included[row] = true;
+                    batcher.next();
+                }
+
+                NNTestEquals(batcher.next(), false);
+                for(size_t i = 0; i < 6; ++i)
+                    NNTestEquals(included[i], true);
+            }
+
+            NNTestEquals(batcher.next(), false);
+            NNTestEquals(batcher.next(true), true);
+        }
+    }
+}
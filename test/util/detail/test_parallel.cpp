@@ -0,0 +1,110 @@
+#include "../test_parallel.hpp"
+#include "nnlib/core/tensor.hpp"
+#include "nnlib/math/math.hpp"
+#include "nnlib/math/random.hpp"
+#include "nnlib/math/reduce.hpp"
+#include "nnlib/util/parallel.hpp"
+using namespace nnlib;
+using namespace nnlib::math;
+using T = NN_REAL_T;
+
+NNTestClassImpl(Parallel)
+{
+    NNTestMethod(parallelFor)
+    {
+        NNTestParams(size_t, size_t, F)
+        {
+            Tensor<T> x = zeros<T>(103);
+            parallelFor(x.size(), 4, [&](size_t begin, size_t end, size_t thread)
+            {
+                for(size_t i = begin; i < end; ++i)
+                    x(i) += thread + 1;
+            });
+            NNTestEquals(x(0), 1);
+            NNTestEquals(x(26), 2);
+            NNTestEquals(x(102), 4);
+            NNTestEquals(sum(x), 26 * 1 + 26 * 2 + 26 * 3 + 25 * 4);
+        }
+
+        NNTestParams(size_t, size_t, F)
+        {
+            Tensor<T> x(1000), y(1000);
+
+            RandomEngine::sharedEngine().seed(0);
+            parallelFor(x.size(), 3, [&](size_t begin, size_t end, size_t)
+            {
+                rand(x.narrow(0, begin, end - begin));
+            });
+
+            RandomEngine::sharedEngine().seed(0);
+            parallelFor(y.size(), 3, [&](size_t begin, size_t end, size_t)
+            {
+                rand(y.narrow(0, begin, end - begin));
+            });
+
+            forEach([&](T x, T y)
+            {
+                NNTestEquals(x, y);
+            }, x, y);
+            NNTestNotEquals(x(0), x(334));
+            NNTestNotEquals(x(0), x(667));
+
+            parallelFor(y.size(), 3, [&](size_t begin, size_t end, size_t)
+            {
+                rand(y.narrow(0, begin, end - begin));
+            });
+            NNTestNotEquals(x(0), y(0));
+        }
+
+        NNTestParams(size_t, size_t, F)
+        {
+            bool thrown = false;
+            try
+            {
+                parallelFor(10, 2, [&](size_t begin, size_t, size_t)
+                {
+                    if(begin > 0)
+                        throw Error("worker failed");
+                });
+            }
+            catch(const Error &)
+            {
+                thrown = true;
+            }
+            NNTest(thrown);
+            NNTestEquals(&RandomEngine::threadEngine(), &RandomEngine::sharedEngine());
+        }
+    }
+    NNTestMethod(parallelForUnseeded)
+    {
+        NNTestParams(size_t, size_t, F)
+        {
+            RandomEngine::sharedEngine().seed(0);
+            T expected = Random<T>::sharedRandom().uniform();
+
+            RandomEngine::sharedEngine().seed(0);
+            Tensor<T> x = zeros<T>(103);
+            parallelForUnseeded(x.size(), 4, [&](size_t begin, size_t end, size_t thread)
+            {
+                for(size_t i = begin; i < end; ++i)
+                    x(i) += thread + 1;
+            });
+            NNTestEquals(sum(x), 26 * 1 + 26 * 2 + 26 * 3 + 25 * 4);
+
+            // copies and reductions run in parallel without drawing from the random engine
+            Tensor<T> big = ones<T>(1 << 20), copied(1 << 20), sums;
+            copied.copy(big, 4);
+            sum(big.view(1 << 10, 1 << 10), sums, Storage<size_t>({ 1 }), 4);
+            NNTestEquals(sums(0), 1 << 10);
+            NNTestEquals(Random<T>::sharedRandom().uniform(), expected);
+        }
+    }
+
+    NNTestMethod(hardwareThreads)
+    {
+        NNTestParams()
+        {
+            NNTestGreaterThan(hardwareThreads(), 0);
+        }
+    }
+}
@@ -4,5 +4,6 @@
 #include "../test.hpp"
 NNTestClassDecl(Batcher);
 NNTestClassDecl(SequenceBatcher);
+NNTestClassDecl(SparseBatcher);
 
 #endif
@@ -0,0 +1,7 @@
+#ifndef TEST_PARALLEL_HPP
+#define TEST_PARALLEL_HPP
+
+#include "../test.hpp"
+NNTestClassDecl(Parallel);
+
+#endif